@@ -0,0 +1,637 @@
+/**
+ * @file Benchmark.c
+ * @author Logan Bell
+ * @date June 2018
+ * @brief Benchmark of the load, sort, simulate and report phases over generated traces, written out as JSON.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stddef.h>
+#include "../include/Queue.h"
+#include "../include/IntrusiveList.h"
+#include "../include/TypedQueue.h"
+#include "../include/Arena.h"
+#include "../include/Output.h"
+#include "../include/Intersection.h"
+#include "../include/Counters.h"
+
+#define BENCHMARK_ORDERS 4
+
+static const char *orderNames[BENCHMARK_ORDERS] = {"sorted","reverse","random","bursty"};
+
+/**
+ *Times of one size and arrival order, in seconds, the best of the repeats. A phase that was skipped is negative.
+ **/
+typedef struct benchmarkResult{
+    size_t cars;
+    const char *order;
+    double insertSorted;
+    double insertSortedBulk;
+    double insertSortedByTime;
+    double skipListInsert;
+    double skipListDelete;
+    double intrusiveInsert;
+    double typedInsert;
+    double typedDelete;
+    double calculateTime;
+    double findNewFirst;
+    double intrusiveDrain;
+    double report;
+    size_t reportBytes;
+    SimTime endTime;
+} BenchmarkResult;
+
+/**Function to draw the next number of a splitmix64 sequence, good enough to lay out the cars.
+*@param state the sequence, advanced
+**/
+static uint64_t nextRandom(uint64_t *state)
+{
+  uint64_t z = (*state += 0x9E3779B97F4A7C15ULL);
+  z = (z ^ (z >> 30))*0xBF58476D1CE4E5B9ULL;
+  z = (z ^ (z >> 27))*0x94D049BB133111EBULL;
+  return z ^ (z >> 31);
+}
+
+/**Function to compare the arrival of two cars, the compare of the lists.
+*@param first a Data
+*@param second a Data
+**/
+static int compareArrival(void *first, void *second)
+{
+  SimTime a = ((Data *)first)->timeOfArrival;
+  SimTime b = ((Data *)second)->timeOfArrival;
+  return (a > b) - (a < b);
+}
+
+/**Function to tell whether two cars are the same, the compareNode of the lists.
+*@param first a Data
+*@param second a Data
+*@return 0 when they are the same, 1 otherwise
+**/
+static int compareCar(void *first, void *second)
+{
+  Data *a = first;
+  Data *b = second;
+  return !(a->timeOfArrival == b->timeOfArrival && a->travelDirection == b->travelDirection && a->turnDirection == b->turnDirection);
+}
+
+/**Function to make the cars of a trace in one of the arrival orders. sorted and reverse arrive every quarter of a
+*second, random is sorted shuffled, bursty comes in time order in bursts of 1 to 16 cars arriving at the same time.
+*@param cars where the cars are stored
+*@param count number of cars
+*@param order index into orderNames
+*@param seed seed of the layout, the same seed gives sorted, reverse and random the same cars
+**/
+static void makeCars(Data *cars, size_t count, int order, uint64_t seed)
+{
+  static const char directions[4] = {'N','E','S','W'};
+  static const char turns[8] = {'F','F','F','F','F','R','R','L'};
+  SimTime time = 0;
+  size_t burstLeft = 0;
+
+  for(size_t i = 0; i < count; i++)
+  {
+    uint64_t bits = nextRandom(&seed);
+    cars[i].travelDirection = directions[bits & 3];
+    cars[i].turnDirection = turns[(bits >> 2) & 7];
+    if(order == 3)
+    {
+      if(burstLeft == 0)
+      {
+        burstLeft = 1 + ((bits >> 5) & 15);
+        time = time + (SimTime)(1 + ((bits >> 9) & 31))*TIME_UNITS_PER_SECOND;
+      }
+      burstLeft--;
+      cars[i].timeOfArrival = time;
+    }
+    else
+    {
+      cars[i].timeOfArrival = (SimTime)i*TIME_UNITS_PER_SECOND/4;
+    }
+  }
+
+  if(order == 1)
+  {
+    for(size_t i = 0; i < count/2; i++)
+    {
+      Data swap = cars[i];
+      cars[i] = cars[count - 1 - i];
+      cars[count - 1 - i] = swap;
+    }
+  }
+  else if(order == 2)
+  {
+    for(size_t i = count; i > 1; i--)
+    {
+      size_t j = nextRandom(&seed) % i;
+      Data swap = cars[i - 1];
+      cars[i - 1] = cars[j];
+      cars[j] = swap;
+    }
+  }
+}
+
+/**Function to make an empty list whose nodes come from an arena.
+*@param arena the arena
+**/
+static List *arenaList(Arena *arena)
+{
+  return initializeListWithAllocator(NULL,NULL,compareCar,compareArrival,arenaAllocator(arena));
+}
+
+/**Function to time loading the cars one insertSorted at a time.
+*@param cars the cars in trace order
+*@param count number of cars
+**/
+static double timeInsertSorted(Data *cars, size_t count)
+{
+  Arena *arena = initializeArena(0);
+  List *list = arenaList(arena);
+  double start = monotonicSeconds();
+  for(size_t i = 0; i < count; i++)
+  {
+    insertSorted(list,&cars[i]);
+  }
+  double seconds = monotonicSeconds() - start;
+  deleteList(list);
+  deleteArena(arena);
+  return seconds;
+}
+
+/**Function to load the cars with insertSortedBulk the way a car file is read.
+*@param arena where the nodes go
+*@param cars the cars in trace order
+*@param count number of cars
+*@param seconds set to the time taken
+*@return the sorted list
+**/
+static List *loadBulk(Arena *arena, Data *cars, size_t count, double *seconds)
+{
+  void **pointers = malloc(sizeof(void *)*(count + 1));
+  List *list = arenaList(arena);
+  if(pointers == NULL)
+  {
+    return list;
+  }
+  for(size_t i = 0; i < count; i++)
+  {
+    pointers[i] = &cars[i];
+  }
+  double start = monotonicSeconds();
+  insertSortedBulk(list,pointers,count);
+  *seconds = monotonicSeconds() - start;
+  free(pointers);
+  return list;
+}
+
+/**Function to time loading the cars with the radix sort of insertSortedByTime, the way main reads a car file.
+*@param cars the cars in trace order
+*@param count number of cars
+**/
+static double timeInsertSortedByTime(Data *cars, size_t count)
+{
+  Data **pointers = malloc(sizeof(Data *)*(count + 1));
+  Arena *arena = initializeArena(0);
+  List *list = arenaList(arena);
+  double seconds = -1.0;
+  if(pointers != NULL)
+  {
+    for(size_t i = 0; i < count; i++)
+    {
+      pointers[i] = &cars[i];
+    }
+    double start = monotonicSeconds();
+    insertSortedByTime(list,pointers,count);
+    seconds = monotonicSeconds() - start;
+  }
+  free(pointers);
+  deleteList(list);
+  deleteArena(arena);
+  return seconds;
+}
+
+/**Function to time loading the cars one insertSorted at a time into a skip list, then removing them one
+*deleteDataFromList at a time in trace order.
+*@param cars the cars in trace order
+*@param count number of cars
+*@param insertSeconds set to the time taken by the inserts
+*@param deleteSeconds set to the time taken by the deletes
+**/
+static void timeSkipList(Data *cars, size_t count, double *insertSeconds, double *deleteSeconds)
+{
+  Arena *arena = initializeArena(0);
+  List *list = initializeSkipList(NULL,NULL,compareCar,compareArrival,arenaAllocator(arena));
+  double start = monotonicSeconds();
+  for(size_t i = 0; i < count; i++)
+  {
+    insertSorted(list,&cars[i]);
+  }
+  *insertSeconds = monotonicSeconds() - start;
+  start = monotonicSeconds();
+  for(size_t i = 0; i < count; i++)
+  {
+    deleteDataFromList(list,&cars[i]);
+  }
+  *deleteSeconds = monotonicSeconds() - start;
+  deleteList(list);
+  deleteArena(arena);
+}
+
+/**Function to time loading the cars one linkSorted at a time into an intrusive list, the same walk as insertSorted
+*without a node per car.
+*@param cars the cars in trace order
+*@param count number of cars
+**/
+static double timeIntrusiveInsert(Data *cars, size_t count)
+{
+  LinkedCar *linked = malloc(sizeof(LinkedCar)*(count + 1));
+  IntrusiveList list;
+  if(linked == NULL)
+  {
+    return -1.0;
+  }
+  for(size_t i = 0; i < count; i++)
+  {
+    linked[i].car = cars[i];
+  }
+  initializeIntrusiveList(&list,offsetof(LinkedCar,links),compareArrival);
+
+  double start = monotonicSeconds();
+  for(size_t i = 0; i < count; i++)
+  {
+    linkSorted(&list,&linked[i]);
+  }
+  double seconds = monotonicSeconds() - start;
+  free(linked);
+  return seconds;
+}
+
+/**Function to time loading the cars one insertSorted at a time into a CarTimeQueue, then removing them one
+*DeleteData at a time in trace order, the same work as timeSkipList with the compares inlined and the cars kept by value.
+*@param cars the cars in trace order
+*@param count number of cars
+*@param insertSeconds set to the time taken by the inserts
+*@param deleteSeconds set to the time taken by the deletes
+**/
+static void timeTypedQueue(Data *cars, size_t count, double *insertSeconds, double *deleteSeconds)
+{
+  CarTimeQueue queue;
+  carTimeQueueInitialize(&queue);
+  double start = monotonicSeconds();
+  for(size_t i = 0; i < count; i++)
+  {
+    carTimeQueueInsertSorted(&queue,cars[i]);
+  }
+  *insertSeconds = monotonicSeconds() - start;
+
+  start = monotonicSeconds();
+  for(size_t i = 0; i < count; i++)
+  {
+    carTimeQueueDeleteData(&queue,&cars[i]);
+  }
+  *deleteSeconds = monotonicSeconds() - start;
+  carTimeQueueDelete(&queue);
+}
+
+/**Function to time draining an intrusive list the way timeFindNewFirst drains a List, taking out the earliest car
+*and walking on from it to the next car of its direction.
+*@param sorted the sorted list the cars are copied from, in its order
+**/
+static double timeIntrusiveDrain(List *sorted)
+{
+  size_t count = 0;
+  for(Node *node = sorted->head; node != NULL; node = node->next)
+  {
+    count++;
+  }
+  LinkedCar *linked = malloc(sizeof(LinkedCar)*(count + 1));
+  IntrusiveList list;
+  if(linked == NULL)
+  {
+    return -1.0;
+  }
+  initializeIntrusiveList(&list,offsetof(LinkedCar,links),compareArrival);
+  count = 0;
+  for(Node *node = sorted->head; node != NULL; node = node->next)
+  {
+    linked[count].car = *(Data *)node->data;
+    linkBack(&list,&linked[count++]);
+  }
+
+  double start = monotonicSeconds();
+  LinkedCar *car;
+  while((car = firstRecord(&list)) != NULL)
+  {
+    LinkedCar *next = nextRecord(&list,car);
+    unlinkRecord(&list,car);
+    while(next != NULL && next->car.travelDirection != car->car.travelDirection)
+    {
+      next = nextRecord(&list,next);
+    }
+  }
+  double seconds = monotonicSeconds() - start;
+  free(linked);
+  return seconds;
+}
+
+/**Function to time draining a sorted list with findNewFirst the way the first engine did. The car going next is
+*always the earliest one left, the head of the list, and findNewFirst removes it by its node and finds the next car of
+*its direction.
+*@param list the sorted list, it is emptied
+**/
+static double timeFindNewFirst(List *list)
+{
+  double start = monotonicSeconds();
+  while(list->head != NULL)
+  {
+    Data *car = (Data *)list->head->data;
+    findNewFirst(list,list->head,car->travelDirection);
+  }
+  return monotonicSeconds() - start;
+}
+
+/**Function to run every phase for one trace, keeping the best time of each over the repeats.
+*@param result where the times go, cars and order already set
+*@param order index into orderNames
+*@param repeats number of times each phase is run
+*@param insertLimit largest trace loaded one insertSorted at a time, that load is O(N^2) on sorted arrivals
+**/
+static int runTrace(BenchmarkResult *result, int order, int repeats, size_t insertLimit)
+{
+  size_t count = result->cars;
+  Data *cars = malloc(sizeof(Data)*(count + 1));
+  if(cars == NULL)
+  {
+    return EXIT_FAILURE;
+  }
+  makeCars(cars,count,order,(uint64_t)count*31);
+
+  result->insertSorted = -1.0;
+  result->insertSortedBulk = -1.0;
+  result->insertSortedByTime = -1.0;
+  result->skipListInsert = -1.0;
+  result->skipListDelete = -1.0;
+  result->intrusiveInsert = -1.0;
+  result->typedInsert = -1.0;
+  result->typedDelete = -1.0;
+  result->calculateTime = -1.0;
+  result->findNewFirst = -1.0;
+  result->intrusiveDrain = -1.0;
+  result->report = -1.0;
+  result->reportBytes = 0;
+  for(int r = 0; r < repeats; r++)
+  {
+    double seconds = 0.0;
+    if(count <= insertLimit)
+    {
+      seconds = timeInsertSorted(cars,count);
+      if(result->insertSorted < 0.0 || seconds < result->insertSorted)
+      {
+        result->insertSorted = seconds;
+      }
+      seconds = timeIntrusiveInsert(cars,count);
+      if(result->intrusiveInsert < 0.0 || seconds < result->intrusiveInsert)
+      {
+        result->intrusiveInsert = seconds;
+      }
+      double deleteSeconds;
+      timeTypedQueue(cars,count,&seconds,&deleteSeconds);
+      if(result->typedInsert < 0.0 || seconds < result->typedInsert)
+      {
+        result->typedInsert = seconds;
+      }
+      if(result->typedDelete < 0.0 || deleteSeconds < result->typedDelete)
+      {
+        result->typedDelete = deleteSeconds;
+      }
+    }
+
+    Arena *arena = initializeArena(0);
+    List *list = loadBulk(arena,cars,count,&seconds);
+    if(result->insertSortedBulk < 0.0 || seconds < result->insertSortedBulk)
+    {
+      result->insertSortedBulk = seconds;
+    }
+    seconds = timeInsertSortedByTime(cars,count);
+    if(result->insertSortedByTime < 0.0 || seconds < result->insertSortedByTime)
+    {
+      result->insertSortedByTime = seconds;
+    }
+    double deleteSeconds;
+    timeSkipList(cars,count,&seconds,&deleteSeconds);
+    if(result->skipListInsert < 0.0 || seconds < result->skipListInsert)
+    {
+      result->skipListInsert = seconds;
+    }
+    if(result->skipListDelete < 0.0 || deleteSeconds < result->skipListDelete)
+    {
+      result->skipListDelete = deleteSeconds;
+    }
+
+    //calculateTime without anything to write it to, so only the engine is timed
+    IntersectionStats stats;
+    double start = monotonicSeconds();
+    result->endTime = simulateList(list,NULL,NULL,OUTPUT_SUMMARY,&stats);
+    seconds = monotonicSeconds() - start;
+    if(result->calculateTime < 0.0 || seconds < result->calculateTime)
+    {
+      result->calculateTime = seconds;
+    }
+
+    //the same run with every line calculateTime prints formatted into memory
+    OutputBuffer *output = initializeOutput(NULL,0);
+    start = monotonicSeconds();
+    simulateList(list,NULL,output,OUTPUT_CARS,NULL);
+    seconds = monotonicSeconds() - start;
+    if(result->report < 0.0 || seconds < result->report)
+    {
+      result->report = seconds;
+    }
+    result->reportBytes = output->used;
+    deleteOutput(output);
+
+    seconds = timeIntrusiveDrain(list);
+    if(result->intrusiveDrain < 0.0 || seconds < result->intrusiveDrain)
+    {
+      result->intrusiveDrain = seconds;
+    }
+    seconds = timeFindNewFirst(list);
+    if(result->findNewFirst < 0.0 || seconds < result->findNewFirst)
+    {
+      result->findNewFirst = seconds;
+    }
+    deleteList(list);
+    deleteArena(arena);
+  }
+  free(cars);
+  return EXIT_SUCCESS;
+}
+
+/**Function to write a time as a JSON member, null when the phase was skipped.
+*@param output where the member goes
+*@param name name of the member
+*@param seconds the time, negative when skipped
+**/
+static void writeSeconds(OutputBuffer *output, const char *name, double seconds)
+{
+  writeText(output,",\"");
+  writeText(output,name);
+  writeText(output,"\":");
+  if(seconds < 0.0)
+  {
+    writeText(output,"null");
+  }
+  else
+  {
+    writeFixed(output,seconds,0,6);
+  }
+}
+
+/**Function to write the results as one JSON document.
+*@param output where the document goes
+*@param results the results
+*@param count number of results
+*@param repeats number of times each phase was run
+**/
+static void writeResults(OutputBuffer *output, BenchmarkResult *results, size_t count, int repeats)
+{
+  writeText(output,"{\"benchmark\":\"Assignment1\",\"repeats\":");
+  writeUnsigned(output,(unsigned long long)repeats);
+  writeText(output,",\"results\":[");
+  for(size_t i = 0; i < count; i++)
+  {
+    BenchmarkResult *result = &results[i];
+    double format = result->report - result->calculateTime;
+    writeText(output,(i == 0) ? "\n" : ",\n");
+    writeText(output,"{\"cars\":");
+    writeUnsigned(output,(unsigned long long)result->cars);
+    writeText(output,",\"order\":\"");
+    writeText(output,result->order);
+    writeChar(output,'"');
+    writeSeconds(output,"insertSorted",result->insertSorted);
+    writeSeconds(output,"insertSortedBulk",result->insertSortedBulk);
+    writeSeconds(output,"insertSortedByTime",result->insertSortedByTime);
+    writeSeconds(output,"skipListInsert",result->skipListInsert);
+    writeSeconds(output,"skipListDelete",result->skipListDelete);
+    writeSeconds(output,"intrusiveInsert",result->intrusiveInsert);
+    writeSeconds(output,"typedInsert",result->typedInsert);
+    writeSeconds(output,"typedDelete",result->typedDelete);
+    writeSeconds(output,"calculateTime",result->calculateTime);
+    writeSeconds(output,"findNewFirst",result->findNewFirst);
+    writeSeconds(output,"intrusiveDrain",result->intrusiveDrain);
+    writeSeconds(output,"report",result->report);
+    writeSeconds(output,"format",(format < 0.0) ? 0.0 : format);
+    writeText(output,",\"reportBytes\":");
+    writeUnsigned(output,(unsigned long long)result->reportBytes);
+    writeText(output,",\"endTime\":");
+    writeTime(output,result->endTime,0,2);
+    writeChar(output,'}');
+  }
+  writeText(output,"\n]}\n");
+}
+
+int main(int argc, char *argv[])
+{
+  size_t smallest = 1000;         //cars of the first trace
+  size_t largest = 1000000;       //cars of the last trace, every trace is 10 times the one before
+  size_t insertLimit = 30000;     //largest trace loaded one insertSorted at a time
+  int repeats = 3;                //runs of each phase, the best is kept
+  int orders[BENCHMARK_ORDERS] = {1,1,1,1};
+  const char *outName = NULL;     //file the JSON goes to, NULL for stdout
+
+  for(int i = 1; i < argc; i++)
+  {
+    if(strcmp(argv[i],"--min") == 0 && i + 1 < argc)
+    {
+      smallest = strtoul(argv[++i],NULL,10);
+    }
+    else if(strcmp(argv[i],"--max") == 0 && i + 1 < argc)
+    {
+      largest = strtoul(argv[++i],NULL,10);
+    }
+    else if(strcmp(argv[i],"--insert-limit") == 0 && i + 1 < argc)
+    {
+      insertLimit = strtoul(argv[++i],NULL,10);
+    }
+    else if(strcmp(argv[i],"--repeats") == 0 && i + 1 < argc)
+    {
+      repeats = atoi(argv[++i]);
+    }
+    else if(strcmp(argv[i],"--orders") == 0 && i + 1 < argc)
+    {
+      const char *list = argv[++i];
+      for(int o = 0; o < BENCHMARK_ORDERS; o++)
+      {
+        orders[o] = (strstr(list,orderNames[o]) != NULL);
+      }
+    }
+    else if(strcmp(argv[i],"--out") == 0 && i + 1 < argc)
+    {
+      outName = argv[++i];
+    }
+    else
+    {
+      fprintf(stderr,"usage: %s [--min <cars>] [--max <cars>] [--orders sorted,reverse,random,bursty] [--repeats <count>] [--insert-limit <cars>] [--out <json file>]\n",argv[0]);
+      return 1;
+    }
+  }
+  if(smallest == 0 || largest < smallest || repeats < 1)
+  {
+    fprintf(stderr,"--min must be at least 1 and no more than --max, --repeats at least 1\n");
+    return 1;
+  }
+
+  size_t capacity = 0;
+  for(size_t cars = smallest; cars <= largest; cars = cars*10)
+  {
+    capacity = capacity + BENCHMARK_ORDERS;
+  }
+  BenchmarkResult *results = malloc(sizeof(BenchmarkResult)*capacity);
+  size_t count = 0;
+  if(results == NULL)
+  {
+    return 1;
+  }
+
+  for(size_t cars = smallest; cars <= largest; cars = cars*10)
+  {
+    for(int o = 0; o < BENCHMARK_ORDERS; o++)
+    {
+      if(!orders[o])
+      {
+        continue;
+      }
+      results[count].cars = cars;
+      results[count].order = orderNames[o];
+      if(runTrace(&results[count],o,repeats,insertLimit) != EXIT_SUCCESS)
+      {
+        fprintf(stderr,"not enough memory for %zu cars\n",cars);
+        continue;
+      }
+      fprintf(stderr,"%10zu %-8s bulk %.6f s, radix %.6f s, skip list %.6f s, calculateTime %.6f s, findNewFirst %.6f s, intrusive %.6f s, report %.6f s\n",cars,orderNames[o],
+              results[count].insertSortedBulk,results[count].insertSortedByTime,results[count].skipListInsert,results[count].calculateTime,
+              results[count].findNewFirst,results[count].intrusiveDrain,results[count].report);
+      count++;
+    }
+  }
+
+  FILE *fp = (outName == NULL) ? stdout : fopen(outName,"w");
+  if(fp == NULL)
+  {
+    fprintf(stderr,"could not write %s\n",outName);
+    free(results);
+    return 1;
+  }
+  OutputBuffer *output = initializeOutput(fp,0);
+  writeResults(output,results,count,repeats);
+  deleteOutput(output);
+  if(fp != stdout)
+  {
+    fclose(fp);
+  }
+  free(results);
+  return 0;
+}
@@ -0,0 +1,76 @@
+/**
+ * @file Arena.h
+ * @author Logan Bell
+ * @date June 2018
+ * @brief File containing the function definitions of an arena allocator for lists and their data.
+ */
+
+#ifndef _ARENA_API_
+#define _ARENA_API_
+
+#include <stddef.h>
+#include "Queue.h"
+
+#define ARENA_DEFAULT_BLOCK_SIZE (1024*1024)  //bytes in each block when no size is given
+#define ARENA_ALIGNMENT 16                    //every allocation starts on a multiple of this
+#define ARENA_SIZE_CLASSES 16                 //released blocks up to ARENA_ALIGNMENT*ARENA_SIZE_CLASSES bytes are reused
+
+/**
+ *One large piece of memory that allocations are carved out of, blocks are chained together so they can all be freed.
+ **/
+typedef struct arenaBlock{
+    struct arenaBlock *next;
+    size_t size;
+    size_t used;
+} ArenaBlock;
+
+/**
+ *Arena that hands out memory from large blocks. Small released allocations are kept on a free list per size so
+ *nodes can be reused, and everything is given back at once when the arena is deleted.
+ **/
+typedef struct arena{
+    ArenaBlock *blocks;
+    size_t blockSize;
+    void *freeLists[ARENA_SIZE_CLASSES];
+    size_t allocations;
+    size_t bytesUsed;
+    size_t bytesReserved;
+    Allocator allocator;
+} Arena;
+
+/**Function to create an empty arena.
+*@return pointer to the arena, NULL if memory could not be allocated
+*@param blockSize bytes in each block the arena reserves, 0 for ARENA_DEFAULT_BLOCK_SIZE
+**/
+Arena *initializeArena(size_t blockSize);
+
+/**Function to get memory from the arena. This has a big O notation of 1.
+*@pre arena must exist
+*@return pointer to size bytes aligned to ARENA_ALIGNMENT, NULL if memory could not be allocated
+*@param arena the arena to allocate from
+*@param size number of bytes needed
+**/
+void *arenaAllocate(Arena *arena, size_t size);
+
+/**Function to give memory back to the arena so a later allocation of the same size can reuse it.
+*@pre toBeReleased must have come from arenaAllocate on this arena with the same size
+*@param arena the arena the memory came from
+*@param toBeReleased memory that is no longer used
+*@param size number of bytes that were asked for
+**/
+void arenaRelease(Arena *arena, void *toBeReleased, size_t size);
+
+/**Function to get the list allocator hooks for the arena, lists using them free their nodes in O(1).
+*@pre arena must exist
+*@return allocator to pass to initializeListWithAllocator, it lives as long as the arena
+*@param arena the arena the nodes will come from
+**/
+Allocator *arenaAllocator(Arena *arena);
+
+/**Function to free every block of the arena along with the arena itself. This has a big O notation of blocks, not allocations.
+*@post every pointer handed out by the arena is invalid
+*@param arena the arena to be deleted
+**/
+void deleteArena(Arena *arena);
+
+#endif
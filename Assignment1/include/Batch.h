@@ -0,0 +1,69 @@
+/**
+ * @file Batch.h
+ * @author Logan Bell
+ * @date June 2018
+ * @brief File containing the function definitions of the batch mode that simulates many files on all cores.
+ */
+
+#ifndef _BATCH_API_
+#define _BATCH_API_
+
+#include <stddef.h>
+#include <pthread.h>
+#include "Intersection.h"
+#include "Output.h"
+
+/**
+ *One file of a batch. Its results are written into a writer of its own and kept until they are printed in order.
+ **/
+typedef struct batchJob{
+    struct batch *batch;
+    char *fileName;
+    int isTrace;
+    int failed;
+    int done;
+    OutputBuffer *output;
+    IntersectionStats stats;
+} BatchJob;
+
+/**
+ *Files simulated independently of each other on a thread pool, in the order they were listed. When the junction
+ *keeps percentiles, each file's histograms are added to histograms as the file finishes.
+ **/
+typedef struct batch{
+    BatchJob *jobs;
+    size_t count;
+    IntersectionConfig *config;
+    int mode;
+    WaitHistograms *histograms;   //the waits of every file, NULL when the junction does not keep percentiles
+    pthread_mutex_t lock;
+    pthread_cond_t jobDone;
+} Batch;
+
+/**Function to list the files of a batch. A directory gives every file in it in order of name, anything else is read
+*as a manifest with one path per line, blank lines and lines starting with # are skipped. Binary traces are told
+*apart from car data files by their first bytes.
+*@return the batch, NULL if the path could not be read or memory could not be allocated
+*@param path directory or manifest
+*@param config the junction every file is simulated with, it must live as long as the batch
+*@param mode one of OUTPUT_CARS, OUTPUT_SUMMARY, OUTPUT_MACHINE, used for every file
+**/
+Batch *readBatch(const char *path, IntersectionConfig *config, int mode);
+
+/**Function to simulate every file of a batch on a work stealing thread pool. The results of each file are the same
+*as a run over that file alone and are printed in the order of the batch, followed by the totals of all files. The
+*threads, tasks stolen and time taken are printed to stderr.
+*@pre batch must exist
+*@return the number of files that could not be simulated
+*@param batch the batch
+*@param threadCount number of threads, 0 for one per processor
+*@param output where the results are written, it is flushed before returning
+**/
+size_t runBatch(Batch *batch, int threadCount, OutputBuffer *output);
+
+/**Function to free a batch and the results of its files.
+*@param batch the batch to be deleted
+**/
+void deleteBatch(Batch *batch);
+
+#endif
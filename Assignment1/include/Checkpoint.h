@@ -0,0 +1,129 @@
+/**
+ * @file Checkpoint.h
+ * @author Logan Bell
+ * @date June 2018
+ * @brief File containing the function definitions of the binary checkpoints a run can be resumed from.
+ */
+
+#ifndef _CHECKPOINT_API_
+#define _CHECKPOINT_API_
+
+#include <stdio.h>
+#include <stdint.h>
+#include "Queue.h"
+#include "Intersection.h"
+#include "Rollup.h"
+
+#define CHECKPOINT_MAGIC "CARCHKPT"       //first eight bytes of every checkpoint file
+#define CHECKPOINT_VERSION 2
+#define CHECKPOINT_BYTE_ORDER 0x01020304u //reads back differently when the file was written on a machine of the other endianness
+#define CHECKPOINT_DEFAULT_EVERY 1000000  //cars between checkpoints when --checkpoint-every is not given
+
+/**
+ *Everything simulateIntersection needs to carry on from where a run was. The cars not taken from the source yet are
+ *not kept, taken is how many cars of each approach the source had handed out, so a resumed run takes that many
+ *again from the same input and checks the last of them against heads. An approach in pending had no car before
+ *pendingUntil when the source was last asked, it is asked again before a car at or after that time goes. The fields
+ *of the shared box are only used when config->shareBox is set. outputBytes is how much output the run had handed to
+ *its file at the checkpoint.
+ **/
+typedef struct engineState{
+    Data heads[INTERSECTION_MAX_APPROACHES];      //first car of each approach that has not gone yet
+    uint64_t taken[INTERSECTION_MAX_APPROACHES];  //cars handed out by the source for each approach, heads included
+    uint64_t served;                              //cars that have gone into the intersection
+    uint64_t outputBytes;
+    int waiting;                                  //bit set of the approaches with a car in heads
+    int pending;                                  //bit set of the approaches whose source may still have a car
+    SimTime pendingUntil;                         //no pending approach has a car before it, INT64_MAX when none is pending
+    int inside;                                   //bit set of the approaches with a car in the shared box
+    uint32_t occupied;                            //bit set of the movements in the shared box
+    int movement[INTERSECTION_MAX_APPROACHES];    //movement of the car of each approach in the shared box
+    SimTime leaveTime[INTERSECTION_MAX_APPROACHES]; //when the car of each approach in the shared box leaves
+    SimTime now;                                  //time the shared box has got to
+    int failed;                                   //set by a resumed run whose input does not match the checkpoint
+    IntersectionStats totals;                     //counts and waits so far, with every wait added in
+    WindowRollup *rollup;                         //windows of the run when config->window is set, never saved
+} EngineState;
+
+/**
+ *Header at the start of a checkpoint file, describing the run it was taken from so it is only resumed with the same
+ *junction and output. The EngineState follows with its histograms and rollup pointers cleared, then when the run keeps
+ *percentiles one CheckpointBucket for each bucket of the histograms that is not empty.
+ **/
+typedef struct checkpointHeader{
+    char magic[8];
+    uint32_t version;
+    uint32_t byteOrder;
+    uint32_t timeUnits;
+    uint32_t stateSize;           //sizeof(EngineState) of the program that wrote it
+    int32_t mode;
+    int32_t approaches;
+    int32_t yieldToRight;
+    int32_t shareBox;
+    int32_t percentiles;
+    int32_t rank[INTERSECTION_MAX_APPROACHES];
+    char directions[INTERSECTION_MAX_APPROACHES + 1];
+    char reserved[3];
+    uint64_t buckets;             //CheckpointBuckets after the state
+} CheckpointHeader;
+
+/**
+ *A bucket of a histogram of waits that is not empty. histogram is the approach, or INTERSECTION_MAX_APPROACHES plus
+ *the turn for the histograms by turn.
+ **/
+typedef struct checkpointBucket{
+    uint32_t histogram;
+    uint32_t bucket;
+    uint64_t count;
+    SimTime longest;
+} CheckpointBucket;
+
+/**
+ *More state saved after the buckets of a checkpoint, for a source of cars that carries on from where it was instead
+ *of handing out its cars again. write and read get context and return EXIT_SUCCESS or EXIT_FAILURE, read prints
+ *why it failed on stderr.
+ **/
+typedef struct checkpointSection{
+    int (*write)(FILE *fp, void *context);
+    int (*read)(FILE *fp, void *context);
+    void *context;
+} CheckpointSection;
+
+/**Function to allocate the state of a run that has not started, with empty totals and no cars taken.
+*@return the state, NULL if memory could not be allocated
+*@param config the junction of the run, histograms are allocated when it has percentiles set
+**/
+EngineState *initializeEngineState(IntersectionConfig *config);
+
+/**Function to clear the state of a run that has not started, with empty totals and no cars taken.
+*@param state the state
+*@param config the junction of the run, histograms are allocated when it has percentiles set
+**/
+void clearEngineState(EngineState *state, IntersectionConfig *config);
+
+/**Function to save the state of a run. The file is written under another name first and then renamed, so a run
+*killed while saving leaves the previous checkpoint as it was.
+*@return EXIT_SUCCESS on success, EXIT_FAILURE if the file could not be written
+*@param fileName path of the checkpoint
+*@param config the junction of the run
+*@param mode the output of the run, one of OUTPUT_CARS, OUTPUT_SUMMARY, OUTPUT_MACHINE
+*@param state the state, with every wait added to its totals
+*@param section more state written after the state of the run, may be NULL
+**/
+int writeCheckpoint(const char *fileName, IntersectionConfig *config, int mode, EngineState *state, CheckpointSection *section);
+
+/**Function to load the state of a run, checking it was taken from a run with the same junction and output.
+*@return the state, NULL if the file could not be read or is from another run, the reason is printed on stderr
+*@param fileName path of the checkpoint
+*@param config the junction the run is resumed with
+*@param mode the output the run is resumed with
+*@param section reads the state written after the state of the run, may be NULL
+**/
+EngineState *readCheckpoint(const char *fileName, IntersectionConfig *config, int mode, CheckpointSection *section);
+
+/**Function to free a state loaded by readCheckpoint, with its histograms.
+*@param state the state to be deleted, may be NULL
+**/
+void deleteEngineState(EngineState *state);
+
+#endif
@@ -0,0 +1,92 @@
+/**
+ * @file Counters.h
+ * @author Logan Bell
+ * @date June 2018
+ * @brief File containing the function definitions of the hot path counters and phase timers shown by --stats.
+ */
+
+#ifndef _COUNTERS_API_
+#define _COUNTERS_API_
+
+#include <stdio.h>
+
+#define PHASE_READ 0      //parsing car files
+#define PHASE_SORT 1      //sorting the cars into a list
+#define PHASE_SIMULATE 2  //running the intersection and formatting its lines
+#define PHASE_OUTPUT 3    //handing the formatted text to the file
+#define PHASE_COUNT 4
+
+/**
+ *What the hot paths of a run did. Each thread counts into its own copy, which is added to the totals when the
+ *thread finishes, so counting never takes a lock.
+ **/
+typedef struct hotCounters{
+    unsigned long long compares;        //calls of a list's compare function
+    unsigned long long nodeCompares;    //calls of a list's compareNode function
+    unsigned long long scans;           //walks along a list looking for a place or a car
+    unsigned long long nodesVisited;    //nodes stepped over by those walks
+    unsigned long long allocations;     //nodes and cars allocated
+    unsigned long long bytes;           //bytes of those allocations
+    unsigned long long outputWrites;    //blocks of text handed to a file
+    unsigned long long outputBytes;     //bytes of those blocks
+    unsigned long long peakCarsHeld;    //most cars a stream held at once, read but not gone through the intersection
+    double phaseSeconds[PHASE_COUNT];
+} HotCounters;
+
+/**
+ *Start of a phase being timed. nested is the output time at the start, output done inside a phase is only counted
+ *as output.
+ **/
+typedef struct phaseTimer{
+    double start;
+    double nested;
+} PhaseTimer;
+
+extern int countersEnabled;
+extern _Thread_local HotCounters threadCounters;
+
+//building with -DNO_COUNTERS takes the counting out completely, otherwise a run without --stats pays one branch
+#ifdef NO_COUNTERS
+#define COUNT(field,amount) ((void)(amount))
+#define COUNT_SCAN(visited) ((void)(visited))
+#define COUNT_PEAK(field,amount) ((void)(amount))
+#define START_PHASE(timer) ((void)(timer))
+#define END_PHASE(phase,timer) ((void)(timer))
+#else
+#define COUNT(field,amount) do{ if(countersEnabled) threadCounters.field += (amount); }while(0)
+#define COUNT_SCAN(visited) do{ if(countersEnabled){ threadCounters.scans++; threadCounters.nodesVisited += (visited); } }while(0)
+#define COUNT_PEAK(field,amount) do{ if(countersEnabled && (amount) > threadCounters.field) threadCounters.field = (amount); }while(0)
+#define START_PHASE(timer) do{ if(countersEnabled) startPhase(&(timer)); }while(0)
+#define END_PHASE(phase,timer) do{ if(countersEnabled) endPhase((phase),&(timer)); }while(0)
+#endif
+
+/**Function to read the monotonic clock.
+*@return seconds from some fixed point in the past
+**/
+double monotonicSeconds(void);
+
+/**Function to turn the counters on, before any thread that counts is started.
+**/
+void enableCounters(void);
+
+/**Function to start timing a phase, use START_PHASE.
+*@param timer where the start is kept
+**/
+void startPhase(PhaseTimer *timer);
+
+/**Function to add the time since startPhase to a phase of this thread, use END_PHASE.
+*@param phase one of PHASE_READ, PHASE_SORT, PHASE_SIMULATE, PHASE_OUTPUT
+*@param timer the timer given to startPhase
+**/
+void endPhase(int phase, PhaseTimer *timer);
+
+/**Function to add the counters of the calling thread to the totals and clear them, called by a thread as it finishes.
+**/
+void mergeThreadCounters(void);
+
+/**Function to print the totals of every thread that has finished and of the calling thread.
+*@param fp where the summary goes
+**/
+void printCounters(FILE *fp);
+
+#endif
@@ -0,0 +1,90 @@
+/**
+ * @file Generator.h
+ * @author Logan Bell
+ * @date June 2018
+ * @brief File containing the function definitions of the generator of synthetic car arrivals.
+ */
+
+#ifndef _GENERATOR_API_
+#define _GENERATOR_API_
+
+#include <stddef.h>
+#include <stdint.h>
+#include "Queue.h"
+#include "Intersection.h"
+
+#define GENERATOR_HOURS 24  //entries of a time of day profile
+
+/**
+ *What the cars of a synthetic run look like. Each approach gets cars as a Poisson process of ratePerHour cars an
+ *hour, scaled by the profile entry of the hour of the day the run is in (the run starts at midnight and wraps after
+ *a day). The turns are drawn with the weights forward, right, left.
+ **/
+typedef struct generatorConfig{
+    double ratePerHour[INTERSECTION_MAX_APPROACHES];
+    double profile[GENERATOR_HOURS];
+    double turnWeights[3];
+    double duration;
+    uint64_t seed;
+} GeneratorConfig;
+
+/**
+ *State of one replicate. Every approach has a random stream of its own, so the cars of an approach only depend on
+ *the seed, the replicate and the approach, whatever order the intersection asks for them in.
+ **/
+typedef struct carGenerator{
+    const GeneratorConfig *settings;
+    IntersectionConfig *config;
+    uint64_t random[INTERSECTION_MAX_APPROACHES][4];
+    double clock[INTERSECTION_MAX_APPROACHES];
+    double peakProfile;
+    size_t carsMade;
+} CarGenerator;
+
+/**Function to fill in the default generator, 600 cars an hour on every approach all day, 60% going forward,
+*25% turning right and 15% turning left, for one hour with seed 1.
+*@param settings the generator to fill in
+**/
+void defaultGeneratorConfig(GeneratorConfig *settings);
+
+/**Function to read a list of numbers separated by commas, like "600,450,600,300".
+*@param text the list
+*@param values where the numbers are stored
+*@param count number of numbers wanted
+*@return EXIT_SUCCESS when text holds exactly count numbers that are not negative, EXIT_FAILURE otherwise
+**/
+int parseNumberList(const char *text, double *values, int count);
+
+/**Function to start one replicate of the generator.
+*@pre settings must have a profile and turn weights that are not all 0
+*@param generator the generator to start
+*@param settings what the cars look like, it must live as long as the generator
+*@param config the junction the cars arrive at, the rates are given in the order of its approaches
+*@param replicate number of the replicate, replicates of the same seed give different cars
+**/
+void initializeGenerator(CarGenerator *generator, const GeneratorConfig *settings, IntersectionConfig *config, uint64_t replicate);
+
+/**Function to make the next car of a direction, the nextCar of a CarSource over a CarGenerator.
+*@param state the CarGenerator
+*@param direction the approach letter
+*@param car where the car is stored
+*@return 1 when a car was made, 0 once the duration of the run is over
+**/
+int nextGeneratedCar(void *state, char direction, Data *car);
+
+/**Function to give a source handing out the cars of a generator, nothing is held in memory.
+*@param generator the generator
+*@return the source
+**/
+CarSource generatorSource(CarGenerator *generator);
+
+/**Function to write the cars of one replicate as a car data file sorted by time of arrival.
+*@param fileName path of the car data file to write
+*@param settings what the cars look like
+*@param config the junction
+*@param replicate number of the replicate
+*@return EXIT_SUCCESS on success, EXIT_FAILURE if the file could not be written or memory could not be allocated
+**/
+int writeGeneratedCars(const char *fileName, const GeneratorConfig *settings, IntersectionConfig *config, uint64_t replicate);
+
+#endif
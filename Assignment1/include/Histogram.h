@@ -0,0 +1,58 @@
+/**
+ * @file Histogram.h
+ * @author Logan Bell
+ * @date June 2018
+ * @brief File containing the function definitions of a log-linear histogram of waits for percentiles in fixed memory.
+ */
+
+#ifndef _HISTOGRAM_API_
+#define _HISTOGRAM_API_
+
+#include <stdint.h>
+#include "SimTime.h"
+
+#define HISTOGRAM_SUB_BITS 7                                  //each power of two is split into 2^(bits-1) buckets
+#define HISTOGRAM_HALF_BUCKETS (1 << (HISTOGRAM_SUB_BITS - 1))
+#define HISTOGRAM_BUCKETS ((65 - HISTOGRAM_SUB_BITS)*HISTOGRAM_HALF_BUCKETS)  //enough for any wait that fits a SimTime
+
+/**
+ *Counts of waits in buckets that are one tick wide below 2^HISTOGRAM_SUB_BITS ticks and then double in width with
+ *every power of two, so a wait is put in its bucket in O(1). Each bucket also keeps the longest wait put in it, which
+ *is what a percentile is read back as, so a percentile is a wait that really happened and is never more than
+ *1/2^(HISTOGRAM_SUB_BITS-1) above the true one. The size is the same however many waits are counted, and two
+ *histograms are merged by adding their buckets.
+ **/
+typedef struct waitHistogram{
+    uint64_t count;                      //waits counted
+    SimTime highest;                     //longest wait counted, exact
+    uint64_t buckets[HISTOGRAM_BUCKETS];
+    SimTime longest[HISTOGRAM_BUCKETS];  //longest wait in each bucket
+} WaitHistogram;
+
+/**Function to empty a histogram.
+*@param histogram the histogram
+**/
+void clearHistogram(WaitHistogram *histogram);
+
+/**Function to count one wait. This has a big O notation of 1.
+*@param histogram the histogram
+*@param wait the wait in ticks, a negative wait is counted as 0
+**/
+void recordHistogram(WaitHistogram *histogram, SimTime wait);
+
+/**Function to add the waits of one histogram to another, as if every wait had been counted in both.
+*@param to the histogram added to
+*@param from the histogram added
+**/
+void mergeHistogram(WaitHistogram *to, const WaitHistogram *from);
+
+/**Function to give the wait that a share of the counted waits are no longer than, the longest wait in the bucket
+*the share ends in.
+*@pre the histogram must not be empty
+*@param histogram the histogram
+*@param permille the share in tenths of a percent, 500 for the median and 999 for p99.9
+*@return the wait in ticks
+**/
+SimTime histogramPercentile(const WaitHistogram *histogram, int permille);
+
+#endif
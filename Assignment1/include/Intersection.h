@@ -0,0 +1,170 @@
+/**
+ * @file Intersection.h
+ * @author Logan Bell
+ * @date June 2018
+ * @brief File containing the function definitions of the intersection engine that decides which car goes next.
+ */
+
+#ifndef _INTERSECTION_API_
+#define _INTERSECTION_API_
+
+#include <stdint.h>
+#include "Queue.h"
+#include "Output.h"
+#include "Histogram.h"
+
+struct engineState;  //state of a run that can be saved and resumed, defined in Checkpoint.h
+
+#define INTERSECTION_MAX_APPROACHES 8       //most approaches a junction can have, so a set of them fits in a byte
+#define INTERSECTION_DEFAULT_APPROACHES "NESW"
+#define INTERSECTION_TURNS 3                 //F, R and L
+#define INTERSECTION_MOVEMENTS (INTERSECTION_MAX_APPROACHES*INTERSECTION_TURNS)  //an approach and a turn, movement approach*3 + F, R, L
+
+/**
+ *Layout and right-of-way of a junction. The approaches are listed going clockwise, so the approach on the right of
+ *a car is the one before its own. When cars arrive at the same time and yieldToRight is set, a car gives way to a
+ *tied car on its right, the two cars of an opposite pair are decided by their turns, and anything left goes by rank.
+ *Without yieldToRight ties go by rank only, like a roundabout with a fixed order of entries.
+ *tieWinner and tieOpposite are filled in by configureIntersection for every set of tied approaches.
+ *conflicts is filled in by configureIntersection too, from where each movement enters and leaves the junction.
+ *It is only used when shareBox is set, which configureIntersection leaves at 0.
+ *percentiles is left at 0 as well, setting it makes every run keep histograms of its waits.
+ *checkpointFile and resume are left NULL. A run with a checkpointFile saves its state there every checkpointEvery
+ *cars, and a run with resume carries on from a state loaded by readCheckpoint instead of starting from the first car,
+ *taking over its histograms. Both are meant for a single run, not for runs going on at the same time.
+ *incremental is left NULL too. A run with one carries on from that state without taking its cars again, its source
+ *carries on from where it was as well, and leaves the state there at the end with the histograms.
+ *window is left at 0. A run with a window prints, as each window of that length closes, the cars of each approach
+ *arriving and leaving in it, see WindowRollup. The windows are not saved in checkpoints.
+ **/
+typedef struct intersectionConfig{
+    int approaches;                                      //number of approaches, 1 to INTERSECTION_MAX_APPROACHES
+    char directions[INTERSECTION_MAX_APPROACHES + 1];    //letter of each approach going clockwise, ends with '\0'
+    int rank[INTERSECTION_MAX_APPROACHES];               //right-of-way rank of each approach, lower goes first
+    int yieldToRight;                                    //1 to apply the rule of the right before the ranks
+    signed char approachOf[256];                         //approach of each direction letter, -1 when it is not one
+    signed char tieWinner[1 << INTERSECTION_MAX_APPROACHES];   //approach going first for each set of tied approaches
+    signed char tieOpposite[1 << INTERSECTION_MAX_APPROACHES]; //when not -1, the opposite approach the turns decide against
+    uint32_t conflicts[INTERSECTION_MOVEMENTS];          //bit set of the movements each movement crosses or merges with
+    int shareBox;                                        //1 to let cars whose movements do not conflict go together
+    int percentiles;                                     //1 to keep histograms of the waits and print their percentiles
+    const char *checkpointFile;                          //where the state of the run is saved, NULL for no checkpoints
+    uint64_t checkpointEvery;                            //cars between checkpoints
+    struct engineState *resume;                          //state the run carries on from, NULL to start from the first car
+    struct engineState *incremental;                     //state carried from one run to the next over a growing input
+    SimTime window;                                      //ticks of the windows printed as they close, 0 for none
+} IntersectionConfig;
+
+/**
+ *Histograms of the waits of a run, or of several runs merged, by the approach and by the turn of the cars.
+ **/
+typedef struct waitHistograms{
+    WaitHistogram approach[INTERSECTION_MAX_APPROACHES];
+    WaitHistogram turn[INTERSECTION_TURNS];     //F, R, L
+} WaitHistograms;
+
+/**
+ *Counts and waits of a run, per approach of the junction. The waits are in ticks, so the sums are exact. The
+ *shortest wait of an approach without cars is 0. histograms is allocated by the run when the junction has
+ *percentiles set and is NULL otherwise, whoever keeps the totals frees it with deleteWaitHistograms.
+ **/
+typedef struct intersectionStats{
+    int approaches;
+    int amount[INTERSECTION_MAX_APPROACHES];
+    SimTime totalWait[INTERSECTION_MAX_APPROACHES];
+    SimTime minWait[INTERSECTION_MAX_APPROACHES];
+    SimTime maxWait[INTERSECTION_MAX_APPROACHES];
+    SimTime maxWaitTime;
+    SimTime timeCounter;
+    WaitHistograms *histograms;
+} IntersectionStats;
+
+/**Function to set up a junction, filling in the tables used to settle ties.
+*@return EXIT_SUCCESS on success, EXIT_FAILURE if the directions or priority are not valid
+*@param config the junction to set up
+*@param directions letters of the approaches going clockwise, NULL for INTERSECTION_DEFAULT_APPROACHES
+*@param priority the same letters from the highest right-of-way to the lowest, NULL to rank them in clockwise order
+*@param yieldToRight 1 to apply the rule of the right before the ranks, 0 to settle ties by rank only
+**/
+int configureIntersection(IntersectionConfig *config, const char *directions, const char *priority, int yieldToRight);
+
+/**Function to pick which of the approaches tied for the earliest arrival goes first, with the tables of the junction.
+*@param config the junction
+*@param tied bit set of the tied approaches, not 0
+*@param heads the first car of each approach, only the tied ones are looked at
+*@return the approach that goes first
+**/
+int resolveTie(IntersectionConfig *config, int tied, Data *heads);
+
+/**Function to give the side of the junction a car leaves on. Going forward it leaves on the side across from its
+*approach (a + k/2 of k approaches), turning right on the side before its approach and turning left on the one after.
+*@param config the junction
+*@param approach the approach the car comes from
+*@param turnDirection one of F, R, L, anything else is treated as F
+*@return the side, an approach number
+**/
+int exitSide(IntersectionConfig *config, int approach, char turnDirection);
+
+/**Function to give the movement of a car, its approach and its turn, as an index into conflicts.
+*@param approach the approach the car comes from
+*@param turnDirection one of F, R, L, anything else is treated as F
+*@return approach*3 plus 0, 1 or 2 for F, R, L
+**/
+int movementOf(int approach, char turnDirection);
+
+/**Function to give the name a direction is printed with, north, east, south and west for N, E, S, W and the
+*letter itself for any other approach.
+*@param direction letter of the approach
+*@param letter storage for the name of another approach, at least 2 characters
+*@return the name
+**/
+const char *directionName(char direction, char *letter);
+
+/**Function to allocate empty histograms of waits.
+*@return the histograms, NULL if memory could not be allocated
+**/
+WaitHistograms *initializeWaitHistograms(void);
+
+/**Function to add the waits of one set of histograms to another, for the totals of several runs.
+*@param to the histograms added to
+*@param from the histograms added, may be NULL
+**/
+void mergeWaitHistograms(WaitHistograms *to, const WaitHistograms *from);
+
+/**Function to free histograms of waits.
+*@param histograms the histograms to be deleted, may be NULL
+**/
+void deleteWaitHistograms(WaitHistograms *histograms);
+
+/**Function to print the p50, p90, p99 and p99.9 waits of each approach and turn that has cars and of all cars.
+*@param output where the lines go
+*@param mode OUTPUT_CARS and OUTPUT_SUMMARY print lines of text, OUTPUT_MACHINE a "percentiles" member of a JSON object
+*@param config the junction, giving the names of the approaches
+*@param histograms the waits, nothing is printed when it is NULL
+**/
+void printWaitPercentiles(OutputBuffer *output, int mode, IntersectionConfig *config, const WaitHistograms *histograms);
+
+/**Function to run the intersection over cars handed out by a source, writing the times of cars and the averages.
+*the approach heads are kept in a min heap keyed by time of arrival and rank, so each decision is O(log k) in the
+*number of approaches and this has a big O notation of N log k in the number of cars.
+*when config->shareBox is set, cars whose movements do not conflict are in the intersection together, see
+*simulateSharedBox in Intersection.c.
+*when config->resume is set, the cars the interrupted run had taken are taken from source again and thrown away,
+*and so is everything written to output up to there, so the output is what the interrupted run would have written
+*after its checkpoint. If the cars do not match the checkpoint nothing is simulated and config->resume->failed is set.
+*when config->incremental is set the run carries on from it and the cars of source are the ones after the cars
+*taken already. With a source whose horizon stops moving only cars whose times can not change when more cars come
+*are sent through, the rest wait in config->incremental for the next run, and the totals are those of the cars so far.
+*@pre source must hand out the cars of each direction sorted by time of arrival
+*@param source where the cars come from
+*@param config the junction, NULL for the four way intersection of INTERSECTION_DEFAULT_APPROACHES
+*@param compare function comparing the timeOfArrival of two cars
+*@param output where the results are written, it is flushed before returning
+*@param mode OUTPUT_CARS to write every car and the summary, OUTPUT_SUMMARY for only the summary, OUTPUT_MACHINE for a JSON summary
+*@param stats where the counts and waits of the run are left, may be NULL, its histograms have to be freed, they
+*stay in config->incremental for an incremental run and stats gets none
+*@return the time the last car leaves the intersection
+**/
+SimTime simulateIntersection(CarSource *source, IntersectionConfig *config, int (*compare)(void *first,void *second), OutputBuffer *output, int mode, IntersectionStats *stats);
+
+#endif
@@ -0,0 +1,98 @@
+/**
+ * @file IntrusiveList.h
+ * @author Logan Bell
+ * @date June 2018
+ * @brief File containing the function definitions of a sorted list whose links are kept inside the records.
+ */
+
+#ifndef _INTRUSIVE_LIST_API_
+#define _INTRUSIVE_LIST_API_
+
+#include <stddef.h>
+#include "Queue.h"
+
+/**
+ *Links of a record in an intrusive list. The record holds these itself, so putting it in a list allocates nothing and
+ *walking the list reads each record once instead of a Node and then its data. A record is in at most one list
+ *through one ListLinks.
+ **/
+typedef struct listLinks{
+    struct listLinks *previous;
+    struct listLinks *next;
+} ListLinks;
+
+/**
+ *Head of an intrusive list. offset is where the ListLinks are inside a record, offsetof(record type, links member),
+ *and compare is given the records themselves, so the compare functions of a List of the same records work here.
+ **/
+typedef struct intrusiveList{
+    ListLinks *head;
+    ListLinks *tail;
+    size_t offset;
+    int (*compare)(void *first,void *second);
+} IntrusiveList;
+
+/**
+ *Car with its links. car comes first, so a LinkedCar can be given to anything taking a Data.
+ **/
+typedef struct linkedCar{
+    Data car;
+    ListLinks links;
+} LinkedCar;
+
+/**Function to make an empty intrusive list in memory the caller owns, nothing is allocated.
+*@param list the list
+*@param offset where the ListLinks are inside a record, offsetof(record type, links member)
+*@param compareFunction function pointer to compare two records in order to test for order, NULL if linkSorted is not used
+**/
+void initializeIntrusiveList(IntrusiveList *list, size_t offset, int (*compareFunction)(void *first,void *second));
+
+/**Function to put a record at the back of the list. This has a big O notation of 1.
+*@pre record is not in a list through the same links
+*@param list the list
+*@param record the record
+**/
+void linkBack(IntrusiveList *list, void *record);
+
+/**Function to put a record in front of the first record of the list that is not smaller, the same place insertSorted
+*gives a List. This has a big O notation of n, but each step reads a single record.
+*@pre record is not in a list through the same links, the list was made with a compare function
+*@param list the list
+*@param record the record
+**/
+void linkSorted(IntrusiveList *list, void *record);
+
+/**Function to take a record out of the list. No compare function is called, this has a big O notation of 1.
+*@pre record is in the list
+*@param list the list
+*@param record the record, its links can be used for another list afterwards
+**/
+void unlinkRecord(IntrusiveList *list, void *record);
+
+/**Function to take the record at the front out of the list.
+*@param list the list
+*@return the record, NULL if the list is empty
+**/
+void *unlinkFront(IntrusiveList *list);
+
+/**Function to give the record at the front of the list.
+*@param list the list
+*@return the record, NULL if the list is empty
+**/
+void *firstRecord(IntrusiveList *list);
+
+/**Function to give the record after a record of the list.
+*@param list the list
+*@param record record of the list
+*@return the next record, NULL if record is the last
+**/
+void *nextRecord(IntrusiveList *list, void *record);
+
+/**Function to give the record in front of a record of the list.
+*@param list the list
+*@param record record of the list
+*@return the previous record, NULL if record is the first
+**/
+void *previousRecord(IntrusiveList *list, void *record);
+
+#endif
@@ -0,0 +1,59 @@
+/**
+ * @file MonteCarlo.h
+ * @author Logan Bell
+ * @date June 2018
+ * @brief File containing the function definitions of the Monte Carlo runs over synthetic cars.
+ */
+
+#ifndef _MONTECARLO_API_
+#define _MONTECARLO_API_
+
+#include <stddef.h>
+#include "Intersection.h"
+#include "Generator.h"
+#include "Output.h"
+
+/**
+ *Spread of one result over the replicates, with the half width of its 95% confidence interval for the mean.
+ *count is the number of replicates the result exists in, an approach without cars has no average wait.
+ **/
+typedef struct replicateSpread{
+    size_t count;
+    double mean;
+    double deviation;
+    double halfWidth;
+    double highest;
+} ReplicateSpread;
+
+/**Function to simulate replicates of the generator on a thread pool, each one streaming its cars straight into the
+*intersection without storing them. Replicate r gives the same results whatever the number of threads.
+*@return the totals of each replicate in order, NULL if memory could not be allocated or the threads not started
+*@param settings what the cars look like
+*@param config the junction
+*@param replicates number of replicates, at least 1
+*@param threadCount number of threads, 0 for one per processor
+*@param pooled where the waits of every replicate are added when the junction keeps percentiles, may be NULL
+**/
+IntersectionStats *runReplicates(const GeneratorConfig *settings, IntersectionConfig *config, size_t replicates, int threadCount, WaitHistograms *pooled);
+
+/**Function to find the mean, standard deviation, 95% confidence interval and highest value of a result over the
+*replicates that have it.
+*@param values the result of each replicate
+*@param present 1 for the replicates that have the result, NULL when they all do
+*@param count number of replicates
+*@return the spread
+**/
+ReplicateSpread spreadOf(const double *values, const int *present, size_t count);
+
+/**Function to print the average and max wait of each approach and of the whole junction over the replicates,
+*followed by the percentiles of the waits of all replicates together.
+*@param output where the results are written
+*@param mode OUTPUT_MACHINE for one JSON line, a table otherwise
+*@param config the junction
+*@param runs the totals of each replicate
+*@param count number of replicates
+*@param pooled the waits of every replicate, NULL to print no percentiles
+**/
+void printReplicates(OutputBuffer *output, int mode, IntersectionConfig *config, IntersectionStats *runs, size_t count, const WaitHistograms *pooled);
+
+#endif
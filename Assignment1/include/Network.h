@@ -0,0 +1,124 @@
+/**
+ * @file Network.h
+ * @author Logan Bell
+ * @date June 2018
+ * @brief File containing the function definitions of the discrete event simulation of a network of intersections.
+ */
+
+#ifndef _NETWORK_API_
+#define _NETWORK_API_
+
+#include <stddef.h>
+#include <stdint.h>
+#include "Queue.h"
+#include "Intersection.h"
+
+#define NETWORK_NO_LINK UINT32_MAX  //to of a side that leads out of the network
+
+/**
+ *Road leaving one side of an intersection. A car leaving on that side arrives at approach of intersection to
+ *after travelTime, or leaves the network when to is NETWORK_NO_LINK.
+ **/
+typedef struct networkLink{
+    uint32_t to;
+    int approach;
+    SimTime travelTime;
+} NetworkLink;
+
+/**
+ *Intersections of the network, all laid out like config. A car coming from approach a leaves on side a + k/2 going
+ *forward, on side a - 1 (its right) turning right and on side a + 1 (its left) turning left, k being the number
+ *of approaches. links holds one road per side of each intersection, intersection by intersection.
+ **/
+typedef struct network{
+    IntersectionConfig *config;
+    uint32_t count;
+    NetworkLink *links;
+} Network;
+
+/**
+ *Car travelling through the network. car is the car as seen by the intersection it is heading for, its turn
+ *is the turn of its route at that intersection. The turns of the route are kept in the route pool of the entries.
+ **/
+typedef struct networkCar{
+    Data car;
+    uint32_t intersection;
+    uint32_t route;
+    uint16_t routeLength;
+    uint16_t step;
+    SimTime entryTime;
+} NetworkCar;
+
+/**
+ *Cars entering the network, sorted by time of entry, with the turns of all their routes.
+ **/
+typedef struct networkEntries{
+    NetworkCar *cars;
+    size_t count;
+    char *routes;
+    size_t routesUsed;
+} NetworkEntries;
+
+/**
+ *Totals of a network run.
+ **/
+typedef struct networkStats{
+    size_t carsEntered;
+    size_t carsExited;
+    size_t passes;          //cars going through an intersection, a car crossing three intersections counts three times
+    size_t events;          //events taken off the calendar
+    size_t peakCalendar;    //most events waiting on the calendar at once
+    SimTime totalWait;
+    SimTime maxWaitTime;
+    SimTime totalTripTime;
+    SimTime endTime;
+} NetworkStats;
+
+/**Function to read the layout of a network. Each line is one of
+*  intersections <count>
+*  link <from> <side> <to> <approach> <travel time>
+*  grid <rows> <columns> <travel time>
+*where the sides and approaches are direction letters of the junction, and grid links every intersection of a
+*rows by columns grid of N, E, S, W intersections to its neighbours. Blank lines and lines starting with # are skipped.
+*@return the network, NULL if the file could not be read or is not valid, the reason is printed on stderr
+*@param fileName path of the network file
+*@param config layout of every intersection, it must live as long as the network
+**/
+Network *readNetwork(const char *fileName, IntersectionConfig *config);
+
+/**Function to read the cars entering a network, one per line as "<intersection> <approach> <turns> <time>",
+*turns being the turn the car makes at each intersection of its route, like "FFR". Lines that are not valid are
+*reported with their line number and skipped. The cars are sorted by time of entry, cars entering at the same
+*time are kept in the order a sorted List would keep them.
+*@return the entries, NULL if the file could not be opened or memory could not be allocated
+*@param fileName path of the entries file
+*@param network the network the cars enter
+**/
+NetworkEntries *readNetworkEntries(const char *fileName, Network *network);
+
+/**Function to run the network with a global event calendar. A car arriving at an intersection joins the queue of
+*its approach, and an intersection that is free decides which car goes next the same way simulateIntersection does,
+*once every car arriving at that time has joined its queue. This has a big O notation of E log C, E the number of
+*events and C the most events waiting on the calendar.
+*@pre entries must have been read for this network, their cars are moved through it
+*@param network the network
+*@param entries the cars entering the network
+*@param compare function comparing the timeOfArrival of two cars
+*@param output where the results are written, it is flushed before returning
+*@param mode OUTPUT_CARS for a line per intersection and the totals, OUTPUT_SUMMARY for the totals, OUTPUT_MACHINE for a JSON summary
+*@param stats where the totals of the run are left, may be NULL
+*@return the time the last car leaves an intersection
+**/
+SimTime simulateNetwork(Network *network, NetworkEntries *entries, int (*compare)(void *first,void *second), OutputBuffer *output, int mode, NetworkStats *stats);
+
+/**Function to free the entries.
+*@param entries the entries to be deleted
+**/
+void deleteNetworkEntries(NetworkEntries *entries);
+
+/**Function to free the network, its config is not freed.
+*@param network the network to be deleted
+**/
+void deleteNetwork(Network *network);
+
+#endif
@@ -0,0 +1,84 @@
+/**
+ * @file Output.h
+ * @author Logan Bell
+ * @date June 2018
+ * @brief File containing the function definitions of the buffered writer used for the simulation output.
+ */
+
+#ifndef _OUTPUT_API_
+#define _OUTPUT_API_
+
+#include <stdio.h>
+#include <stddef.h>
+
+#define OUTPUT_DEFAULT_CAPACITY (1024*1024)  //bytes collected before they are handed to the file
+
+#define OUTPUT_CARS 0     //every car entering and leaving, then the averages and max wait
+#define OUTPUT_SUMMARY 1  //only the averages and max wait
+#define OUTPUT_MACHINE 2  //only a one line JSON summary
+
+/**
+ *Writer that collects text in a large buffer and hands it to the file in big blocks. Numbers are formatted by hand.
+ *Without a file the buffer grows instead, so the text of a run can be kept and printed later.
+ **/
+typedef struct outputBuffer{
+    FILE *fp;
+    char *buffer;
+    size_t used;
+    size_t capacity;
+    unsigned long long written;  //bytes handed to the file so far
+    int discarding;              //1 while text is thrown away instead of being handed to the file
+} OutputBuffer;
+
+/**Function to create a writer for a file.
+*@return pointer to the writer, NULL if memory could not be allocated
+*@param fp file the text goes to, it is not closed by the writer, NULL to keep all the text in memory
+*@param capacity bytes collected before they are written, 0 for OUTPUT_DEFAULT_CAPACITY
+**/
+OutputBuffer *initializeOutput(FILE *fp, size_t capacity);
+
+/**Function to add a string to the writer.
+*@param output the writer
+*@param text string to add
+**/
+void writeText(OutputBuffer *output, const char *text);
+
+/**Function to add a single character to the writer.
+*@param output the writer
+*@param c character to add
+**/
+void writeChar(OutputBuffer *output, char c);
+
+/**Function to add an unsigned whole number to the writer.
+*@param output the writer
+*@param value number to add
+**/
+void writeUnsigned(OutputBuffer *output, unsigned long long value);
+
+/**Function to add a number with a fixed amount of decimals, right aligned, the same as printf("%*.*f").
+*rounding matches printf exactly for values that came from a float.
+*@param output the writer
+*@param value number to add
+*@param width minimum number of characters, padded with spaces on the left
+*@param decimals digits after the decimal point
+**/
+void writeFixed(OutputBuffer *output, double value, int width, int decimals);
+
+/**Function to hand everything collected so far to the file, a writer without a file keeps its text.
+*@param output the writer
+**/
+void flushOutput(OutputBuffer *output);
+
+/**Function to throw away the text collected so far and, while discarding is 1, every block after it instead of
+*handing it to the file. A resumed run leaves out this way what the interrupted run had already printed.
+*@param output the writer, may be NULL
+*@param discarding 1 to keep throwing text away, 0 to hand text to the file again from here on
+**/
+void discardOutput(OutputBuffer *output, int discarding);
+
+/**Function to flush the writer and free it, the file stays open.
+*@param output the writer to be deleted
+**/
+void deleteOutput(OutputBuffer *output);
+
+#endif
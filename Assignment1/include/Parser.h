@@ -0,0 +1,83 @@
+/**
+ * @file Parser.h
+ * @author Logan Bell
+ * @date June 2018
+ * @brief File containing the function definitions of the car input file reader.
+ */
+
+#ifndef _PARSER_API_
+#define _PARSER_API_
+
+#include <stddef.h>
+#include "Queue.h"
+
+/**
+ *Reader over a whole car input file. The file is memory mapped (read into memory where mapping is not available)
+ *and every line of the form "<N|E|S|W> <F|R|L> <time>" is turned into a car. Blank lines are skipped and any other
+ *line is reported with its line number and skipped. The travel directions accepted can be changed with setCarDirections.
+ **/
+typedef struct carReader{
+    const char *fileName;
+    char *start;
+    char *end;
+    char *position;
+    size_t length;
+    size_t lineNumber;
+    size_t malformedLines;
+    int mapped;
+    unsigned char knownDirection[256];
+} CarReader;
+
+/**Function to open a car input file for reading.
+*@return pointer to the reader, NULL if the file could not be opened or read or memory could not be allocated
+*@param fileName path of the car input file
+**/
+CarReader *openCarReader(const char *fileName);
+
+/**Function to set the travel directions the reader accepts, for junctions that are not N, E, S, W.
+*@pre reader must exist
+*@param reader the reader
+*@param directions every direction letter accepted
+**/
+void setCarDirections(CarReader *reader, const char *directions);
+
+/**Function to read the next car from the file. Malformed lines are reported on stderr and skipped.
+*@pre reader must exist
+*@post car holds the next car of the file when 1 is returned
+*@return 1 when a car was read, 0 at the end of the file
+*@param reader the reader to take the car from
+*@param car where the car is written
+**/
+int readCar(CarReader *reader, Data *car);
+
+/**Function to leave out the last line of the file when it does not end with a newline yet, for a file that is
+*still being written. A later reader over the file reads it once it is complete.
+*@pre nothing must have been read yet
+*@param reader the reader
+**/
+void dropPartialLine(CarReader *reader);
+
+/**Function to carry on reading from where an earlier reader over the same file stopped.
+*@pre nothing must have been read yet
+*@return EXIT_SUCCESS on success, EXIT_FAILURE if the file is shorter than offset
+*@param reader the reader
+*@param offset bytes of the file the earlier reader had gone through
+*@param lineNumber lines the earlier reader had gone through
+**/
+int seekCarReader(CarReader *reader, size_t offset, size_t lineNumber);
+
+/**Function to parse a time written as a decimal number, like "12", "3.2" or "1.5e2". It does not depend on the locale.
+*The number is read straight into ticks of the time base without going through a double.
+*@return pointer to the first character after the number, NULL if there is no number at text or it is too large
+*@param text first character of the number
+*@param end one past the last character that may be read
+*@param value where the time is written, in ticks
+**/
+const char *parseTime(const char *text, const char *end, SimTime *value);
+
+/**Function to close the reader and unmap the file.
+*@param reader the reader to be closed
+**/
+void closeCarReader(CarReader *reader);
+
+#endif
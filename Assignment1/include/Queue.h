@@ -10,10 +10,16 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <stdint.h>
+#include "Output.h"
+#include "SimTime.h"
+
+struct intersectionConfig;  //layout of the junction, defined in Intersection.h
+struct intersectionStats;   //counts and waits of a run, defined in Intersection.h
 typedef struct dataNode{
   char travelDirection;  //Travel direction is the direction the car is coming from going into the intersection. example: west
   char turnDirection;
-  float timeOfArrival;
+  SimTime timeOfArrival; //ticks of 1/TIME_UNITS_PER_SECOND of a second
 }Data;
 /**
 *Node of a linked list. This list is doubly linked, meaning that it has points to both the node immediately in front
@@ -26,7 +32,58 @@ typedef struct listNode{
 } Node;
 
 /**
+ *Source of cars for simulateIntersection. nextCar copies the next car coming from direction into car and returns 1,
+ *or returns 0 once that direction has no more cars. The cars of each direction must come out in order of arrival.
+ *horizon is NULL for a source that hands out every car there is. A source that reads its cars as they are needed,
+ *or over cars that are still coming, gives with it the time before which it knows every car, INT64_MAX once it knows
+ *them all. nextCar then returns 0 for a direction with no car before it yet, and is asked again before a car at or
+ *after it goes.
+ **/
+typedef struct carSource{
+    int (*nextCar)(void *state, char direction, Data *car);
+    SimTime (*horizon)(void *state);
+    void *state;
+} CarSource;
+
+/**
+ *Memory hooks used by a list to get and give back the memory for its nodes. context is passed to both functions.
+ *freesInBulk is 1 when everything handed out is given back at once by deleting the allocator itself (like an
+ *arena), so the list never has to visit its nodes one by one just to release them.
+ **/
+typedef struct listAllocator{
+    void *(*allocate)(void *context, size_t size);
+    void (*release)(void *context, void *toBeReleased, size_t size);
+    void *context;
+    int freesInBulk;
+} Allocator;
+
+#define SKIP_LIST_MAX_LEVELS 16  //levels of a skip list index, a quarter of the nodes go up each level so this is enough for 4^16 nodes
+
+/**
+ *Link of the index of a skip list. Each level of the index is a singly linked chain of links to nodes of the list in
+ *order, a level holding about a quarter of the nodes of the level below it, and down is the link of the same node one
+ *level lower (NULL on level 0, where the nodes themselves follow).
+ **/
+typedef struct skipLink{
+    Node *node;
+    struct skipLink *right;
+    struct skipLink *down;
+} SkipLink;
+
+/**
+ *Index kept beside the nodes of a skip list. heads[i] is the start of level i and has no node, its down is heads[i-1].
+ *random is the state of the generator drawing how many levels a new node goes up.
+ **/
+typedef struct skipIndex{
+    int levels;                            //levels in use, at least 1
+    SkipLink heads[SKIP_LIST_MAX_LEVELS];
+    uint64_t random;
+} SkipIndex;
+
+/**
  *Dummy head of the list. Contains no actual data on it beyond a pointer to the front and end of the list.
+ *A list made with initializeSkipList also has an index over its nodes, so insertSorted and deleteDataFromList find
+ *their place in expected O(log n), everything else walks the nodes the same way.
  **/
 typedef struct listHead{
     Node *head;
@@ -35,15 +92,38 @@ typedef struct listHead{
     int (*compare)(void *first,void *second);
     int (*compareNode) (void *first, void *second);
     void (*printData)(void *toBePrinted);
+    Allocator *allocator;
+    SkipIndex *index;   //NULL unless the list is a skip list
 } List;
 
 /**Function to point the list head to the appropriate functions. Allocates memory to the struct.
-*@return pointer to the list head
+*@return pointer to the list head, NULL if memory could not be allocated
 *@param printFunction function pointer to print a single node of the list
 *@param deleteFunction function pointer to delete a single piece of data from the list
 *@param compareFunction function pointer to compare two nodes of the list in order to test for equality or order
 **/
 List *initializeList(void (*printFunction)(void *toBePrinted),void (*deleteFunction)(void *toBeDeleted),int (*compareNodeFunction)(void *first,void *second),int (*compareFunction)(void *primary,void *secondary));
+
+/**Function to create a list whose nodes come from the given allocator instead of malloc.
+*@return pointer to the list head, NULL if memory could not be allocated
+*@param printFunction function pointer to print a single node of the list
+*@param deleteFunction function pointer to delete a single piece of data from the list, NULL if the list does not own its data
+*@param compareFunction function pointer to compare two nodes of the list in order to test for equality or order
+*@param allocator memory hooks for the nodes, NULL to use malloc. The allocator must outlive the list.
+**/
+List *initializeListWithAllocator(void (*printFunction)(void *toBePrinted),void (*deleteFunction)(void *toBeDeleted),int (*compareNodeFunction)(void *first,void *second),int (*compareFunction)(void *primary,void *secondary),Allocator *allocator);
+
+/**Function to create a sorted list with a skip list index over its nodes. insertSorted and deleteDataFromList take
+*expected O(log n) instead of a walk of the list, and the list keeps exactly the order insertSorted gives a plain list.
+*@return pointer to the list head, NULL if memory could not be allocated
+*@param printFunction function pointer to print a single node of the list
+*@param deleteFunction function pointer to delete a single piece of data from the list, NULL if the list does not own its data
+*@param compareNodeFunction function pointer telling whether two pieces of data are the same, data it finds the same
+*must also be equal by compareFunction
+*@param compareFunction function pointer to compare two nodes of the list in order to test for equality or order
+*@param allocator memory hooks for the nodes and the links of the index, NULL to use malloc. The allocator must outlive the list.
+**/
+List *initializeSkipList(void (*printFunction)(void *toBePrinted),void (*deleteFunction)(void *toBeDeleted),int (*compareNodeFunction)(void *first,void *second),int (*compareFunction)(void *primary,void *secondary),Allocator *allocator);
 
 /**Function for creating a node for a linked list. This node contains generic data and may be connected to
 other notes in a list.
@@ -56,13 +136,18 @@ other notes in a list.
 Node *initializeNode(void * data);
 
 /**Inserts a Node to the back of a linked list. The list then updates accordingly to adhere to the ADT.
+*on a skip list the node is not added to the index, and the data must not be smaller than the tail to keep it sorted.
 *@pre 'List' type must exist and be used in order to keep track of the linked list.
 *@param list pointer to the dummy head of the list
 *@param toBeAdded a pointer to data that is to be added to the linked list
+*@return the node holding the data, a handle for removeNode, nextNode and previousNode that stays valid until the
+*node is removed or the list deleted. NULL if list is NULL or memory could not be allocated
 **/
-void insertBack(List *list, void *data);
+Node *insertBack(List *list, void *data);
 
 /** Deletes the entire linked list head to tail, starting with the nodes, followed by the list itself.
+*when the nodes come from an allocator that frees in bulk and the list has no deleteFunction, the nodes are left
+*for the allocator and this is O(1).
 *@pre 'List' type must exist and be used in order to keep track of the linked list.
 *@param list pointer to the List-type dummy node
 **/
@@ -70,23 +155,52 @@ void deleteList(List *list);
 
 /** Uses the comparison function in the List struct to place the element in the appropriate position in the list.
 *this is intended to be used from the beginning in order to keep the list completely sorted.
+*this has a big O notation of n, or an expected log n on a skip list.
 *@pre List exists and has memory allocated to it. Node to be added is valid.
 *@post The node to be added will be placed immediately before or after the first occurrence of a related node
 *@param list a pointer to the dummy head of the list containing function pointers for delete and compare, as well
 as a pointer to the first and last element of the list.
 *@param toBeAdded a pointer to data that is to be added to the linked list
+*@return the node holding the data, a handle like the one insertBack returns. NULL if list is NULL or memory could not be allocated
 **/
-void insertSorted(List *list, void *data);
+Node *insertSorted(List *list, void *data);
+
+/** Inserts a whole array of data into the list with one sort and one pass over the list, instead of calling
+*insertSorted once per element. The list ends up exactly as if insertSorted had been called on each element in
+*array order, meaning equal elements are placed in front of the equal elements that were added before them.
+*this has a big O notation of N log N + M, N being count and M being the length of the list, the index of a skip
+*list is built again in the same pass.
+*@pre List exists and has memory allocated to it. Every element of data is valid.
+*@post the list owns all of the data and stays sorted
+*@param list a pointer to the dummy head of the list containing the compare function pointer
+*@param data array of pointers to the data to be added, the array itself is not kept by the list
+*@param count number of elements in data
+*@return EXIT_SUCCESS on success, EXIT_FAILURE if memory could not be allocated
+**/
+int insertSortedBulk(List *list, void **data, size_t count);
+
+/** Inserts a whole array of cars into a list sorted by time of arrival, like insertSortedBulk, but the cars are put
+*in order with a radix sort of their whole number times instead of calls to the compare function.
+*this has a big O notation of N + M, N being count and M being the length of the list.
+*@pre List exists, holds Data and is sorted by timeOfArrival with compareTimeFunction. Every car is valid.
+*@post the list owns all of the cars and stays sorted
+*@param list a pointer to the dummy head of the list
+*@param cars array of pointers to the cars to be added, the array itself is not kept by the list
+*@param count number of elements in cars
+*@return EXIT_SUCCESS on success, EXIT_FAILURE if memory could not be allocated
+**/
+int insertSortedByTime(List *list, Data **cars, size_t count);
 
 /**Function to return the data at the front of the list.
  *@pre The list exists and has memory allocated to it
  *@param list pointer to the dummy head of the list containing the head of the list
- *@return pointer to the data located at the head of the list
+ *@return pointer to the data located at the head of the list, NULL if the list is empty
  **/
 void *getFromFront(List *list);
 
 /**Function to remove a node from the list and alter the pointers accordingly to not disrupt the order of the
- *data structure.
+ *data structure. On a skip list the node is found through the index in expected log n, where the data equal to
+ *toBeDeleted by compare are searched for the one compareNode finds the same.
  *@pre List must exist and have memory allocated to it
  *@post toBeDeleted will have its memory freed if it exists in the list.
  *@param list pointer to the dummy head of the list containing deleteFunction function pointer
@@ -95,7 +209,35 @@ void *getFromFront(List *list);
  **/
 int deleteDataFromList(List *list, void *toBeDeleted);
 
-//comment needed!!!
+/**Function to remove a node the caller already holds from the list without deleting its data. No compare function
+ *is called and nothing is searched for, this has a big O notation of 1. On a skip list the links of the index to the
+ *node have to go too, which is found in an expected log n.
+ *@pre toBeRemoved is a node of list
+ *@post the node is freed and the handle must not be used again
+ *@param list pointer to the dummy head of the list
+ *@param toBeRemoved node returned by insertBack or insertSorted, or reached from one with nextNode or previousNode
+ *@return pointer to the data that was in the node, NULL if list or toBeRemoved is NULL
+ **/
+void *removeNode(List *list, Node *toBeRemoved);
+
+/**Function to give the node after a node of a list. This has a big O notation of 1.
+ *@param node node of a list
+ *@return the next node, NULL if node is the tail or NULL
+ **/
+Node *nextNode(Node *node);
+
+/**Function to give the node in front of a node of a list. This has a big O notation of 1.
+ *@param node node of a list
+ *@return the previous node, NULL if node is the head or NULL
+ **/
+Node *previousNode(Node *node);
+
+/**Function to remove the node at the front of the list without deleting its data.
+ *@pre The list exists and has memory allocated to it
+ *@post the head node is freed and the head of the list is moved to the next node
+ *@param list pointer to the dummy head of the list
+ *@return pointer to the data that was at the head of the list, NULL if the list is empty
+ **/
 void *deleteFromFront(List *list);
 
 /**Function to print list from head to tail. This will utilize the list's printData function pointer to print.
@@ -111,24 +253,43 @@ void printForward(List *list);
 void printBackwards(List *list);
 
 /**Function to calculate varying times of cars entering intersection, This will go through the list and stdout all the times of cars.
+the list is split once into a FIFO queue per direction, so picking the next car of a direction is O(1) and
 this has a big O notation of 2N as the elements of the list must be gone through completely twice.
 *@pre List must exist, but does not have to have elements.
 *@param list pointer to linked list dummy head
+*@return the time the last car leaves the intersection
 **/
-float calculateTime(List *list);
+SimTime calculateTime(List *list);
+
+/**Function to run the intersection over the cars of a sorted list, writing the results to output.
+*the list is split once into a FIFO queue per direction, so picking the next car of a direction is O(1).
+*@pre List must exist and be sorted by time of arrival, but does not have to have elements.
+*@param list pointer to linked list dummy head
+*@param config the junction (see Intersection.h), NULL for the four way intersection
+*@param output where the results are written
+*@param mode one of OUTPUT_CARS, OUTPUT_SUMMARY, OUTPUT_MACHINE
+*@param stats where the counts and waits of the run are left (see Intersection.h), may be NULL
+*@return the time the last car leaves the intersection
+**/
+SimTime simulateList(List *list, struct intersectionConfig *config, OutputBuffer *output, int mode, struct intersectionStats *stats);
 
 /**function to calculate the time required to turn in the intersection.
 *@pre firstData must exist and have a direction
 *@param data for car turning
+*@return the time taken in ticks
 **/
-float turnTime(Data *firstData);
+SimTime turnTime(Data *firstData);
 
-/**function to find the next car for the respective direction.
-this has a big O notation of n.
-*@pre list must exist
-*@param list pointer to linked list dummy head, direction, data of previous first
+/**function to remove the first car of a direction and find the next car for that direction. The old first is
+removed by its handle and the search starts from where it was, this has a big O notation of the number of cars
+between the two.
+*@pre list must exist and be sorted by time of arrival, first must be the earliest car of direction in the list
+*@param list pointer to linked list dummy head
+*@param first node of the previous first car, its data is deleted with the list's deleteFunction
+*@param direction direction of the previous first car
+*@return node of the new first car of direction, NULL if the direction has no more cars
 **/
-Data* findNewFirst(List *list,Data *firstData, char direction);
+Node *findNewFirst(List *list, Node *first, char direction);
 
 
 
@@ -0,0 +1,73 @@
+/**
+ * @file Rollup.h
+ * @author Logan Bell
+ * @date June 2018
+ * @brief File containing the function definitions of the windows of time a run reports on as they close.
+ */
+
+#ifndef _ROLLUP_API_
+#define _ROLLUP_API_
+
+#include <stdint.h>
+#include "Output.h"
+#include "Intersection.h"
+
+/**
+ *Counts of one approach in one window. arrivals, totalWait and maxWait are for the cars that arrived in the window,
+ *departures for the cars that left the intersection in it.
+ **/
+typedef struct windowCounts{
+    uint64_t arrivals;
+    uint64_t departures;
+    SimTime totalWait;
+    SimTime maxWait;
+} WindowCounts;
+
+/**
+ *Windows of time of a run, window n going from n*length to (n + 1)*length. The windows that are still open are kept
+ *in a ring, from the oldest one to the one the last car to leave leaves in. A window closes once no car still to go
+ *arrived in it, and is printed then, so nothing has to be kept per car.
+ **/
+typedef struct windowRollup{
+    SimTime length;                //ticks of a window
+    int64_t first;                 //number of the oldest open window
+    int64_t last;                  //number of the newest window with counts, first - 1 when none has
+    SimTime closesAt;              //end of the oldest open window with counts, INT64_MAX when none has
+    size_t capacity;               //windows the ring holds, a power of two
+    WindowCounts *counts;          //counts of window n and approach a at ((n & (capacity - 1))*approaches + a)
+    IntersectionConfig *config;
+    OutputBuffer *output;
+    int mode;
+} WindowRollup;
+
+/**Function to create the windows of a run.
+*@return pointer to the windows, NULL if memory could not be allocated
+*@param length ticks of a window, more than 0
+*@param config the junction, giving the approaches and their names
+*@param output where the windows are printed as they close
+*@param mode OUTPUT_CARS and OUTPUT_SUMMARY print a line of text per approach, OUTPUT_MACHINE a line of JSON per window
+**/
+WindowRollup *initializeRollup(SimTime length, IntersectionConfig *config, OutputBuffer *output, int mode);
+
+/**Function to count a car that has gone into the intersection, in the window it arrived in and the one it leaves in.
+*@param rollup the windows
+*@param approach approach of the car
+*@param timeOfArrival when the car arrived
+*@param waitTime how long it waited
+*@param leaveTime when it leaves the intersection
+**/
+void recordRollup(WindowRollup *rollup, int approach, SimTime timeOfArrival, SimTime waitTime, SimTime leaveTime);
+
+/**Function to print and close the windows ending at or before the earliest arrival of the cars still to go, no car
+*counted later arrives or leaves in them.
+*@param rollup the windows
+*@param earliest the earliest arrival of the cars still to go, INT64_MAX to close every window at the end of a run
+**/
+void closeRollup(WindowRollup *rollup, SimTime earliest);
+
+/**Function to free the windows, the ones still open are not printed.
+*@param rollup the windows to be deleted, may be NULL
+**/
+void deleteRollup(WindowRollup *rollup);
+
+#endif
@@ -0,0 +1,80 @@
+/**
+ * @file SimTime.h
+ * @author Logan Bell
+ * @date June 2018
+ * @brief File containing the function definitions of the whole number time base of the simulation.
+ */
+
+#ifndef _SIMTIME_API_
+#define _SIMTIME_API_
+
+#include <stdint.h>
+#include "Output.h"
+
+//ticks in a second, build with -DTIME_UNITS_PER_SECOND=100 for hundredths. It has to be a power of ten from 10 up,
+//the right and left turns take 1.5 and 3.5 seconds
+#ifndef TIME_UNITS_PER_SECOND
+#define TIME_UNITS_PER_SECOND 1000
+#endif
+
+#if TIME_UNITS_PER_SECOND == 10
+#define TIME_DECIMALS 1
+#elif TIME_UNITS_PER_SECOND == 100
+#define TIME_DECIMALS 2
+#elif TIME_UNITS_PER_SECOND == 1000
+#define TIME_DECIMALS 3
+#elif TIME_UNITS_PER_SECOND == 10000
+#define TIME_DECIMALS 4
+#elif TIME_UNITS_PER_SECOND == 100000
+#define TIME_DECIMALS 5
+#elif TIME_UNITS_PER_SECOND == 1000000
+#define TIME_DECIMALS 6
+#elif TIME_UNITS_PER_SECOND == 10000000
+#define TIME_DECIMALS 7
+#elif TIME_UNITS_PER_SECOND == 100000000
+#define TIME_DECIMALS 8
+#elif TIME_UNITS_PER_SECOND == 1000000000
+#define TIME_DECIMALS 9
+#else
+#error "TIME_UNITS_PER_SECOND has to be a power of ten from 10 to 1000000000"
+#endif
+
+/**
+ *A time or a length of time in ticks of 1/TIME_UNITS_PER_SECOND of a second. Times are whole numbers so cars
+ *arriving together compare equal however long the run is, and sums of waits are exact.
+ **/
+typedef int64_t SimTime;
+
+/**Function to give the tick nearest to a number of seconds.
+*@param seconds the time in seconds
+*@return the time in ticks
+**/
+SimTime timeFromSeconds(double seconds);
+
+/**Function to give a time in seconds, for printing and for statistics that are not times themselves.
+*@param time the time in ticks
+*@return the time in seconds
+**/
+double secondsOf(SimTime time);
+
+/**Function to add a time in seconds with a fixed amount of decimals, right aligned, like writeFixed. The digits
+*are worked out from the ticks, halves going to the even digit like printf, so the text is the same on every
+*machine.
+*@param output the writer
+*@param time the time in ticks
+*@param width minimum number of characters, padded with spaces on the left
+*@param decimals digits after the decimal point, at most 9
+**/
+void writeTime(OutputBuffer *output, SimTime time, int width, int decimals);
+
+/**Function to add the average of a sum of times in seconds, rounded to the nearest like writeTime.
+*@pre count must not be 0
+*@param output the writer
+*@param total the sum of the times in ticks
+*@param count number of times in the sum
+*@param width minimum number of characters, padded with spaces on the left
+*@param decimals digits after the decimal point, at most 9
+**/
+void writeAverageTime(OutputBuffer *output, SimTime total, uint64_t count, int width, int decimals);
+
+#endif
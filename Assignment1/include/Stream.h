@@ -0,0 +1,77 @@
+/**
+ * @file Stream.h
+ * @author Logan Bell
+ * @date June 2018
+ * @brief File containing the function definitions of the streaming simulation of a pre-sorted car file.
+ */
+
+#ifndef _STREAM_API_
+#define _STREAM_API_
+
+#include <stddef.h>
+#include "Queue.h"
+#include "Intersection.h"
+#include "Parser.h"
+
+/**
+ *FIFO of the cars of one direction that have been read but have not gone through the intersection yet.
+ *The cars are stored by value in a ring that grows when it is full.
+ **/
+typedef struct carQueue{
+    Data *cars;
+    size_t first;
+    size_t count;
+    size_t capacity;
+} CarQueue;
+
+/**
+ *State of a streaming run. Cars are only read from the file when the intersection needs to know about them,
+ *so memory holds the cars waiting at the intersection plus the cars of the next time in the file.
+ *growing is 1 when cars may still be appended to the file. The cars with the time of the last car read are then
+ *held back, a car appended with the same time would go in front of them, and the horizon is that time.
+ **/
+typedef struct carStream{
+    CarReader *reader;
+    IntersectionConfig *config;
+    CarQueue queues[INTERSECTION_MAX_APPROACHES];
+    SimTime lastTimeRead;
+    int endOfFile;
+    int growing;
+    size_t carsRead;
+    size_t carsBuffered;
+    size_t peakCarsBuffered;
+    size_t outOfOrderCars;
+} CarStream;
+
+/**Function to simulate a car file that is already sorted by time of arrival without loading it, the cars are
+*printed as soon as their times are known. The results are the same as for the whole file in a sorted list.
+*Cars that arrive before the car read ahead of them are reported with their line number and skipped.
+*@pre reader must be open on a file sorted by time of arrival
+*@param reader the reader over the car file
+*@param config the junction, NULL for the four way intersection
+*@param compare function comparing the timeOfArrival of two cars
+*@param output where the results are written
+*@param mode one of OUTPUT_CARS, OUTPUT_SUMMARY, OUTPUT_MACHINE
+*@param stream where the counters of the run are left, may be NULL
+*@return the time the last car leaves the intersection
+**/
+SimTime simulateStream(CarReader *reader, IntersectionConfig *config, int (*compare)(void *first,void *second), OutputBuffer *output, int mode, CarStream *stream);
+
+/**Function to simulate the cars appended to a car file since its last refresh, carrying on from the state saved in
+*stateFile by that refresh and saving the state again at the end, so a refresh only reads the new lines. The cars
+*printed by the refreshes one after another are the cars of simulateStream over the whole file, the ones that a
+*car appended later could still change wait for a later refresh, and the summary is that of the cars so far.
+*A refresh with final set takes the file as complete, sends every car through and leaves stateFile as it was.
+*@pre reader must be open on a file sorted by time of arrival, with the cars of the last refresh at its start
+*@param reader the reader over the car file
+*@param config the junction
+*@param compare function comparing the timeOfArrival of two cars
+*@param output where the results are written
+*@param mode one of OUTPUT_CARS, OUTPUT_SUMMARY, OUTPUT_MACHINE
+*@param stateFile where the state is kept between refreshes, the file is simulated from its start when it does not exist
+*@param final 1 when no more cars will be appended, 0 otherwise
+*@return EXIT_SUCCESS on success, EXIT_FAILURE if the state could not be read or saved, the reason is printed on stderr
+**/
+int refreshStream(CarReader *reader, IntersectionConfig *config, int (*compare)(void *first,void *second), OutputBuffer *output, int mode, const char *stateFile, int final);
+
+#endif
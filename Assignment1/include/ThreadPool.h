@@ -0,0 +1,84 @@
+/**
+ * @file ThreadPool.h
+ * @author Logan Bell
+ * @date June 2018
+ * @brief File containing the function definitions of a work stealing thread pool for independent simulations.
+ */
+
+#ifndef _THREADPOOL_API_
+#define _THREADPOOL_API_
+
+#include <stddef.h>
+#include <pthread.h>
+
+/**
+ *Piece of work handed to the pool, run(argument) is called once on one of the threads.
+ **/
+typedef struct poolTask{
+    void (*run)(void *argument);
+    void *argument;
+} PoolTask;
+
+/**
+ *Double ended queue of tasks owned by one thread. The owner takes its newest task from the back, other threads
+ *that ran out of work steal the oldest task from the front.
+ **/
+typedef struct taskDeque{
+    PoolTask *tasks;
+    size_t first;
+    size_t count;
+    size_t capacity;
+    pthread_mutex_t lock;
+} TaskDeque;
+
+/**
+ *Threads that each run the tasks of their own deque and steal from the others when it is empty.
+ *There is a deque for every thread asked for, threadCount is how many of them started.
+ *queued counts the tasks sitting in deques and pending the tasks not finished yet, both under lock.
+ **/
+typedef struct threadPool{
+    int threadCount;
+    int dequeCount;
+    pthread_t *threads;
+    TaskDeque *deques;
+    pthread_mutex_t lock;
+    pthread_cond_t workAvailable;
+    pthread_cond_t allDone;
+    size_t queued;
+    size_t pending;
+    size_t nextDeque;
+    size_t steals;
+    int stopping;
+} ThreadPool;
+
+/**Function to give the number of processors, the default number of threads.
+*@return number of processors online, at least 1
+**/
+int processorCount(void);
+
+/**Function to start a pool of threads.
+*@return pointer to the pool, NULL if the threads could not be started
+*@param threadCount number of threads, 0 for processorCount()
+**/
+ThreadPool *initializeThreadPool(int threadCount);
+
+/**Function to hand a task to the pool, tasks are spread over the deques of the threads in turn.
+*@pre pool must exist
+*@return EXIT_SUCCESS on success, EXIT_FAILURE if memory could not be allocated
+*@param pool the pool
+*@param run function to run
+*@param argument passed to run
+**/
+int submitTask(ThreadPool *pool, void (*run)(void *argument), void *argument);
+
+/**Function to wait until every task handed to the pool has finished.
+*@param pool the pool
+**/
+void waitForTasks(ThreadPool *pool);
+
+/**Function to finish the tasks left, stop the threads and free the pool.
+*@param pool the pool to be deleted
+**/
+void deleteThreadPool(ThreadPool *pool);
+
+#endif
@@ -0,0 +1,85 @@
+/**
+ * @file Trace.h
+ * @author Logan Bell
+ * @date June 2018
+ * @brief File containing the function definitions of the binary columnar car trace.
+ */
+
+#ifndef _TRACE_API_
+#define _TRACE_API_
+
+#include <stddef.h>
+#include <stdint.h>
+#include "Queue.h"
+#include "Intersection.h"
+
+#define TRACE_MAGIC "CARTRACE"       //first eight bytes of every trace file
+#define TRACE_VERSION 2              //version 1 kept the times as 32 bit floats in seconds
+#define TRACE_BYTE_ORDER 0x01020304u //reads back differently when the file was written on a machine of the other endianness
+#define TRACE_FLAG_SORTED 1u         //cars are stored in the order the sorted list keeps them
+
+/**
+ *Header at the start of a trace file. The three columns follow it, each column holds one field of Data for every
+ *car: travelDirection and turnDirection as one byte per car, timeOfArrival as a 64 bit number of ticks, timeUnits
+ *being the ticks in a second (TIME_UNITS_PER_SECOND of the program that wrote it). The offsets are from the start of
+ *the file and timeOffset is a multiple of 8.
+ **/
+typedef struct traceHeader{
+    char magic[8];
+    uint32_t version;
+    uint32_t byteOrder;
+    uint64_t count;
+    uint32_t flags;
+    uint32_t timeUnits;
+    uint64_t travelOffset;
+    uint64_t turnOffset;
+    uint64_t timeOffset;
+    uint64_t reserved;
+} TraceHeader;
+
+/**
+ *Trace file mapped into memory, the column pointers point straight into the mapping.
+ **/
+typedef struct trace{
+    TraceHeader header;
+    const char *travelDirection;
+    const char *turnDirection;
+    const SimTime *timeOfArrival;
+    size_t count;
+    void *mapping;
+    size_t length;
+    int mapped;
+} Trace;
+
+/**Function to write every car of a sorted list to a trace file, the file is flagged as sorted.
+*@pre list must be sorted by time of arrival and hold Data
+*@return EXIT_SUCCESS on success, EXIT_FAILURE if the file could not be written
+*@param fileName path of the trace file to create
+*@param list the sorted list of cars
+**/
+int writeTrace(const char *fileName, List *list);
+
+/**Function to map a trace file into memory and check its header.
+*@return pointer to the trace, NULL if the file could not be read or is not a valid trace (the reason is on stderr)
+*@param fileName path of the trace file
+**/
+Trace *openTrace(const char *fileName);
+
+/**Function to run the intersection straight from the columns of a trace, nothing is parsed or allocated per car.
+*@pre trace must exist
+*@param trace the mapped trace
+*@param config the junction, NULL for the four way intersection
+*@param compare function comparing the timeOfArrival of two cars
+*@param output where the results are written
+*@param mode one of OUTPUT_CARS, OUTPUT_SUMMARY, OUTPUT_MACHINE
+*@param stats where the counts and waits of the run are left, may be NULL
+*@return the time the last car leaves the intersection
+**/
+SimTime simulateTrace(Trace *trace, IntersectionConfig *config, int (*compare)(void *first,void *second), OutputBuffer *output, int mode, IntersectionStats *stats);
+
+/**Function to unmap the trace.
+*@param trace the trace to be closed
+**/
+void closeTrace(Trace *trace);
+
+#endif
@@ -0,0 +1,253 @@
+/**
+ * @file TypedQueue.h
+ * @author Logan Bell
+ * @date June 2018
+ * @brief File containing a macro that generates a sorted queue for one element type, with its compare functions
+ * known when it is compiled.
+ */
+
+#ifndef _TYPED_QUEUE_API_
+#define _TYPED_QUEUE_API_
+
+#include <stdlib.h>
+#include <string.h>
+#include "Queue.h"
+
+/**
+ *DEFINE_TYPED_QUEUE(Queue, prefix, Type, compare, compareNode) makes a struct Queue and static inline functions
+ *prefixInitialize, prefixDelete, prefixInsertBack, prefixInsertSorted, prefixDeleteData, prefixGetFromFront,
+ *prefixDeleteFromFront, prefixAt and prefixCount that work like the List functions of the same names, but keep the
+ *elements by value in one array and call compare and compareNode directly, so they are inlined into the loops.
+ *compare(const Type *, const Type *) orders two elements like the compare of a List and compareNode(const Type *,
+ *const Type *) is 0 when they are the same element, like the compareNode of a List.
+ *The elements are kept from first to first + count - 1, so taking the front is O(1), insertSorted finds its place with
+ *a binary search and then moves whichever side of the place is shorter by one element, so adding at either end is
+ *O(1) amortised. Pointers from prefixAt and prefixGetFromFront are only good until the queue is next changed.
+ **/
+#define DEFINE_TYPED_QUEUE(Queue, prefix, Type, compare, compareNode) \
+typedef struct { \
+    Type *elements; \
+    size_t first;     /*index of the front element*/ \
+    size_t count; \
+    size_t capacity; \
+} Queue; \
+\
+static inline void prefix##Initialize(Queue *queue) \
+{ \
+  queue->elements = NULL; \
+  queue->first = 0; \
+  queue->count = 0; \
+  queue->capacity = 0; \
+} \
+\
+static inline void prefix##Delete(Queue *queue) \
+{ \
+  free(queue->elements); \
+  prefix##Initialize(queue); \
+} \
+\
+static inline size_t prefix##Count(const Queue *queue) \
+{ \
+  return queue->count; \
+} \
+\
+static inline Type *prefix##At(Queue *queue, size_t position) \
+{ \
+  return &queue->elements[queue->first + position]; \
+} \
+\
+/*making room for one more element after the last, moving the elements back to the start when more than half of*/ \
+/*the array is in front of them, otherwise doubling the array*/ \
+static inline int prefix##Reserve(Queue *queue) \
+{ \
+  if(queue->first + queue->count < queue->capacity) \
+  { \
+    return EXIT_SUCCESS; \
+  } \
+  if(queue->first > queue->capacity/2) \
+  { \
+    memmove(queue->elements,queue->elements + queue->first,sizeof(Type)*queue->count); \
+    queue->first = 0; \
+    return EXIT_SUCCESS; \
+  } \
+  size_t newCapacity = (queue->capacity == 0) ? 64 : queue->capacity*2; \
+  Type *newElements = realloc(queue->elements,sizeof(Type)*newCapacity); \
+  if(newElements == NULL) \
+  { \
+    return EXIT_FAILURE; \
+  } \
+  queue->elements = newElements; \
+  queue->capacity = newCapacity; \
+  return EXIT_SUCCESS; \
+} \
+\
+/*making room for one more element in front of the first, centring the elements in an array at least twice their*/ \
+/*size so the room in front lasts for a while*/ \
+static inline int prefix##ReserveFront(Queue *queue) \
+{ \
+  if(queue->first > 0) \
+  { \
+    return EXIT_SUCCESS; \
+  } \
+  if(queue->capacity < 2*queue->count + 2) \
+  { \
+    size_t newCapacity = (queue->capacity == 0) ? 64 : queue->capacity*2; \
+    while(newCapacity < 2*queue->count + 2) \
+    { \
+      newCapacity = newCapacity*2; \
+    } \
+    Type *newElements = realloc(queue->elements,sizeof(Type)*newCapacity); \
+    if(newElements == NULL) \
+    { \
+      return EXIT_FAILURE; \
+    } \
+    queue->elements = newElements; \
+    queue->capacity = newCapacity; \
+  } \
+  size_t newFirst = (queue->capacity - queue->count)/2; \
+  memmove(queue->elements + newFirst,queue->elements,sizeof(Type)*queue->count); \
+  queue->first = newFirst; \
+  return EXIT_SUCCESS; \
+} \
+\
+/*position of the first element that is not smaller than value, count when every element is smaller*/ \
+static inline size_t prefix##LowerBound(const Queue *queue, const Type *value) \
+{ \
+  const Type *elements = queue->elements + queue->first; \
+  size_t low = 0; \
+  size_t high = queue->count; \
+  while(low < high) \
+  { \
+    size_t middle = low + (high - low)/2; \
+    if(compare(&elements[middle],value) < 0) \
+    { \
+      low = middle + 1; \
+    } \
+    else \
+    { \
+      high = middle; \
+    } \
+  } \
+  return low; \
+} \
+\
+static inline int prefix##InsertBack(Queue *queue, Type value) \
+{ \
+  if(prefix##Reserve(queue) != EXIT_SUCCESS) \
+  { \
+    return EXIT_FAILURE; \
+  } \
+  queue->elements[queue->first + queue->count] = value; \
+  queue->count++; \
+  return EXIT_SUCCESS; \
+} \
+\
+static inline int prefix##InsertSorted(Queue *queue, Type value) \
+{ \
+  size_t position = prefix##LowerBound(queue,&value); \
+  if(position < queue->count - position) \
+  { \
+    /*the front is shorter, it moves down one into the free space in front of it*/ \
+    if(prefix##ReserveFront(queue) != EXIT_SUCCESS) \
+    { \
+      return EXIT_FAILURE; \
+    } \
+    queue->first--; \
+    memmove(queue->elements + queue->first,queue->elements + queue->first + 1,sizeof(Type)*position); \
+  } \
+  else \
+  { \
+    if(prefix##Reserve(queue) != EXIT_SUCCESS) \
+    { \
+      return EXIT_FAILURE; \
+    } \
+    Type *place = queue->elements + queue->first + position; \
+    memmove(place + 1,place,sizeof(Type)*(queue->count - position)); \
+  } \
+  queue->elements[queue->first + position] = value; \
+  queue->count++; \
+  return EXIT_SUCCESS; \
+} \
+\
+static inline Type *prefix##GetFromFront(Queue *queue) \
+{ \
+  if(queue->count == 0) \
+  { \
+    return NULL; \
+  } \
+  return &queue->elements[queue->first]; \
+} \
+\
+static inline int prefix##DeleteFromFront(Queue *queue, Type *value) \
+{ \
+  if(queue->count == 0) \
+  { \
+    return EXIT_FAILURE; \
+  } \
+  if(value != NULL) \
+  { \
+    *value = queue->elements[queue->first]; \
+  } \
+  queue->first++; \
+  queue->count--; \
+  if(queue->count == 0) \
+  { \
+    queue->first = 0; \
+  } \
+  return EXIT_SUCCESS; \
+} \
+\
+/*EXIT_SUCCESS when the element was removed, -1 when it is not in the queue like deleteDataFromList*/ \
+static inline int prefix##DeleteData(Queue *queue, const Type *value) \
+{ \
+  size_t position = prefix##LowerBound(queue,value); \
+  Type *elements = queue->elements + queue->first; \
+  while(position < queue->count && compare(&elements[position],value) == 0 && compareNode(&elements[position],value) != 0) \
+  { \
+    position++; \
+  } \
+  if(position == queue->count || compare(&elements[position],value) != 0) \
+  { \
+    return -1; \
+  } \
+  if(position < queue->count/2) \
+  { \
+    memmove(elements + 1,elements,sizeof(Type)*position); \
+    queue->first++; \
+  } \
+  else \
+  { \
+    memmove(elements + position,elements + position + 1,sizeof(Type)*(queue->count - position - 1)); \
+  } \
+  queue->count--; \
+  if(queue->count == 0) \
+  { \
+    queue->first = 0; \
+  } \
+  return EXIT_SUCCESS; \
+}
+
+/**Function to compare the arrival of two cars, the compare of CarTimeQueue.
+*@param first a car
+*@param second a car
+*@return negative when first arrives earlier, 0 at the same time, positive when later
+**/
+static inline int compareCarTimes(const Data *first, const Data *second)
+{
+  return (first->timeOfArrival > second->timeOfArrival) - (first->timeOfArrival < second->timeOfArrival);
+}
+
+/**Function to tell whether two cars are the same car, the compareNode of CarTimeQueue, like compareDataFunction.
+*@param first a car
+*@param second a car
+*@return 0 when they arrive at the same time from the same direction making the same turn, 1 otherwise
+**/
+static inline int compareSameCar(const Data *first, const Data *second)
+{
+  return !(first->timeOfArrival == second->timeOfArrival && first->travelDirection == second->travelDirection && first->turnDirection == second->turnDirection);
+}
+
+//cars by value sorted by time of arrival, in the order insertSorted keeps a List of cars
+DEFINE_TYPED_QUEUE(CarTimeQueue, carTimeQueue, Data, compareCarTimes, compareSameCar)
+
+#endif
@@ -1,5 +1,107 @@
 #ifndef MAIN_H_INCLUDED
 #define MAIN_H_INCLUDED
+#include "Queue.h"
+#include "Arena.h"
+#include "Output.h"
+#include "Intersection.h"
+#include "Generator.h"
+/**Function to read a car data file into a list sorted by arrival time.
+ *@pre arena must exist, the cars and the list nodes are allocated from it
+ *@param fileName path of the car data file
+ *@param config the junction, only cars of its approaches are read
+ *@param arena where the cars and nodes are allocated
+ *@param echo where every car is printed as it is read, NULL to print nothing
+ *@return the sorted list, NULL if the file could not be opened or memory could not be allocated
+ **/
+List *readCarFile(const char *fileName, IntersectionConfig *config, Arena *arena, OutputBuffer *echo);
+/**Function to simulate a car data file into a writer, printing the cars read, the sorted list and the simulation.
+ *@param fileName path of the car data file
+ *@param config the junction
+ *@param output where the results are written
+ *@param mode OUTPUT_CARS to print everything, OUTPUT_SUMMARY or OUTPUT_MACHINE to print only the summary
+ *@param stats where the counts and waits of the run are left, may be NULL
+ *@return exit status for main
+ **/
+int simulateCarFile(const char *fileName, IntersectionConfig *config, OutputBuffer *output, int mode, IntersectionStats *stats);
+/**Function to simulate a car data file, printing the cars read, the sorted list and the simulation.
+ *@param fileName path of the car data file
+ *@param config the junction
+ *@param mode OUTPUT_CARS to print everything, OUTPUT_SUMMARY or OUTPUT_MACHINE to print only the summary
+ *@return exit status for main
+ **/
+int runCarFile(const char *fileName, IntersectionConfig *config, int mode);
+/**Function to simulate a binary trace file straight from its columns into a writer.
+ *@param fileName path of the trace file
+ *@param config the junction
+ *@param output where the results are written
+ *@param mode one of OUTPUT_CARS, OUTPUT_SUMMARY, OUTPUT_MACHINE
+ *@param stats where the counts and waits of the run are left, may be NULL
+ *@return exit status for main
+ **/
+int simulateTraceFile(const char *fileName, IntersectionConfig *config, OutputBuffer *output, int mode, IntersectionStats *stats);
+/**Function to simulate a binary trace file straight from its columns.
+ *@param fileName path of the trace file
+ *@param config the junction
+ *@param mode one of OUTPUT_CARS, OUTPUT_SUMMARY, OUTPUT_MACHINE
+ *@return exit status for main
+ **/
+int runTraceFile(const char *fileName, IntersectionConfig *config, int mode);
+/**Function to simulate a car data file that is sorted by time of arrival while it is read, without loading it.
+ *@param fileName path of the car data file
+ *@param config the junction
+ *@param mode one of OUTPUT_CARS, OUTPUT_SUMMARY, OUTPUT_MACHINE
+ *@return exit status for main
+ **/
+int runStreamFile(const char *fileName, IntersectionConfig *config, int mode);
+/**Function to simulate the cars added to a growing car data file since its last refresh, see refreshStream.
+ *@param fileName path of the car data file, sorted by time of arrival
+ *@param config the junction
+ *@param mode one of OUTPUT_CARS, OUTPUT_SUMMARY, OUTPUT_MACHINE
+ *@param stateFile where the state is kept from one refresh to the next
+ *@param final 1 when no more cars will be added to the file, 0 otherwise
+ *@return exit status for main
+ **/
+int runIncrementalFile(const char *fileName, IntersectionConfig *config, int mode, const char *stateFile, int final);
+/**Function to convert a car data file into a sorted binary trace file.
+ *@param carFileName path of the car data file to read
+ *@param traceFileName path of the trace file to write
+ *@param config the junction, only cars of its approaches are converted
+ *@return exit status for main
+ **/
+int convertCarFile(const char *carFileName, const char *traceFileName, IntersectionConfig *config);
+/**Function to simulate a network of intersections with the cars entering it.
+ *@param networkFileName path of the network file, see readNetwork
+ *@param entriesFileName path of the file of cars entering the network, see readNetworkEntries
+ *@param config layout of every intersection of the network
+ *@param mode OUTPUT_CARS for a line per intersection and the totals, OUTPUT_SUMMARY or OUTPUT_MACHINE for the totals
+ *@return exit status for main
+ **/
+int runNetworkFile(const char *networkFileName, const char *entriesFileName, IntersectionConfig *config, int mode);
+/**Function to simulate every file of a directory or manifest on all cores, printing the results of each file
+ *in order and the totals of the batch.
+ *@param path directory of car data files and traces, or a manifest listing them
+ *@param config the junction every file is simulated with
+ *@param threadCount number of threads, 0 for one per processor
+ *@param mode one of OUTPUT_CARS, OUTPUT_SUMMARY, OUTPUT_MACHINE
+ *@return exit status for main, 1 when any file could not be simulated
+ **/
+int runBatchPath(const char *path, IntersectionConfig *config, int threadCount, int mode);
+/**Function to write one replicate of the generator as a car data file sorted by time of arrival.
+ *@param fileName path of the car data file to write
+ *@param settings what the cars look like
+ *@param config the junction
+ *@return exit status for main
+ **/
+int generateCarFile(const char *fileName, const GeneratorConfig *settings, IntersectionConfig *config);
+/**Function to simulate replicates of the generator on all cores and print the spread of their results.
+ *@param settings what the cars look like, replicate r uses the seed and r
+ *@param config the junction
+ *@param replicates number of replicates
+ *@param threadCount number of threads, 0 for one per processor
+ *@param mode OUTPUT_MACHINE for one JSON line, a table otherwise
+ *@return exit status for main
+ **/
+int runMonteCarlo(const GeneratorConfig *settings, IntersectionConfig *config, size_t replicates, int threadCount, int mode);
 /**Function to print a character.
  *@pre must be a character
  *@param toBePrinted
@@ -0,0 +1,190 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include "../include/Arena.h"
+
+//bytes at the start of a block used by its header, rounded so the first allocation is aligned
+#define ARENA_HEADER_SIZE ((sizeof(ArenaBlock) + ARENA_ALIGNMENT - 1) & ~(size_t)(ARENA_ALIGNMENT - 1))
+
+/**Function to round a request up to the arena's alignment.
+*@param size number of bytes asked for
+*@return size rounded up to a multiple of ARENA_ALIGNMENT
+**/
+static size_t alignSize(size_t size)
+{
+  if(size == 0)
+  {
+    size = 1;
+  }
+  return (size + ARENA_ALIGNMENT - 1) & ~(size_t)(ARENA_ALIGNMENT - 1);
+}
+
+/**Allocator hook wrapping arenaAllocate.
+*@param context the arena
+*@param size number of bytes needed
+**/
+static void *allocateHook(void *context, size_t size)
+{
+  return arenaAllocate(context,size);
+}
+
+/**Allocator hook wrapping arenaRelease.
+*@param context the arena
+*@param toBeReleased memory that is no longer used
+*@param size number of bytes that were asked for
+**/
+static void releaseHook(void *context, void *toBeReleased, size_t size)
+{
+  arenaRelease(context,toBeReleased,size);
+}
+
+/**Function to create an empty arena.
+*@return pointer to the arena, NULL if memory could not be allocated
+*@param blockSize bytes in each block the arena reserves, 0 for ARENA_DEFAULT_BLOCK_SIZE
+**/
+Arena *initializeArena(size_t blockSize)
+{
+  //creating new arena and allocating space for arena
+  Arena *newArena = malloc(sizeof(Arena)*1);
+  if(newArena == NULL)
+  {
+    return NULL;
+  }
+
+  //initializing arena elements
+  newArena->blocks = NULL;
+  newArena->blockSize = (blockSize == 0) ? ARENA_DEFAULT_BLOCK_SIZE : blockSize;
+  for(int i = 0; i < ARENA_SIZE_CLASSES; i++)
+  {
+    newArena->freeLists[i] = NULL;
+  }
+  newArena->allocations = 0;
+  newArena->bytesUsed = 0;
+  newArena->bytesReserved = 0;
+  newArena->allocator.allocate = allocateHook;
+  newArena->allocator.release = releaseHook;
+  newArena->allocator.context = newArena;
+  newArena->allocator.freesInBulk = 1;
+
+  return newArena;
+}
+
+/**Function to get memory from the arena. This has a big O notation of 1.
+*@pre arena must exist
+*@return pointer to size bytes aligned to ARENA_ALIGNMENT, NULL if memory could not be allocated
+*@param arena the arena to allocate from
+*@param size number of bytes needed
+**/
+void *arenaAllocate(Arena *arena, size_t size)
+{
+  if(arena == NULL)
+  {
+    return NULL;
+  }
+
+  size_t alignedSize = alignSize(size);
+  size_t sizeClass = alignedSize/ARENA_ALIGNMENT - 1;
+
+  arena->allocations++;
+  arena->bytesUsed = arena->bytesUsed + alignedSize;
+
+  //reusing released memory of the same size first
+  if(sizeClass < ARENA_SIZE_CLASSES && arena->freeLists[sizeClass] != NULL)
+  {
+    void *reused = arena->freeLists[sizeClass];
+    arena->freeLists[sizeClass] = *(void **)reused;
+    return reused;
+  }
+
+  //starting a new block when the current one is full, large requests get a block of their own
+  ArenaBlock *block = arena->blocks;
+  if(block == NULL || block->size - block->used < alignedSize)
+  {
+    size_t newBlockSize = arena->blockSize;
+    if(newBlockSize < ARENA_HEADER_SIZE + alignedSize)
+    {
+      newBlockSize = ARENA_HEADER_SIZE + alignedSize;
+    }
+
+    block = malloc(newBlockSize);
+    if(block == NULL)
+    {
+      arena->allocations--;
+      arena->bytesUsed = arena->bytesUsed - alignedSize;
+      return NULL;
+    }
+    block->size = newBlockSize;
+    block->used = ARENA_HEADER_SIZE;
+    block->next = arena->blocks;
+    arena->blocks = block;
+    arena->bytesReserved = arena->bytesReserved + newBlockSize;
+  }
+
+  void *memory = (char *)block + block->used;
+  block->used = block->used + alignedSize;
+  return memory;
+}
+
+/**Function to give memory back to the arena so a later allocation of the same size can reuse it.
+*@pre toBeReleased must have come from arenaAllocate on this arena with the same size
+*@param arena the arena the memory came from
+*@param toBeReleased memory that is no longer used
+*@param size number of bytes that were asked for
+**/
+void arenaRelease(Arena *arena, void *toBeReleased, size_t size)
+{
+  if(arena == NULL || toBeReleased == NULL)
+  {
+    return;
+  }
+
+  size_t alignedSize = alignSize(size);
+  size_t sizeClass = alignedSize/ARENA_ALIGNMENT - 1;
+
+  arena->bytesUsed = arena->bytesUsed - alignedSize;
+
+  //large allocations are only given back when the arena is deleted
+  if(sizeClass < ARENA_SIZE_CLASSES)
+  {
+    *(void **)toBeReleased = arena->freeLists[sizeClass];
+    arena->freeLists[sizeClass] = toBeReleased;
+  }
+}
+
+/**Function to get the list allocator hooks for the arena, lists using them free their nodes in O(1).
+*@pre arena must exist
+*@return allocator to pass to initializeListWithAllocator, it lives as long as the arena
+*@param arena the arena the nodes will come from
+**/
+Allocator *arenaAllocator(Arena *arena)
+{
+  if(arena == NULL)
+  {
+    return NULL;
+  }
+  return &arena->allocator;
+}
+
+/**Function to free every block of the arena along with the arena itself. This has a big O notation of blocks, not allocations.
+*@post every pointer handed out by the arena is invalid
+*@param arena the arena to be deleted
+**/
+void deleteArena(Arena *arena)
+{
+  //check if arena exists
+  if(arena == NULL)
+  {
+    return;
+  }
+
+  //free each block
+  ArenaBlock *blockHolder;
+  while(arena->blocks != NULL)
+  {
+    blockHolder = arena->blocks;
+    arena->blocks = arena->blocks->next;
+    free(blockHolder);
+  }
+
+  //free the arena itself
+  free(arena);
+}
@@ -0,0 +1,485 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <dirent.h>
+#include <sys/stat.h>
+#include "../include/Batch.h"
+#include "../include/ThreadPool.h"
+#include "../include/Trace.h"
+#include "../include/main.h"
+#include "../include/Counters.h"
+
+/**Function to tell whether a file is a binary trace by its first bytes.
+*@param fileName path of the file
+*@return 1 for a trace, 0 for anything else
+**/
+static int isTraceFile(const char *fileName)
+{
+  char magic[sizeof(TRACE_MAGIC) - 1];
+  FILE *fp = fopen(fileName,"rb");
+  int isTrace = 0;
+
+  if(fp != NULL)
+  {
+    isTrace = (fread(magic,1,sizeof(magic),fp) == sizeof(magic) && memcmp(magic,TRACE_MAGIC,sizeof(magic)) == 0);
+    fclose(fp);
+  }
+  return isTrace;
+}
+
+/**Function to add a file to the end of a batch.
+*@param batch the batch
+*@param capacity number of jobs that fit, updated when the jobs grow
+*@param fileName path of the file, it is copied
+*@return EXIT_SUCCESS on success, EXIT_FAILURE if memory could not be allocated
+**/
+static int addJob(Batch *batch, size_t *capacity, const char *fileName)
+{
+  if(batch->count == *capacity)
+  {
+    size_t newCapacity = (*capacity == 0) ? 64 : *capacity*2;
+    BatchJob *newJobs = realloc(batch->jobs,sizeof(BatchJob)*newCapacity);
+    if(newJobs == NULL)
+    {
+      return EXIT_FAILURE;
+    }
+    batch->jobs = newJobs;
+    *capacity = newCapacity;
+  }
+
+  BatchJob *job = &batch->jobs[batch->count];
+  job->fileName = malloc(strlen(fileName) + 1);
+  if(job->fileName == NULL)
+  {
+    return EXIT_FAILURE;
+  }
+  strcpy(job->fileName,fileName);
+  job->batch = batch;
+  job->isTrace = 0;
+  job->failed = 0;
+  job->done = 0;
+  job->output = NULL;
+  memset(&job->stats,0,sizeof(IntersectionStats));
+  batch->count++;
+  return EXIT_SUCCESS;
+}
+
+/**Function to compare two names for sorting the files of a directory.
+*@param first pointer to the first name
+*@param second pointer to the second name
+**/
+static int compareNames(const void *first, const void *second)
+{
+  return strcmp(*(char *const *)first,*(char *const *)second);
+}
+
+/**Function to add every file of a directory to a batch, in order of name.
+*@param batch the batch
+*@param capacity number of jobs that fit, updated when the jobs grow
+*@param path the directory
+*@return EXIT_SUCCESS on success, EXIT_FAILURE if the directory could not be read
+**/
+static int addDirectory(Batch *batch, size_t *capacity, const char *path)
+{
+  DIR *directory = opendir(path);
+  struct dirent *entry;
+  char **names = NULL;
+  size_t nameCount = 0;
+  size_t nameCapacity = 0;
+  int result = EXIT_SUCCESS;
+
+  if(directory == NULL)
+  {
+    return EXIT_FAILURE;
+  }
+
+  while(result == EXIT_SUCCESS && (entry = readdir(directory)) != NULL)
+  {
+    struct stat status;
+    if(entry->d_name[0] == '.')
+    {
+      continue;
+    }
+
+    char *name = malloc(strlen(path) + strlen(entry->d_name) + 2);
+    if(name == NULL)
+    {
+      result = EXIT_FAILURE;
+      break;
+    }
+    sprintf(name,"%s/%s",path,entry->d_name);
+    if(stat(name,&status) != 0 || !S_ISREG(status.st_mode))
+    {
+      free(name);
+      continue;
+    }
+
+    if(nameCount == nameCapacity)
+    {
+      nameCapacity = (nameCapacity == 0) ? 64 : nameCapacity*2;
+      char **newNames = realloc(names,sizeof(char *)*nameCapacity);
+      if(newNames == NULL)
+      {
+        free(name);
+        result = EXIT_FAILURE;
+        break;
+      }
+      names = newNames;
+    }
+    names[nameCount++] = name;
+  }
+  closedir(directory);
+
+  //readdir gives no order, sorting keeps the output the same from run to run
+  if(nameCount > 0)
+  {
+    qsort(names,nameCount,sizeof(char *),compareNames);
+  }
+  for(size_t i = 0; i < nameCount; i++)
+  {
+    if(result == EXIT_SUCCESS)
+    {
+      result = addJob(batch,capacity,names[i]);
+    }
+    free(names[i]);
+  }
+  free(names);
+  return result;
+}
+
+/**Function to add the files listed in a manifest to a batch.
+*@param batch the batch
+*@param capacity number of jobs that fit, updated when the jobs grow
+*@param path the manifest
+*@return EXIT_SUCCESS on success, EXIT_FAILURE if the manifest could not be read
+**/
+static int addManifest(Batch *batch, size_t *capacity, const char *path)
+{
+  char line[4096];
+  FILE *fp = fopen(path,"r");
+  int result = EXIT_SUCCESS;
+
+  if(fp == NULL)
+  {
+    return EXIT_FAILURE;
+  }
+
+  while(result == EXIT_SUCCESS && fgets(line,sizeof(line),fp) != NULL)
+  {
+    char *start = line;
+    char *end = line + strlen(line);
+    while(*start == ' ' || *start == '\t')
+    {
+      start++;
+    }
+    while(end > start && (end[-1] == '\n' || end[-1] == '\r' || end[-1] == ' ' || end[-1] == '\t'))
+    {
+      end--;
+    }
+    *end = '\0';
+    if(*start == '\0' || *start == '#')
+    {
+      continue;
+    }
+    result = addJob(batch,capacity,start);
+  }
+  fclose(fp);
+  return result;
+}
+
+/**Function to list the files of a batch. A directory gives every file in it in order of name, anything else is read
+*as a manifest with one path per line, blank lines and lines starting with # are skipped. Binary traces are told
+*apart from car data files by their first bytes.
+*@return the batch, NULL if the path could not be read or memory could not be allocated
+*@param path directory or manifest
+*@param config the junction every file is simulated with, it must live as long as the batch
+*@param mode one of OUTPUT_CARS, OUTPUT_SUMMARY, OUTPUT_MACHINE, used for every file
+**/
+Batch *readBatch(const char *path, IntersectionConfig *config, int mode)
+{
+  struct stat status;
+  size_t capacity = 0;
+  int result;
+
+  if(path == NULL || stat(path,&status) != 0)
+  {
+    return NULL;
+  }
+
+  Batch *newBatch = malloc(sizeof(Batch)*1);
+  if(newBatch == NULL)
+  {
+    return NULL;
+  }
+  newBatch->jobs = NULL;
+  newBatch->count = 0;
+  newBatch->config = config;
+  newBatch->mode = mode;
+  newBatch->histograms = NULL;
+  pthread_mutex_init(&newBatch->lock,NULL);
+  pthread_cond_init(&newBatch->jobDone,NULL);
+
+  if(S_ISDIR(status.st_mode))
+  {
+    result = addDirectory(newBatch,&capacity,path);
+  }
+  else
+  {
+    result = addManifest(newBatch,&capacity,path);
+  }
+  if(result == EXIT_SUCCESS && config->percentiles)
+  {
+    newBatch->histograms = initializeWaitHistograms();
+    result = (newBatch->histograms == NULL) ? EXIT_FAILURE : EXIT_SUCCESS;
+  }
+  if(result != EXIT_SUCCESS)
+  {
+    deleteBatch(newBatch);
+    return NULL;
+  }
+  return newBatch;
+}
+
+/**Task run on the pool for one file, the results stay in the job until they are printed. The histograms of the file
+*are added to those of the batch and freed straight away, so only the running files hold any.
+*@param argument the BatchJob
+**/
+static void runBatchJob(void *argument)
+{
+  BatchJob *job = argument;
+  Batch *batch = job->batch;
+
+  job->isTrace = isTraceFile(job->fileName);
+  job->output = initializeOutput(NULL,64*1024);
+  if(job->output == NULL)
+  {
+    job->failed = 1;
+  }
+  else if(job->isTrace)
+  {
+    job->failed = simulateTraceFile(job->fileName,batch->config,job->output,batch->mode,&job->stats);
+  }
+  else
+  {
+    job->failed = simulateCarFile(job->fileName,batch->config,job->output,batch->mode,&job->stats);
+  }
+
+  pthread_mutex_lock(&batch->lock);
+  mergeWaitHistograms(batch->histograms,job->stats.histograms);
+  deleteWaitHistograms(job->stats.histograms);
+  job->stats.histograms = NULL;
+  job->done = 1;
+  pthread_cond_broadcast(&batch->jobDone);
+  pthread_mutex_unlock(&batch->lock);
+}
+
+/**Function to write a string as a JSON string.
+*@param output where the string goes
+*@param text the string
+**/
+static void writeJSONString(OutputBuffer *output, const char *text)
+{
+  writeChar(output,'"');
+  for(; *text != '\0'; text++)
+  {
+    if(*text == '"' || *text == '\\')
+    {
+      writeChar(output,'\\');
+    }
+    writeChar(output,((unsigned char)*text < ' ') ? '?' : *text);
+  }
+  writeChar(output,'"');
+}
+
+/**Function to print the results of one file of a batch, the same text a run over the file alone prints.
+*@param output where the results go
+*@param mode OUTPUT_MACHINE puts the file name into the JSON line, the other modes print a header line
+*@param job the file
+**/
+static void printJob(OutputBuffer *output, int mode, BatchJob *job)
+{
+  const char *text = (job->output == NULL) ? "" : job->output->buffer;
+  size_t length = (job->output == NULL) ? 0 : job->output->used;
+
+  if(mode == OUTPUT_MACHINE)
+  {
+    writeText(output,"{\"file\":");
+    writeJSONString(output,job->fileName);
+    if(job->failed || length < 2 || text[0] != '{')
+    {
+      writeText(output,",\"error\":\"could not be simulated\"}\n");
+      return;
+    }
+    //the JSON of the file without its opening brace
+    writeChar(output,',');
+    text++;
+    length--;
+  }
+  else
+  {
+    writeText(output,"==> ");
+    writeText(output,job->fileName);
+    writeText(output,job->failed ? " <== could not be simulated\n" : " <==\n");
+  }
+
+  flushOutput(output);
+  fwrite(text,1,length,output->fp);
+  if(mode != OUTPUT_MACHINE)
+  {
+    writeChar(output,'\n');
+  }
+}
+
+/**Function to simulate every file of a batch on a work stealing thread pool. The results of each file are the same
+*as a run over that file alone and are printed in the order of the batch, followed by the totals of all files. The
+*threads, tasks stolen and time taken are printed to stderr.
+*@pre batch must exist
+*@return the number of files that could not be simulated
+*@param batch the batch
+*@param threadCount number of threads, 0 for one per processor
+*@param output where the results are written, it is flushed before returning
+**/
+size_t runBatch(Batch *batch, int threadCount, OutputBuffer *output)
+{
+  double start = monotonicSeconds();
+  size_t failed = 0;
+  size_t cars = 0;
+  SimTime totalWait = 0;
+  SimTime maxWaitTime = 0;
+  const char *maxWaitFile = NULL;
+  size_t steals = 0;
+
+  ThreadPool *pool = initializeThreadPool(threadCount);
+  if(pool == NULL)
+  {
+    fprintf(stderr,"could not start the threads of the batch\n");
+    return batch->count;
+  }
+  threadCount = pool->threadCount;
+
+  for(size_t i = 0; i < batch->count; i++)
+  {
+    if(submitTask(pool,runBatchJob,&batch->jobs[i]) != EXIT_SUCCESS)
+    {
+      //running it here keeps the batch complete when the pool can not take more tasks
+      runBatchJob(&batch->jobs[i]);
+    }
+  }
+
+  //printing each file as soon as it and every file before it are done, then freeing its text
+  for(size_t i = 0; i < batch->count; i++)
+  {
+    BatchJob *job = &batch->jobs[i];
+    pthread_mutex_lock(&batch->lock);
+    while(!job->done)
+    {
+      pthread_cond_wait(&batch->jobDone,&batch->lock);
+    }
+    pthread_mutex_unlock(&batch->lock);
+
+    printJob(output,batch->mode,job);
+    deleteOutput(job->output);
+    job->output = NULL;
+
+    if(job->failed)
+    {
+      failed++;
+      continue;
+    }
+    for(int j = 0; j < job->stats.approaches; j++)
+    {
+      cars = cars + job->stats.amount[j];
+      totalWait = totalWait + job->stats.totalWait[j];
+    }
+    if(maxWaitFile == NULL || job->stats.maxWaitTime > maxWaitTime)
+    {
+      maxWaitTime = job->stats.maxWaitTime;
+      maxWaitFile = job->fileName;
+    }
+  }
+  steals = pool->steals;
+  deleteThreadPool(pool);
+  double seconds = monotonicSeconds() - start;
+
+  if(batch->mode == OUTPUT_MACHINE)
+  {
+    writeText(output,"{\"files\":");
+    writeUnsigned(output,batch->count);
+    writeText(output,",\"failed\":");
+    writeUnsigned(output,failed);
+    writeText(output,",\"cars\":");
+    writeUnsigned(output,cars);
+    writeText(output,",\"averageWait\":");
+    if(cars != 0)
+    {
+      writeAverageTime(output,totalWait,cars,0,2);
+    }
+    else
+    {
+      writeText(output,"null");
+    }
+    writeText(output,",\"maxWait\":");
+    writeTime(output,maxWaitTime,0,2);
+    writeText(output,",\"maxWaitFile\":");
+    if(maxWaitFile != NULL)
+    {
+      writeJSONString(output,maxWaitFile);
+    }
+    else
+    {
+      writeText(output,"null");
+    }
+    printWaitPercentiles(output,batch->mode,batch->config,batch->histograms);
+    writeText(output,"}\n");
+  }
+  else
+  {
+    writeText(output,"Batch of ");
+    writeUnsigned(output,batch->count);
+    writeText(output," files, ");
+    writeUnsigned(output,failed);
+    writeText(output," could not be simulated\ncars:");
+    writeUnsigned(output,cars);
+    writeChar(output,'\n');
+    if(cars != 0)
+    {
+      writeText(output,"average wait time:");
+      writeAverageTime(output,totalWait,cars,6,2);
+      writeChar(output,'\n');
+    }
+    if(maxWaitFile != NULL)
+    {
+      writeText(output,"Max wait time:");
+      writeTime(output,maxWaitTime,6,2);
+      writeText(output," in ");
+      writeText(output,maxWaitFile);
+      writeChar(output,'\n');
+    }
+    printWaitPercentiles(output,batch->mode,batch->config,batch->histograms);
+  }
+  flushOutput(output);
+  //how the run went changes from run to run, it goes to stderr so the results stay the same
+  fprintf(stderr,"threads:%d, tasks stolen:%zu, seconds:%.3f\n",threadCount,steals,seconds);
+  return failed;
+}
+
+/**Function to free a batch and the results of its files.
+*@param batch the batch to be deleted
+**/
+void deleteBatch(Batch *batch)
+{
+  if(batch == NULL)
+  {
+    return;
+  }
+  for(size_t i = 0; i < batch->count; i++)
+  {
+    deleteOutput(batch->jobs[i].output);
+    free(batch->jobs[i].fileName);
+  }
+  free(batch->jobs);
+  deleteWaitHistograms(batch->histograms);
+  pthread_cond_destroy(&batch->jobDone);
+  pthread_mutex_destroy(&batch->lock);
+  free(batch);
+}
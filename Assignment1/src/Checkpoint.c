@@ -0,0 +1,273 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../include/Checkpoint.h"
+
+/**Function to fill in the header describing a run.
+*@param header the header
+*@param config the junction of the run
+*@param mode the output of the run
+**/
+static void describeRun(CheckpointHeader *header, IntersectionConfig *config, int mode)
+{
+  memset(header,0,sizeof(CheckpointHeader));
+  memcpy(header->magic,CHECKPOINT_MAGIC,8);
+  header->version = CHECKPOINT_VERSION;
+  header->byteOrder = CHECKPOINT_BYTE_ORDER;
+  header->timeUnits = TIME_UNITS_PER_SECOND;
+  header->stateSize = sizeof(EngineState);
+  header->mode = mode;
+  header->approaches = config->approaches;
+  header->yieldToRight = config->yieldToRight;
+  header->shareBox = config->shareBox;
+  header->percentiles = config->percentiles;
+  //only the approaches in use, the rest of the arrays stay 0 whatever the config holds there
+  for(int i = 0; i < config->approaches; i++)
+  {
+    header->rank[i] = config->rank[i];
+    header->directions[i] = config->directions[i];
+  }
+}
+
+/**Function to allocate the state of a run that has not started, with empty totals and no cars taken.
+*@return the state, NULL if memory could not be allocated
+*@param config the junction of the run, histograms are allocated when it has percentiles set
+**/
+EngineState *initializeEngineState(IntersectionConfig *config)
+{
+  EngineState *newState = malloc(sizeof(EngineState)*1);
+  if(newState == NULL)
+  {
+    return NULL;
+  }
+  clearEngineState(newState,config);
+  return newState;
+}
+
+/**Function to clear the state of a run that has not started, with empty totals and no cars taken.
+*@param state the state
+*@param config the junction of the run, histograms are allocated when it has percentiles set
+**/
+void clearEngineState(EngineState *state, IntersectionConfig *config)
+{
+  //cleared as a whole so a checkpoint of the state is the same bytes every time
+  memset(state,0,sizeof(EngineState));
+  state->pendingUntil = INT64_MAX;
+  state->totals.approaches = config->approaches;
+  for(int i = 0; i < config->approaches; i++)
+  {
+    state->totals.minWait[i] = INT64_MAX;
+  }
+  state->totals.histograms = config->percentiles ? initializeWaitHistograms() : NULL;
+}
+
+/**Function to give a histogram of a set by its number in a checkpoint.
+*@param histograms the set
+*@param histogram the approach, or INTERSECTION_MAX_APPROACHES plus the turn
+*@return the histogram
+**/
+static WaitHistogram *histogramOf(WaitHistograms *histograms, uint32_t histogram)
+{
+  if(histogram < INTERSECTION_MAX_APPROACHES)
+  {
+    return &histograms->approach[histogram];
+  }
+  return &histograms->turn[histogram - INTERSECTION_MAX_APPROACHES];
+}
+
+/**Function to write the buckets of the histograms that are not empty.
+*@return EXIT_SUCCESS on success, EXIT_FAILURE if the file could not be written
+*@param fp file being written, NULL to only count the buckets
+*@param histograms the histograms, may be NULL
+*@param count set to the number of buckets
+**/
+static int writeBuckets(FILE *fp, WaitHistograms *histograms, uint64_t *count)
+{
+  uint64_t written = 0;
+  if(histograms == NULL)
+  {
+    *count = 0;
+    return EXIT_SUCCESS;
+  }
+  for(uint32_t h = 0; h < INTERSECTION_MAX_APPROACHES + INTERSECTION_TURNS; h++)
+  {
+    WaitHistogram *histogram = histogramOf(histograms,h);
+    for(uint32_t i = 0; histogram->count != 0 && i < HISTOGRAM_BUCKETS; i++)
+    {
+      if(histogram->buckets[i] == 0)
+      {
+        continue;
+      }
+      CheckpointBucket bucket;
+      bucket.histogram = h;
+      bucket.bucket = i;
+      bucket.count = histogram->buckets[i];
+      bucket.longest = histogram->longest[i];
+      if(fp != NULL && fwrite(&bucket,sizeof(CheckpointBucket),1,fp) != 1)
+      {
+        return EXIT_FAILURE;
+      }
+      written++;
+    }
+  }
+  *count = written;
+  return EXIT_SUCCESS;
+}
+
+/**Function to save the state of a run. The file is written under another name first and then renamed, so a run
+*killed while saving leaves the previous checkpoint as it was.
+*@return EXIT_SUCCESS on success, EXIT_FAILURE if the file could not be written
+*@param fileName path of the checkpoint
+*@param config the junction of the run
+*@param mode the output of the run, one of OUTPUT_CARS, OUTPUT_SUMMARY, OUTPUT_MACHINE
+*@param state the state, with every wait added to its totals
+*@param section more state written after the state of the run, may be NULL
+**/
+int writeCheckpoint(const char *fileName, IntersectionConfig *config, int mode, EngineState *state, CheckpointSection *section)
+{
+  CheckpointHeader header;
+  EngineState saved = *state;
+  uint64_t written = 0;
+  size_t length = strlen(fileName);
+  char *partName = malloc(length + 6);
+  if(partName == NULL)
+  {
+    return EXIT_FAILURE;
+  }
+  memcpy(partName,fileName,length);
+  memcpy(partName + length,".part",6);
+
+  describeRun(&header,config,mode);
+  writeBuckets(NULL,state->totals.histograms,&header.buckets);
+  saved.totals.histograms = NULL;
+  saved.rollup = NULL;
+
+  int result = EXIT_FAILURE;
+  FILE *fp = fopen(partName,"wb");
+  if(fp != NULL)
+  {
+    if(fwrite(&header,sizeof(CheckpointHeader),1,fp) == 1 && fwrite(&saved,sizeof(EngineState),1,fp) == 1
+       && writeBuckets(fp,state->totals.histograms,&written) == EXIT_SUCCESS && written == header.buckets
+       && (section == NULL || section->write(fp,section->context) == EXIT_SUCCESS))
+    {
+      result = EXIT_SUCCESS;
+    }
+    if(fclose(fp) != 0)
+    {
+      result = EXIT_FAILURE;
+    }
+  }
+#ifdef _WIN32
+  //rename does not replace a file that is already there on Windows
+  if(result == EXIT_SUCCESS)
+  {
+    remove(fileName);
+  }
+#endif
+  if(result == EXIT_SUCCESS && rename(partName,fileName) != 0)
+  {
+    result = EXIT_FAILURE;
+  }
+  if(result != EXIT_SUCCESS)
+  {
+    remove(partName);
+  }
+  free(partName);
+  return result;
+}
+
+/**Function to load the state of a run, checking it was taken from a run with the same junction and output.
+*@return the state, NULL if the file could not be read or is from another run, the reason is printed on stderr
+*@param fileName path of the checkpoint
+*@param config the junction the run is resumed with
+*@param mode the output the run is resumed with
+*@param section reads the state written after the state of the run, may be NULL
+**/
+EngineState *readCheckpoint(const char *fileName, IntersectionConfig *config, int mode, CheckpointSection *section)
+{
+  CheckpointHeader header;
+  CheckpointHeader expected;
+  FILE *fp = fopen(fileName,"rb");
+  if(fp == NULL)
+  {
+    fprintf(stderr,"could not open %s\n",fileName);
+    return NULL;
+  }
+
+  describeRun(&expected,config,mode);
+  if(fread(&header,sizeof(CheckpointHeader),1,fp) != 1 || memcmp(header.magic,CHECKPOINT_MAGIC,8) != 0
+     || header.version != CHECKPOINT_VERSION || header.byteOrder != CHECKPOINT_BYTE_ORDER
+     || header.stateSize != sizeof(EngineState) || header.timeUnits != TIME_UNITS_PER_SECOND)
+  {
+    fprintf(stderr,"%s is not a checkpoint of this build of the program\n",fileName);
+    fclose(fp);
+    return NULL;
+  }
+  expected.buckets = header.buckets;
+  if(memcmp(&header,&expected,sizeof(CheckpointHeader)) != 0)
+  {
+    fprintf(stderr,"%s was taken with other junction or output options than the ones given\n",fileName);
+    fclose(fp);
+    return NULL;
+  }
+
+  EngineState *newState = malloc(sizeof(EngineState)*1);
+  if(newState == NULL || fread(newState,sizeof(EngineState),1,fp) != 1)
+  {
+    fprintf(stderr,"%s is cut short or damaged\n",fileName);
+    free(newState);
+    fclose(fp);
+    return NULL;
+  }
+  newState->failed = 0;
+  newState->rollup = NULL;
+  newState->totals.histograms = config->percentiles ? initializeWaitHistograms() : NULL;
+  int failed = (config->percentiles && newState->totals.histograms == NULL);
+  for(uint64_t i = 0; !failed && i < header.buckets; i++)
+  {
+    CheckpointBucket bucket;
+    failed = (fread(&bucket,sizeof(CheckpointBucket),1,fp) != 1 || newState->totals.histograms == NULL
+              || bucket.histogram >= INTERSECTION_MAX_APPROACHES + INTERSECTION_TURNS || bucket.bucket >= HISTOGRAM_BUCKETS);
+    if(!failed)
+    {
+      //the count and the longest wait of a histogram are the sum of its buckets and the longest of their waits
+      WaitHistogram *histogram = histogramOf(newState->totals.histograms,bucket.histogram);
+      histogram->buckets[bucket.bucket] = bucket.count;
+      histogram->longest[bucket.bucket] = bucket.longest;
+      if(histogram->count == 0 || bucket.longest > histogram->highest)
+      {
+        histogram->highest = bucket.longest;
+      }
+      histogram->count = histogram->count + bucket.count;
+    }
+  }
+  if(failed)
+  {
+    fprintf(stderr,"%s is cut short or damaged\n",fileName);
+  }
+  //the section says itself what is wrong with what it reads
+  else if(section != NULL && section->read(fp,section->context) != EXIT_SUCCESS)
+  {
+    failed = 1;
+  }
+  fclose(fp);
+  if(failed)
+  {
+    deleteEngineState(newState);
+    return NULL;
+  }
+  return newState;
+}
+
+/**Function to free a state loaded by readCheckpoint, with its histograms.
+*@param state the state to be deleted, may be NULL
+**/
+void deleteEngineState(EngineState *state)
+{
+  if(state == NULL)
+  {
+    return;
+  }
+  deleteWaitHistograms(state->totals.histograms);
+  free(state);
+}
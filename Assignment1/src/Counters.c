@@ -0,0 +1,129 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <pthread.h>
+#include "../include/Counters.h"
+
+int countersEnabled = 0;
+_Thread_local HotCounters threadCounters;
+
+static HotCounters totals;  //counters of the threads that have finished
+static pthread_mutex_t totalsLock = PTHREAD_MUTEX_INITIALIZER;
+
+static const char *phaseNames[PHASE_COUNT] = {"read","sort","simulate","output"};
+
+/**Function to read the monotonic clock.
+*@return seconds from some fixed point in the past
+**/
+double monotonicSeconds(void)
+{
+#ifdef _WIN32
+  return (double)clock()/CLOCKS_PER_SEC;
+#else
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC,&now);
+  return (double)now.tv_sec + (double)now.tv_nsec/1e9;
+#endif
+}
+
+/**Function to turn the counters on, before any thread that counts is started.
+**/
+void enableCounters(void)
+{
+  countersEnabled = 1;
+}
+
+/**Function to start timing a phase, use START_PHASE.
+*@param timer where the start is kept
+**/
+void startPhase(PhaseTimer *timer)
+{
+  timer->start = monotonicSeconds();
+  timer->nested = threadCounters.phaseSeconds[PHASE_OUTPUT];
+}
+
+/**Function to add the time since startPhase to a phase of this thread, use END_PHASE.
+*@param phase one of PHASE_READ, PHASE_SORT, PHASE_SIMULATE, PHASE_OUTPUT
+*@param timer the timer given to startPhase
+**/
+void endPhase(int phase, PhaseTimer *timer)
+{
+  double elapsed = monotonicSeconds() - timer->start;
+  if(phase != PHASE_OUTPUT)
+  {
+    elapsed = elapsed - (threadCounters.phaseSeconds[PHASE_OUTPUT] - timer->nested);
+  }
+  threadCounters.phaseSeconds[phase] = threadCounters.phaseSeconds[phase] + elapsed;
+}
+
+/**Function to add one set of counters to another, a peak is the larger of the two.
+*@param to the counters added to
+*@param from the counters added
+**/
+static void addCounters(HotCounters *to, const HotCounters *from)
+{
+  to->compares = to->compares + from->compares;
+  to->nodeCompares = to->nodeCompares + from->nodeCompares;
+  to->scans = to->scans + from->scans;
+  to->nodesVisited = to->nodesVisited + from->nodesVisited;
+  to->allocations = to->allocations + from->allocations;
+  to->bytes = to->bytes + from->bytes;
+  to->outputWrites = to->outputWrites + from->outputWrites;
+  to->outputBytes = to->outputBytes + from->outputBytes;
+  to->peakCarsHeld = (from->peakCarsHeld > to->peakCarsHeld) ? from->peakCarsHeld : to->peakCarsHeld;
+  for(int i = 0; i < PHASE_COUNT; i++)
+  {
+    to->phaseSeconds[i] = to->phaseSeconds[i] + from->phaseSeconds[i];
+  }
+}
+
+/**Function to add the counters of the calling thread to the totals and clear them, called by a thread as it finishes.
+**/
+void mergeThreadCounters(void)
+{
+  static const HotCounters empty;
+  if(!countersEnabled)
+  {
+    return;
+  }
+  pthread_mutex_lock(&totalsLock);
+  addCounters(&totals,&threadCounters);
+  pthread_mutex_unlock(&totalsLock);
+  threadCounters = empty;
+}
+
+/**Function to print the totals of every thread that has finished and of the calling thread.
+*@param fp where the summary goes
+**/
+void printCounters(FILE *fp)
+{
+  HotCounters all;
+
+  pthread_mutex_lock(&totalsLock);
+  all = totals;
+  pthread_mutex_unlock(&totalsLock);
+  addCounters(&all,&threadCounters);
+
+  fprintf(fp,"stats:\n");
+#ifdef NO_COUNTERS
+  fprintf(fp,"  built with NO_COUNTERS, nothing was counted\n");
+  return;
+#endif
+  fprintf(fp,"  compare calls:      %llu\n",all.compares);
+  fprintf(fp,"  compareNode calls:  %llu\n",all.nodeCompares);
+  fprintf(fp,"  list scans:         %llu\n",all.scans);
+  fprintf(fp,"  nodes visited:      %llu",all.nodesVisited);
+  if(all.scans > 0)
+  {
+    fprintf(fp," (%.2f per scan)",(double)all.nodesVisited/all.scans);
+  }
+  fprintf(fp,"\n");
+  fprintf(fp,"  allocations:        %llu (%llu bytes)\n",all.allocations,all.bytes);
+  fprintf(fp,"  output writes:      %llu (%llu bytes)\n",all.outputWrites,all.outputBytes);
+  fprintf(fp,"  peak cars held:     %llu\n",all.peakCarsHeld);
+  //threads run their phases side by side, so with several threads these add up to more than the wall time
+  for(int i = 0; i < PHASE_COUNT; i++)
+  {
+    fprintf(fp,"  %-8s phase:     %.6f s\n",phaseNames[i],all.phaseSeconds[i]);
+  }
+}
@@ -0,0 +1,282 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "../include/Generator.h"
+#include "../include/Output.h"
+
+#define SECONDS_PER_HOUR 3600.0
+
+/**Function to scramble a number into a seed, the splitmix64 step.
+*@param value state of the sequence, advanced
+*@return the next number of the sequence
+**/
+static uint64_t splitMix(uint64_t *value)
+{
+  uint64_t z = (*value += 0x9E3779B97F4A7C15ULL);
+  z = (z ^ (z >> 30))*0xBF58476D1CE4E5B9ULL;
+  z = (z ^ (z >> 27))*0x94D049BB133111EBULL;
+  return z ^ (z >> 31);
+}
+
+/**Function to rotate a number left.
+*@param value the number
+*@param shift bits to rotate by, 1 to 63
+**/
+static uint64_t rotateLeft(uint64_t value, int shift)
+{
+  return (value << shift) | (value >> (64 - shift));
+}
+
+/**Function to draw the next number of a xoshiro256** stream.
+*@param state the four words of the stream, advanced
+*@return 64 random bits
+**/
+static uint64_t nextRandom(uint64_t *state)
+{
+  uint64_t result = rotateLeft(state[1]*5,7)*9;
+  uint64_t t = state[1] << 17;
+
+  state[2] ^= state[0];
+  state[3] ^= state[1];
+  state[1] ^= state[2];
+  state[0] ^= state[3];
+  state[2] ^= t;
+  state[3] = rotateLeft(state[3],45);
+  return result;
+}
+
+/**Function to draw a uniform number in [0,1) from the top 53 bits of a stream.
+*@param state the stream
+**/
+static double uniformRandom(uint64_t *state)
+{
+  return (double)(nextRandom(state) >> 11)*(1.0/9007199254740992.0);
+}
+
+/**Function to fill in the default generator, 600 cars an hour on every approach all day, 60% going forward,
+*25% turning right and 15% turning left, for one hour with seed 1.
+*@param settings the generator to fill in
+**/
+void defaultGeneratorConfig(GeneratorConfig *settings)
+{
+  for(int i = 0; i < INTERSECTION_MAX_APPROACHES; i++)
+  {
+    settings->ratePerHour[i] = 600.0;
+  }
+  for(int i = 0; i < GENERATOR_HOURS; i++)
+  {
+    settings->profile[i] = 1.0;
+  }
+  settings->turnWeights[0] = 0.60;
+  settings->turnWeights[1] = 0.25;
+  settings->turnWeights[2] = 0.15;
+  settings->duration = SECONDS_PER_HOUR;
+  settings->seed = 1;
+}
+
+/**Function to read a list of numbers separated by commas, like "600,450,600,300".
+*@param text the list
+*@param values where the numbers are stored
+*@param count number of numbers wanted
+*@return EXIT_SUCCESS when text holds exactly count numbers that are not negative, EXIT_FAILURE otherwise
+**/
+int parseNumberList(const char *text, double *values, int count)
+{
+  const char *position = text;
+
+  for(int i = 0; i < count; i++)
+  {
+    char *end;
+    values[i] = strtod(position,&end);
+    if(end == position || !(values[i] >= 0.0) || isinf(values[i]))
+    {
+      return EXIT_FAILURE;
+    }
+    if(i + 1 < count)
+    {
+      if(*end != ',')
+      {
+        return EXIT_FAILURE;
+      }
+      end++;
+    }
+    position = end;
+  }
+  return (*position == '\0') ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+/**Function to start one replicate of the generator.
+*@pre settings must have a profile and turn weights that are not all 0
+*@param generator the generator to start
+*@param settings what the cars look like, it must live as long as the generator
+*@param config the junction the cars arrive at, the rates are given in the order of its approaches
+*@param replicate number of the replicate, replicates of the same seed give different cars
+**/
+void initializeGenerator(CarGenerator *generator, const GeneratorConfig *settings, IntersectionConfig *config, uint64_t replicate)
+{
+  generator->settings = settings;
+  generator->config = config;
+  generator->carsMade = 0;
+  generator->peakProfile = 0.0;
+  for(int i = 0; i < GENERATOR_HOURS; i++)
+  {
+    if(settings->profile[i] > generator->peakProfile)
+    {
+      generator->peakProfile = settings->profile[i];
+    }
+  }
+
+  //a stream per approach seeded from the seed, the replicate and the approach, so no two of them overlap in practice
+  uint64_t base = settings->seed;
+  base = splitMix(&base) ^ replicate;
+  base = splitMix(&base);
+  for(int a = 0; a < config->approaches; a++)
+  {
+    uint64_t mix = base ^ ((uint64_t)a << 56);
+    for(int j = 0; j < 4; j++)
+    {
+      generator->random[a][j] = splitMix(&mix);
+    }
+    generator->clock[a] = 0.0;
+  }
+}
+
+/**Function to make the next car of a direction, the nextCar of a CarSource over a CarGenerator.
+*@param state the CarGenerator
+*@param direction the approach letter
+*@param car where the car is stored
+*@return 1 when a car was made, 0 once the duration of the run is over
+**/
+int nextGeneratedCar(void *state, char direction, Data *car)
+{
+  CarGenerator *generator = state;
+  const GeneratorConfig *settings = generator->settings;
+  int approach = generator->config->approachOf[(unsigned char)direction];
+  if(approach < 0)
+  {
+    return 0;
+  }
+
+  uint64_t *random = generator->random[approach];
+  double peakRate = settings->ratePerHour[approach]/SECONDS_PER_HOUR*generator->peakProfile;
+  double time = generator->clock[approach];
+  if(!(peakRate > 0.0))
+  {
+    return 0;
+  }
+
+  //arrivals at the peak rate, each kept with the chance its hour has against the peak so the kept ones follow the profile
+  while(1)
+  {
+    time = time - log(1.0 - uniformRandom(random))/peakRate;
+    if(time >= settings->duration)
+    {
+      generator->clock[approach] = settings->duration;
+      return 0;
+    }
+    int hour = (int)fmod(floor(time/SECONDS_PER_HOUR),GENERATOR_HOURS);
+    if(uniformRandom(random)*generator->peakProfile < settings->profile[hour])
+    {
+      break;
+    }
+  }
+  generator->clock[approach] = time;
+
+  double pick = uniformRandom(random)*(settings->turnWeights[0] + settings->turnWeights[1] + settings->turnWeights[2]);
+  if(pick < settings->turnWeights[0])
+  {
+    car->turnDirection = 'F';
+  }
+  else if(pick < settings->turnWeights[0] + settings->turnWeights[1])
+  {
+    car->turnDirection = 'R';
+  }
+  else
+  {
+    car->turnDirection = 'L';
+  }
+  car->travelDirection = direction;
+  //arrival times are kept to a hundredth of a second, the way a data file would write them, so they can tie
+  car->timeOfArrival = (SimTime)floor(time*100.0)*TIME_UNITS_PER_SECOND/100;
+  generator->carsMade++;
+  return 1;
+}
+
+/**Function to give a source handing out the cars of a generator, nothing is held in memory.
+*@param generator the generator
+*@return the source
+**/
+CarSource generatorSource(CarGenerator *generator)
+{
+  CarSource source;
+  source.nextCar = nextGeneratedCar;
+  source.horizon = NULL;
+  source.state = generator;
+  return source;
+}
+
+/**Function to write the cars of one replicate as a car data file sorted by time of arrival.
+*@param fileName path of the car data file to write
+*@param settings what the cars look like
+*@param config the junction
+*@param replicate number of the replicate
+*@return EXIT_SUCCESS on success, EXIT_FAILURE if the file could not be written or memory could not be allocated
+**/
+int writeGeneratedCars(const char *fileName, const GeneratorConfig *settings, IntersectionConfig *config, uint64_t replicate)
+{
+  CarGenerator generator;
+  Data heads[INTERSECTION_MAX_APPROACHES];    //next car of each approach
+  int hasCar[INTERSECTION_MAX_APPROACHES];    //1 while the approach still has cars
+
+  FILE *fp = fopen(fileName,"w");
+  if(fp == NULL)
+  {
+    return EXIT_FAILURE;
+  }
+  OutputBuffer *output = initializeOutput(fp,0);
+  if(output == NULL)
+  {
+    fclose(fp);
+    return EXIT_FAILURE;
+  }
+
+  initializeGenerator(&generator,settings,config,replicate);
+  for(int i = 0; i < config->approaches; i++)
+  {
+    hasCar[i] = nextGeneratedCar(&generator,config->directions[i],&heads[i]);
+  }
+
+  //merging the approaches into one file in order of arrival, the first approach going first on a tie
+  while(1)
+  {
+    int first = -1;
+    for(int i = 0; i < config->approaches; i++)
+    {
+      if(hasCar[i] && (first < 0 || heads[i].timeOfArrival < heads[first].timeOfArrival))
+      {
+        first = i;
+      }
+    }
+    if(first < 0)
+    {
+      break;
+    }
+
+    writeChar(output,heads[first].travelDirection);
+    writeChar(output,' ');
+    writeChar(output,heads[first].turnDirection);
+    writeChar(output,' ');
+    writeTime(output,heads[first].timeOfArrival,0,2);
+    writeChar(output,'\n');
+    hasCar[first] = nextGeneratedCar(&generator,config->directions[first],&heads[first]);
+  }
+
+  deleteOutput(output);
+  int failed = ferror(fp);
+  if(fclose(fp) != 0 || failed)
+  {
+    return EXIT_FAILURE;
+  }
+  return EXIT_SUCCESS;
+}
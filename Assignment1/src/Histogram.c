@@ -0,0 +1,122 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../include/Histogram.h"
+
+/**Function to give the position of the highest bit that is set, by halving the width looked at 6 times.
+*@param value the number, not 0
+*@return 0 to 63
+**/
+static int highestBit(uint64_t value)
+{
+  int bit = 0;
+  for(int step = 32; step > 0; step = step/2)
+  {
+    if((value >> step) != 0)
+    {
+      value = value >> step;
+      bit = bit + step;
+    }
+  }
+  return bit;
+}
+
+/**Function to give the bucket of a wait. Below 2*HISTOGRAM_HALF_BUCKETS the wait is its own bucket, above that the
+*wait is shifted right until it is below that again and each shift moves on HISTOGRAM_HALF_BUCKETS buckets.
+*@param wait the wait in ticks, not negative
+*@return the bucket
+**/
+static int bucketOf(uint64_t wait)
+{
+  int shift = 0;
+  if(wait >= 2*HISTOGRAM_HALF_BUCKETS)
+  {
+    shift = highestBit(wait) - (HISTOGRAM_SUB_BITS - 1);
+  }
+  return shift*HISTOGRAM_HALF_BUCKETS + (int)(wait >> shift);
+}
+
+/**Function to empty a histogram.
+*@param histogram the histogram
+**/
+void clearHistogram(WaitHistogram *histogram)
+{
+  memset(histogram,0,sizeof(WaitHistogram));
+}
+
+/**Function to count one wait. This has a big O notation of 1.
+*@param histogram the histogram
+*@param wait the wait in ticks, a negative wait is counted as 0
+**/
+void recordHistogram(WaitHistogram *histogram, SimTime wait)
+{
+  if(wait < 0)
+  {
+    wait = 0;
+  }
+  if(histogram->count == 0 || wait > histogram->highest)
+  {
+    histogram->highest = wait;
+  }
+  int bucket = bucketOf((uint64_t)wait);
+  histogram->count++;
+  histogram->buckets[bucket]++;
+  if(wait > histogram->longest[bucket])
+  {
+    histogram->longest[bucket] = wait;
+  }
+}
+
+/**Function to add the waits of one histogram to another, as if every wait had been counted in both.
+*@param to the histogram added to
+*@param from the histogram added
+**/
+void mergeHistogram(WaitHistogram *to, const WaitHistogram *from)
+{
+  if(from->count == 0)
+  {
+    return;
+  }
+  if(to->count == 0 || from->highest > to->highest)
+  {
+    to->highest = from->highest;
+  }
+  to->count = to->count + from->count;
+  for(int i = 0; i < HISTOGRAM_BUCKETS; i++)
+  {
+    to->buckets[i] = to->buckets[i] + from->buckets[i];
+    if(from->longest[i] > to->longest[i])
+    {
+      to->longest[i] = from->longest[i];
+    }
+  }
+}
+
+/**Function to give the wait that a share of the counted waits are no longer than, the longest wait in the bucket
+*the share ends in.
+*@pre the histogram must not be empty
+*@param histogram the histogram
+*@param permille the share in tenths of a percent, 500 for the median and 999 for p99.9
+*@return the wait in ticks
+**/
+SimTime histogramPercentile(const WaitHistogram *histogram, int permille)
+{
+  uint64_t count = histogram->count;
+  //the rank of the wait, count*permille/1000 rounded up without overflowing
+  uint64_t rank = count/1000*(uint64_t)permille + ((count%1000)*(uint64_t)permille + 999)/1000;
+  uint64_t seen = 0;
+
+  if(rank == 0)
+  {
+    rank = 1;
+  }
+  for(int i = 0; i < HISTOGRAM_BUCKETS; i++)
+  {
+    seen = seen + histogram->buckets[i];
+    if(seen >= rank)
+    {
+      return histogram->longest[i];
+    }
+  }
+  return histogram->highest;
+}
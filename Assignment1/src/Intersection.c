@@ -0,0 +1,1334 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include "../include/Intersection.h"
+#include "../include/Checkpoint.h"
+
+#define WAIT_BUFFER_CARS 1024  //cars whose waits are collected before they are added to the totals
+
+/**
+ *Waits of the cars that went into the intersection since the totals were last brought up to date, one array per
+ *field so addWaits goes through each of them with vector instructions. The approach is kept as wide as the wait so
+ *both arrays fill the same vector lanes.
+ **/
+typedef struct waitBuffer{
+    int count;
+    SimTime approach[WAIT_BUFFER_CARS];
+    SimTime wait[WAIT_BUFFER_CARS];
+} WaitBuffer;
+
+//1 when the first of two opposite cars goes first, by the turns of the first (row) and second (column) car in the
+//order F, R, L. Going forward beats turning and turning right beats turning left, otherwise the first car goes.
+static const unsigned char firstBeatsOpposite[3][3] = {
+  {1, 1, 1},
+  {0, 1, 1},
+  {0, 0, 1}
+};
+
+//percentiles printed by printWaitPercentiles, in tenths of a percent, and their names
+static const int percentilePermilles[4] = {500, 900, 990, 999};
+static const char *percentileNames[4] = {"p50", "p90", "p99", "p99.9"};
+static const char *turnNames[INTERSECTION_TURNS] = {"forward", "right", "left"};
+
+/**Function to give the row or column of firstBeatsOpposite for a turn.
+*@param turnDirection one of F, R, L, anything else is treated as F
+*@return 0 to 2
+**/
+static int turnIndex(char turnDirection)
+{
+  switch(turnDirection)
+  {
+    case 'R':
+      return 1;
+    case 'L':
+      return 2;
+  }
+  return 0;
+}
+
+/**Function to print that a car is entering the intersection, the rest of the line is printed by printLeaving.
+*@param output where the line goes
+*@param mode one of OUTPUT_CARS, OUTPUT_SUMMARY, OUTPUT_MACHINE, only OUTPUT_CARS prints cars
+*@param firstData the car entering
+*@param timeCounter the time the car enters
+**/
+static void printEntering(OutputBuffer *output, int mode, Data *firstData, SimTime timeCounter)
+{
+  if(mode != OUTPUT_CARS)
+  {
+    return;
+  }
+  writeText(output,"Car going ");
+  writeChar(output,firstData->travelDirection);
+  writeText(output,", turning ");
+  writeChar(output,firstData->turnDirection);
+  writeText(output,", arrival time of ");
+  writeTime(output,firstData->timeOfArrival,6,2);
+  writeText(output," is entering intersection at ");
+  writeTime(output,timeCounter,6,2);
+  writeText(output," and will leave at ");
+}
+
+/**Function to finish the line of a car entering the intersection with the time it leaves.
+*@param output where the line goes
+*@param mode one of OUTPUT_CARS, OUTPUT_SUMMARY, OUTPUT_MACHINE, only OUTPUT_CARS prints cars
+*@param timeCounter the time the car leaves
+**/
+static void printLeaving(OutputBuffer *output, int mode, SimTime timeCounter)
+{
+  if(mode != OUTPUT_CARS)
+  {
+    return;
+  }
+  writeTime(output,timeCounter,6,2);
+  writeChar(output,'\n');
+}
+
+/**Function to print the average, shortest and longest wait of one direction as part of the JSON summary.
+*@param output where the line goes
+*@param name name of the direction
+*@param totals the counts and waits of the run
+*@param approach the approach of the direction
+**/
+static void printDirectionJSON(OutputBuffer *output, const char *name, IntersectionStats *totals, int approach)
+{
+  int amount = totals->amount[approach];
+  writeText(output,",\"");
+  writeText(output,name);
+  writeText(output,"\":{\"cars\":");
+  writeUnsigned(output,(unsigned long long)amount);
+  if(amount != 0)
+  {
+    writeText(output,",\"averageWait\":");
+    writeAverageTime(output,totals->totalWait[approach],(uint64_t)amount,0,2);
+    writeText(output,",\"minWait\":");
+    writeTime(output,totals->minWait[approach],0,2);
+    writeText(output,",\"maxWait\":");
+    writeTime(output,totals->maxWait[approach],0,2);
+  }
+  else
+  {
+    writeText(output,",\"averageWait\":null,\"minWait\":null,\"maxWait\":null");
+  }
+  writeChar(output,'}');
+}
+
+/**Function to give the name a direction is printed with, north, east, south and west for N, E, S, W and the
+*letter itself for any other approach.
+*@param direction letter of the approach
+*@param letter storage for the name of another approach, at least 2 characters
+*@return the name
+**/
+const char *directionName(char direction, char *letter)
+{
+  switch(direction)
+  {
+    case 'N':
+      return "north";
+    case 'E':
+      return "east";
+    case 'S':
+      return "south";
+    case 'W':
+      return "west";
+  }
+  letter[0] = direction;
+  letter[1] = '\0';
+  return letter;
+}
+
+/**Function to allocate empty histograms of waits.
+*@return the histograms, NULL if memory could not be allocated
+**/
+WaitHistograms *initializeWaitHistograms(void)
+{
+  WaitHistograms *histograms = malloc(sizeof(WaitHistograms));
+  if(histograms == NULL)
+  {
+    return NULL;
+  }
+  for(int i = 0; i < INTERSECTION_MAX_APPROACHES; i++)
+  {
+    clearHistogram(&histograms->approach[i]);
+  }
+  for(int i = 0; i < INTERSECTION_TURNS; i++)
+  {
+    clearHistogram(&histograms->turn[i]);
+  }
+  return histograms;
+}
+
+/**Function to add the waits of one set of histograms to another, for the totals of several runs.
+*@param to the histograms added to
+*@param from the histograms added, may be NULL
+**/
+void mergeWaitHistograms(WaitHistograms *to, const WaitHistograms *from)
+{
+  if(to == NULL || from == NULL)
+  {
+    return;
+  }
+  for(int i = 0; i < INTERSECTION_MAX_APPROACHES; i++)
+  {
+    mergeHistogram(&to->approach[i],&from->approach[i]);
+  }
+  for(int i = 0; i < INTERSECTION_TURNS; i++)
+  {
+    mergeHistogram(&to->turn[i],&from->turn[i]);
+  }
+}
+
+/**Function to free histograms of waits.
+*@param histograms the histograms to be deleted, may be NULL
+**/
+void deleteWaitHistograms(WaitHistograms *histograms)
+{
+  free(histograms);
+}
+
+/**Function to print the percentiles of one histogram, as a line of text or as a member of the JSON object.
+*@param output where the line goes
+*@param mode OUTPUT_MACHINE for a JSON member, a line of text otherwise
+*@param name what the waits are of, NULL for all cars
+*@param histogram the waits
+*@param first 1 for the first JSON member, which has no comma in front of it
+**/
+static void printPercentileLine(OutputBuffer *output, int mode, const char *name, const WaitHistogram *histogram, int first)
+{
+  if(mode == OUTPUT_MACHINE)
+  {
+    writeText(output,first ? "\"" : ",\"");
+    writeText(output,(name == NULL) ? "all" : name);
+    writeText(output,"\":");
+    if(histogram->count == 0)
+    {
+      writeText(output,"null");
+      return;
+    }
+    writeText(output,"{\"cars\":");
+    writeUnsigned(output,(unsigned long long)histogram->count);
+    for(int i = 0; i < 4; i++)
+    {
+      writeText(output,",\"");
+      writeText(output,percentileNames[i]);
+      writeText(output,"\":");
+      writeTime(output,histogramPercentile(histogram,percentilePermilles[i]),0,2);
+    }
+    writeChar(output,'}');
+    return;
+  }
+
+  if(histogram->count == 0)
+  {
+    return;
+  }
+  writeText(output,"wait percentiles");
+  if(name != NULL)
+  {
+    writeText(output," for ");
+    writeText(output,name);
+  }
+  writeChar(output,':');
+  for(int i = 0; i < 4; i++)
+  {
+    writeChar(output,' ');
+    writeText(output,percentileNames[i]);
+    writeChar(output,':');
+    writeTime(output,histogramPercentile(histogram,percentilePermilles[i]),6,2);
+  }
+  writeChar(output,'\n');
+}
+
+/**Function to print the p50, p90, p99 and p99.9 waits of each approach and turn that has cars and of all cars.
+*@param output where the lines go
+*@param mode OUTPUT_CARS and OUTPUT_SUMMARY print lines of text, OUTPUT_MACHINE a "percentiles" member of a JSON object
+*@param config the junction, giving the names of the approaches
+*@param histograms the waits, nothing is printed when it is NULL
+**/
+void printWaitPercentiles(OutputBuffer *output, int mode, IntersectionConfig *config, const WaitHistograms *histograms)
+{
+  char letter[2];
+  WaitHistogram all;
+
+  if(output == NULL || histograms == NULL)
+  {
+    return;
+  }
+  clearHistogram(&all);
+  for(int i = 0; i < config->approaches; i++)
+  {
+    mergeHistogram(&all,&histograms->approach[i]);
+  }
+
+  if(mode == OUTPUT_MACHINE)
+  {
+    writeText(output,",\"percentiles\":{");
+  }
+  for(int i = 0; i < config->approaches; i++)
+  {
+    printPercentileLine(output,mode,directionName(config->directions[i],letter),&histograms->approach[i],i == 0);
+  }
+  for(int i = 0; i < INTERSECTION_TURNS; i++)
+  {
+    printPercentileLine(output,mode,turnNames[i],&histograms->turn[i],0);
+  }
+  printPercentileLine(output,mode,NULL,&all,0);
+  if(mode == OUTPUT_MACHINE)
+  {
+    writeChar(output,'}');
+  }
+}
+
+/**Function to print the average wait time of each direction, of all cars and the max wait time.
+*@param output where the lines go
+*@param mode OUTPUT_CARS and OUTPUT_SUMMARY print lines of text, OUTPUT_MACHINE prints one line of JSON
+*@param config the junction, giving the names of the approaches
+*@param totals the counts and waits of the run
+**/
+static void printSummary(OutputBuffer *output, int mode, IntersectionConfig *config, IntersectionStats *totals)
+{
+  char letter[2];
+  int amount = 0;
+  SimTime totalWait = 0;
+  int everyApproach = 1;
+
+  for(int i = 0; i < config->approaches; i++)
+  {
+    amount = amount + totals->amount[i];
+    totalWait = totalWait + totals->totalWait[i];
+    everyApproach = everyApproach && (totals->amount[i] != 0);
+  }
+
+  if(mode == OUTPUT_MACHINE)
+  {
+    writeText(output,"{\"cars\":");
+    writeUnsigned(output,(unsigned long long)amount);
+    for(int i = 0; i < config->approaches; i++)
+    {
+      printDirectionJSON(output,directionName(config->directions[i],letter),totals,i);
+    }
+    writeText(output,",\"averageWait\":");
+    if(amount != 0)
+    {
+      writeAverageTime(output,totalWait,(uint64_t)amount,0,2);
+    }
+    else
+    {
+      writeText(output,"null");
+    }
+    writeText(output,",\"maxWait\":");
+    writeTime(output,totals->maxWaitTime,0,2);
+    writeText(output,",\"endTime\":");
+    writeTime(output,totals->timeCounter,0,2);
+    printWaitPercentiles(output,mode,config,totals->histograms);
+    writeText(output,"}\n");
+    return;
+  }
+
+  for(int i = 0; i < config->approaches; i++)
+  {
+    if(totals->amount[i] != 0)
+    {
+      writeText(output,"average wait time for ");
+      writeText(output,directionName(config->directions[i],letter));
+      writeChar(output,':');
+      writeAverageTime(output,totals->totalWait[i],(uint64_t)totals->amount[i],6,2);
+      writeChar(output,'\n');
+    }
+  }
+  if(everyApproach)
+  {
+    writeText(output,"average wait time:");
+    writeAverageTime(output,totalWait,(uint64_t)amount,6,2);
+    writeChar(output,'\n');
+  }
+  writeText(output,"Max wait time:");
+  writeTime(output,totals->maxWaitTime,6,2);
+  writeChar(output,'\n');
+  printWaitPercentiles(output,mode,config,totals->histograms);
+}
+
+/**Function to find which approach goes first when the approaches of a set arrive at the same time.
+*@param config the junction, with its approaches and ranks filled in
+*@param tied bit set of the tied approaches, not 0
+*@param opposite set to the opposite approach when the turns of the two cars decide, otherwise -1
+*@return the approach going first, or the first of the opposite pair
+**/
+static int settleTie(IntersectionConfig *config, int tied, int *opposite)
+{
+  int k = config->approaches;
+  int candidates = tied;
+  int count = 0;
+  int winner = -1;
+  int other = -1;
+
+  //giving way to a tied car on the right, when every car has one on its right nobody can go by that rule
+  if(config->yieldToRight)
+  {
+    candidates = 0;
+    for(int i = 0; i < k; i++)
+    {
+      int right = (i + k - 1) % k;
+      if((tied & (1 << i)) && !(tied & (1 << right)))
+      {
+        candidates = candidates | (1 << i);
+      }
+    }
+    if(candidates == 0)
+    {
+      candidates = tied;
+    }
+  }
+
+  for(int i = 0; i < k; i++)
+  {
+    if(!(candidates & (1 << i)))
+    {
+      continue;
+    }
+    count++;
+    if(winner < 0 || config->rank[i] < config->rank[winner])
+    {
+      other = winner;
+      winner = i;
+    }
+    else if(other < 0 || config->rank[i] < config->rank[other])
+    {
+      other = i;
+    }
+  }
+
+  //two cars left facing each other, their turns decide
+  *opposite = -1;
+  if(config->yieldToRight && count == 2 && k % 2 == 0 && (winner + k/2) % k == other)
+  {
+    *opposite = other;
+  }
+  return winner;
+}
+
+/**Function to tell whether a point of the edge of the junction lies strictly inside the arc going clockwise from
+*one point to another, the edge having 2k points.
+*@param point the point
+*@param from start of the arc
+*@param to end of the arc
+*@param points number of points on the edge
+**/
+static int insideArc(int point, int from, int to, int points)
+{
+  return point != from && (point - from + points) % points < (to - from + points) % points;
+}
+
+/**Function to fill in which movements conflict. Going clockwise around the edge of the junction every side has the
+*lane in (point 2s) followed by the lane out (point 2s + 1), cars driving on the right. A movement is the chord from
+*its lane in to the lane out of its exit side, and two movements conflict when their chords cross, they come from
+*the same approach (one car of an approach at a time) or they leave on the same side (the cars would merge).
+*Opposite cars going forward, right turns and opposite left turns share the junction of a four way intersection.
+*@param config the junction, with its approaches filled in
+**/
+static void buildConflicts(IntersectionConfig *config)
+{
+  static const char turns[3] = {'F','R','L'};
+  int k = config->approaches;
+  int points = 2*k;
+
+  for(int first = 0; first < INTERSECTION_MOVEMENTS; first++)
+  {
+    config->conflicts[first] = 0;
+  }
+  for(int first = 0; first < 3*k; first++)
+  {
+    int firstIn = 2*(first/3);
+    int firstExit = exitSide(config,first/3,turns[first%3]);
+    for(int second = 0; second < 3*k; second++)
+    {
+      int secondIn = 2*(second/3);
+      int secondExit = exitSide(config,second/3,turns[second%3]);
+      int secondOut = 2*secondExit + 1;
+      int crosses = insideArc(secondIn,firstIn,2*firstExit + 1,points) != insideArc(secondOut,firstIn,2*firstExit + 1,points);
+      if(firstIn == secondIn || firstExit == secondExit || crosses)
+      {
+        config->conflicts[first] = config->conflicts[first] | ((uint32_t)1 << second);
+      }
+    }
+  }
+}
+
+/**Function to set up a junction, filling in the tables used to settle ties.
+*@return EXIT_SUCCESS on success, EXIT_FAILURE if the directions or priority are not valid
+*@param config the junction to set up
+*@param directions letters of the approaches going clockwise, NULL for INTERSECTION_DEFAULT_APPROACHES
+*@param priority the same letters from the highest right-of-way to the lowest, NULL to rank them in clockwise order
+*@param yieldToRight 1 to apply the rule of the right before the ranks, 0 to settle ties by rank only
+**/
+int configureIntersection(IntersectionConfig *config, const char *directions, const char *priority, int yieldToRight)
+{
+  if(config == NULL)
+  {
+    return EXIT_FAILURE;
+  }
+  if(directions == NULL)
+  {
+    directions = INTERSECTION_DEFAULT_APPROACHES;
+  }
+
+  size_t length = strlen(directions);
+  if(length == 0 || length > INTERSECTION_MAX_APPROACHES)
+  {
+    return EXIT_FAILURE;
+  }
+  if(priority != NULL && strlen(priority) != length)
+  {
+    return EXIT_FAILURE;
+  }
+
+  config->approaches = (int)length;
+  config->yieldToRight = yieldToRight;
+  for(int i = 0; i < 256; i++)
+  {
+    config->approachOf[i] = -1;
+  }
+  for(int i = 0; i < config->approaches; i++)
+  {
+    unsigned char letter = (unsigned char)directions[i];
+    //a direction has to be one visible character that is not used by another approach
+    if(!isgraph(letter) || config->approachOf[letter] >= 0)
+    {
+      return EXIT_FAILURE;
+    }
+    config->directions[i] = (char)letter;
+    config->approachOf[letter] = (signed char)i;
+    config->rank[i] = i;
+  }
+  config->directions[config->approaches] = '\0';
+
+  if(priority != NULL)
+  {
+    int ranked = 0;
+    for(int i = 0; i < config->approaches; i++)
+    {
+      int approach = config->approachOf[(unsigned char)priority[i]];
+      if(approach < 0 || (ranked & (1 << approach)))
+      {
+        return EXIT_FAILURE;
+      }
+      ranked = ranked | (1 << approach);
+      config->rank[approach] = i;
+    }
+  }
+
+  config->shareBox = 0;
+  config->percentiles = 0;
+  config->checkpointFile = NULL;
+  config->checkpointEvery = CHECKPOINT_DEFAULT_EVERY;
+  config->resume = NULL;
+  config->incremental = NULL;
+  config->window = 0;
+  buildConflicts(config);
+
+  //settling every possible tie once, so a tie at run time is a lookup
+  config->tieWinner[0] = -1;
+  config->tieOpposite[0] = -1;
+  for(int tied = 1; tied < (1 << config->approaches); tied++)
+  {
+    int opposite;
+    config->tieWinner[tied] = (signed char)settleTie(config,tied,&opposite);
+    config->tieOpposite[tied] = (signed char)opposite;
+  }
+  return EXIT_SUCCESS;
+}
+
+/**Function to pick which of the approaches tied for the earliest arrival goes first, with the tables of the junction.
+*@param config the junction
+*@param tied bit set of the tied approaches, not 0
+*@param heads the first car of each approach, only the tied ones are looked at
+*@return the approach that goes first
+**/
+int resolveTie(IntersectionConfig *config, int tied, Data *heads)
+{
+  int winner = config->tieWinner[tied];
+  int second = config->tieOpposite[tied];
+
+  if(second >= 0 && !firstBeatsOpposite[turnIndex(heads[winner].turnDirection)][turnIndex(heads[second].turnDirection)])
+  {
+    winner = second;
+  }
+  return winner;
+}
+
+/**Function to give the side of the junction a car leaves on. Going forward it leaves on the side across from its
+*approach (a + k/2 of k approaches), turning right on the side before its approach and turning left on the one after.
+*@param config the junction
+*@param approach the approach the car comes from
+*@param turnDirection one of F, R, L, anything else is treated as F
+*@return the side, an approach number
+**/
+int exitSide(IntersectionConfig *config, int approach, char turnDirection)
+{
+  int k = config->approaches;
+  switch(turnDirection)
+  {
+    case 'R':
+      return (approach + k - 1) % k;
+    case 'L':
+      return (approach + 1) % k;
+  }
+  return (approach + k/2) % k;
+}
+
+/**Function to give the movement of a car, its approach and its turn, as an index into conflicts.
+*@param approach the approach the car comes from
+*@param turnDirection one of F, R, L, anything else is treated as F
+*@return approach*3 plus 0, 1 or 2 for F, R, L
+**/
+int movementOf(int approach, char turnDirection)
+{
+  return approach*3 + turnIndex(turnDirection);
+}
+
+/**Function to tell whether the head of one approach goes before the head of another in the heap.
+*@param heads the first car of each approach
+*@param config the junction
+*@param compare function comparing the timeOfArrival of two cars
+*@param first approach of the first head
+*@param second approach of the second head
+*@return 1 when first arrived earlier, or at the same time with a lower rank
+**/
+static int headBefore(Data *heads, IntersectionConfig *config, int (*compare)(void *first,void *second), int first, int second)
+{
+  int result = compare(&heads[first],&heads[second]);
+  if(result != 0)
+  {
+    return result < 0;
+  }
+  return config->rank[first] < config->rank[second];
+}
+
+/**Function to add an approach to the heap of approach heads. This has a big O notation of log k.
+*@param heap the approaches in heap order
+*@param size number of approaches in the heap, updated
+*@param approach the approach to add, its head must be filled in
+*@param heads the first car of each approach
+*@param config the junction
+*@param compare function comparing the timeOfArrival of two cars
+**/
+static void pushApproach(int *heap, int *size, int approach, Data *heads, IntersectionConfig *config, int (*compare)(void *first,void *second))
+{
+  int position = (*size)++;
+  while(position > 0)
+  {
+    int parent = (position - 1)/2;
+    if(!headBefore(heads,config,compare,approach,heap[parent]))
+    {
+      break;
+    }
+    heap[position] = heap[parent];
+    position = parent;
+  }
+  heap[position] = approach;
+}
+
+/**Function to take the approach with the earliest head off the heap. This has a big O notation of log k.
+*@pre the heap must not be empty
+*@param heap the approaches in heap order
+*@param size number of approaches in the heap, updated
+*@param heads the first car of each approach
+*@param config the junction
+*@param compare function comparing the timeOfArrival of two cars
+*@return the approach that was on top
+**/
+static int popApproach(int *heap, int *size, Data *heads, IntersectionConfig *config, int (*compare)(void *first,void *second))
+{
+  int top = heap[0];
+  int last = heap[--(*size)];
+  int position = 0;
+
+  while(2*position + 1 < *size)
+  {
+    int child = 2*position + 1;
+    if(child + 1 < *size && headBefore(heads,config,compare,heap[child + 1],heap[child]))
+    {
+      child++;
+    }
+    if(!headBefore(heads,config,compare,heap[child],last))
+    {
+      break;
+    }
+    heap[position] = heap[child];
+    position = child;
+  }
+  heap[position] = last;
+  return top;
+}
+
+/**Function to pick the approach whose car goes next and take it off the heap.
+*the earliest head is popped, any heads that arrived at the same time are popped as well and the tie is looked up,
+*then the approaches that lost the tie are pushed back.
+*@pre the heap must not be empty
+*@param heap the approaches in heap order
+*@param size number of approaches in the heap, updated
+*@param heads the first car of each approach
+*@param config the junction
+*@param compare function comparing the timeOfArrival of two cars
+*@return the approach that goes next
+**/
+static int pickApproach(int *heap, int *size, Data *heads, IntersectionConfig *config, int (*compare)(void *first,void *second))
+{
+  int earliest = popApproach(heap,size,heads,config,compare);
+  int tied;
+  int winner;
+
+  if(*size == 0 || compare(&heads[heap[0]],&heads[earliest]) != 0)
+  {
+    return earliest;
+  }
+
+  tied = 1 << earliest;
+  while(*size > 0 && compare(&heads[heap[0]],&heads[earliest]) == 0)
+  {
+    tied = tied | (1 << popApproach(heap,size,heads,config,compare));
+  }
+
+  winner = resolveTie(config,tied,heads);
+  for(int i = 0; i < config->approaches; i++)
+  {
+    if(i != winner && (tied & (1 << i)))
+    {
+      pushApproach(heap,size,i,heads,config,compare);
+    }
+  }
+  return winner;
+}
+
+/**Function to add the waits collected in the buffer to the totals and empty it. Each approach is one pass over
+*the buffer without branches, which the compiler turns into vector compares, blends and adds. This has a big O
+*notation of k*B, B being the cars in the buffer, but the buffer stays in the cache for every pass.
+*@param totals the counts and waits of the run
+*@param waits the buffer
+**/
+static void addWaits(IntersectionStats *totals, WaitBuffer *waits)
+{
+  int count = waits->count;
+  for(int a = 0; a < totals->approaches; a++)
+  {
+    SimTime amount = 0;
+    SimTime sum = 0;
+    SimTime longest = totals->maxWait[a];
+    SimTime shortest = totals->minWait[a];
+    //mask is all ones for the cars of the approach, the others become a wait of 0 for the longest (waits are never
+    //negative) and of INT64_MAX for the shortest
+    for(int i = 0; i < count; i++)
+    {
+      SimTime mask = -(SimTime)(waits->approach[i] == a);
+      SimTime wait = waits->wait[i] & mask;
+      SimTime other = wait | (INT64_MAX & ~mask);
+      amount = amount - mask;
+      sum = sum + wait;
+      longest = (wait > longest) ? wait : longest;
+      shortest = (other < shortest) ? other : shortest;
+    }
+    totals->amount[a] = totals->amount[a] + (int)amount;
+    totals->totalWait[a] = totals->totalWait[a] + sum;
+    totals->maxWait[a] = longest;
+    totals->minWait[a] = shortest;
+    if(totals->maxWaitTime < longest)
+    {
+      totals->maxWaitTime = longest;
+    }
+  }
+  waits->count = 0;
+}
+
+/**Function to keep the wait of a car going into the intersection until the buffer is added to the totals, and to
+*count it in the histograms of its approach and turn when the run keeps them.
+*@param waits the buffer
+*@param totals the counts and waits of the run, brought up to date when the buffer is full
+*@param approach the approach of the car
+*@param turnDirection the turn of the car
+*@param waitTime how long the car waited
+**/
+static void recordWait(WaitBuffer *waits, IntersectionStats *totals, int approach, char turnDirection, SimTime waitTime)
+{
+  if(totals->histograms != NULL)
+  {
+    recordHistogram(&totals->histograms->approach[approach],waitTime);
+    recordHistogram(&totals->histograms->turn[turnIndex(turnDirection)],waitTime);
+  }
+  waits->approach[waits->count] = approach;
+  waits->wait[waits->count] = waitTime;
+  waits->count++;
+  if(waits->count == WAIT_BUFFER_CARS)
+  {
+    addWaits(totals,waits);
+  }
+}
+
+/**Function to take the next car of an approach from the source into its head, counting it for checkpoints. When a
+*source with a horizon has no car of the approach before its horizon yet, the approach is pending until then.
+*@param source where the cars come from
+*@param config the junction
+*@param state the state of the run
+*@param approach the approach
+*@return 1 when the approach had another car, 0 when it has run out or is pending
+**/
+static int takeCar(CarSource *source, IntersectionConfig *config, EngineState *state, int approach)
+{
+  if(!source->nextCar(source->state,config->directions[approach],&state->heads[approach]))
+  {
+    SimTime horizon = (source->horizon == NULL) ? INT64_MAX : source->horizon(source->state);
+    if(horizon != INT64_MAX)
+    {
+      state->pending = state->pending | (1 << approach);
+      if(horizon < state->pendingUntil)
+      {
+        state->pendingUntil = horizon;
+      }
+    }
+    return 0;
+  }
+  state->taken[approach]++;
+  return 1;
+}
+
+/**Function to send the first car of an approach through the intersection, updating the totals and the next car of the approach.
+*@param source where the cars come from
+*@param config the junction
+*@param state the state of the run, with the first car of each approach and the totals
+*@param approach the approach whose car goes
+*@param waits where the wait of the car is kept until it is added to the totals
+*@param output where the car is written
+*@param mode one of OUTPUT_CARS, OUTPUT_SUMMARY, OUTPUT_MACHINE
+*@return 1 when the approach has another car, 0 when it has run out or is pending
+**/
+static int serveCar(CarSource *source, IntersectionConfig *config, EngineState *state, int approach, WaitBuffer *waits, OutputBuffer *output, int mode)
+{
+  Data *firstData = &state->heads[approach];
+  IntersectionStats *totals = &state->totals;
+
+  if(totals->timeCounter < firstData->timeOfArrival)
+  {
+    totals->timeCounter = firstData->timeOfArrival;
+  }
+  printEntering(output,mode,firstData,totals->timeCounter);
+  SimTime waitTime = totals->timeCounter - firstData->timeOfArrival;
+  recordWait(waits,totals,approach,firstData->turnDirection,waitTime);
+  totals->timeCounter = totals->timeCounter + turnTime(firstData);
+  printLeaving(output,mode,totals->timeCounter);
+  if(state->rollup != NULL)
+  {
+    recordRollup(state->rollup,approach,firstData->timeOfArrival,waitTime,totals->timeCounter);
+  }
+  state->served++;
+
+  return takeCar(source,config,state,approach);
+}
+
+/**Function to print the windows that have closed once the first car of an approach has changed, the windows
+*ending by the time the first car still to go arrives.
+*@param config the junction
+*@param state the state of the run, with the windows
+*@param approach the approach whose first car has changed, or has run out, -1 after pending approaches were asked again
+**/
+static void closeWindows(IntersectionConfig *config, EngineState *state, int approach)
+{
+  WindowRollup *rollup = state->rollup;
+
+  //nothing closes while the new first car of the approach arrives before the end of the oldest open window
+  if(rollup == NULL || (approach >= 0 && (state->waiting & (1 << approach)) && state->heads[approach].timeOfArrival < rollup->closesAt))
+  {
+    return;
+  }
+  //a pending approach has no car before pendingUntil, but may have one then
+  SimTime earliest = state->pendingUntil;
+  for(int i = 0; i < config->approaches; i++)
+  {
+    if((state->waiting & (1 << i)) && state->heads[i].timeOfArrival < earliest)
+    {
+      earliest = state->heads[i].timeOfArrival;
+    }
+  }
+  closeRollup(rollup,earliest);
+}
+
+/**Function to give the number of cars served at which the next checkpoint is saved, every multiple of
+*config->checkpointEvery, so a resumed run saves its checkpoints at the same cars as the run it carries on.
+*@param config the junction
+*@param served cars served so far
+*@return the cars, UINT64_MAX when the run saves no checkpoints
+**/
+static uint64_t nextCheckpoint(IntersectionConfig *config, uint64_t served)
+{
+  if(config->checkpointFile == NULL || config->checkpointEvery == 0)
+  {
+    return UINT64_MAX;
+  }
+  return (served/config->checkpointEvery + 1)*config->checkpointEvery;
+}
+
+/**Function to save the state of the run to its checkpoint file. Every wait is added to the totals first and every
+*line so far is handed to the file, so the output of the run is at least outputBytes long once the checkpoint is
+*there. A checkpoint that cannot be written is reported and the run goes on.
+*@param config the junction, with the checkpoint file
+*@param state the state of the run
+*@param waits the waits not added to the totals yet
+*@param output where the results are written
+*@param mode one of OUTPUT_CARS, OUTPUT_SUMMARY, OUTPUT_MACHINE
+**/
+static void saveCheckpoint(IntersectionConfig *config, EngineState *state, WaitBuffer *waits, OutputBuffer *output, int mode)
+{
+  addWaits(&state->totals,waits);
+  flushOutput(output);
+  if(output != NULL && output->fp != NULL)
+  {
+    fflush(output->fp);
+  }
+  state->outputBytes = (output == NULL) ? 0 : output->written;
+  if(writeCheckpoint(config->checkpointFile,config,mode,state,NULL) != EXIT_SUCCESS)
+  {
+    fprintf(stderr,"could not write the checkpoint %s\n",config->checkpointFile);
+  }
+}
+
+/**Function to take a car from the source for the approaches asked for that have none, every approach for the first
+*car of each when the run starts and the cars that have come since the last run of an incremental one, the pending
+*approaches when a car at or after pendingUntil is about to go.
+*@param source where the cars come from
+*@param config the junction
+*@param state the state of the run
+*@param ask bit set of the approaches to take a car for
+*@return 1 when an approach got a car or ran out or pendingUntil moved on, 0 when the source had nothing new
+**/
+static int takeHeads(CarSource *source, IntersectionConfig *config, EngineState *state, int ask)
+{
+  int waiting = state->waiting;
+  int pending = state->pending;
+  SimTime pendingUntil = state->pendingUntil;
+
+  ask = ask & ~state->waiting;
+  state->pending = state->pending & ~ask;
+  if(state->pending == 0)
+  {
+    state->pendingUntil = INT64_MAX;
+  }
+  for(int i = 0; i < config->approaches; i++)
+  {
+    if((ask & (1 << i)) && takeCar(source,config,state,i))
+    {
+      state->waiting = state->waiting | (1 << i);
+    }
+  }
+  return state->waiting != waiting || state->pending != pending || state->pendingUntil != pendingUntil;
+}
+
+/**Function to ask the pending approaches for a car again, then close the windows they were keeping open.
+*@param source where the cars come from
+*@param config the junction
+*@param state the state of the run
+*@return 1 when something changed, 0 when the source has nothing new yet and the run has to stop
+**/
+static int takePending(CarSource *source, IntersectionConfig *config, EngineState *state)
+{
+  if(!takeHeads(source,config,state,state->pending))
+  {
+    return 0;
+  }
+  closeWindows(config,state,-1);
+  return 1;
+}
+
+/**Function to take the next car of a direction from a source, asking again while a source with a horizon has no car
+*of the direction yet but its horizon moves on.
+*@param source where the cars come from
+*@param direction the direction
+*@param car where the car is copied to
+*@return 1 when a car was copied, 0 when the direction has no more cars
+**/
+static int nextCarOfSource(CarSource *source, char direction, Data *car)
+{
+  SimTime horizon = INT64_MIN;
+  int asked = 0;
+
+  while(!source->nextCar(source->state,direction,car))
+  {
+    if(source->horizon == NULL)
+    {
+      return 0;
+    }
+    SimTime newHorizon = source->horizon(source->state);
+    if(newHorizon == INT64_MAX || (asked && newHorizon == horizon))
+    {
+      return 0;
+    }
+    horizon = newHorizon;
+    asked = 1;
+  }
+  return 1;
+}
+
+/**Function to carry on a run from config->resume. The cars the interrupted run had taken are taken from the source
+*again, the last one of each approach has to be the head the checkpoint kept and an approach that had run out has
+*to run out again, a pending one is asked again when the run gets to it. The output written so far is thrown away and from here on the output carries on from the
+*outputBytes of the checkpoint.
+*@param source where the cars come from
+*@param config the junction
+*@param state the state of the run to fill in, it takes over the histograms of config->resume
+*@param output where the results are written
+*@return EXIT_SUCCESS on success, EXIT_FAILURE when the source does not hand out the cars of the checkpoint
+**/
+static int resumeEngine(CarSource *source, IntersectionConfig *config, EngineState *state, OutputBuffer *output)
+{
+  *state = *config->resume;
+  config->resume->totals.histograms = NULL;
+
+  for(int i = 0; i < config->approaches; i++)
+  {
+    Data car;
+    memset(&car,0,sizeof(Data));
+    for(uint64_t taken = 0; taken < state->taken[i]; taken++)
+    {
+      if(!nextCarOfSource(source,config->directions[i],&car))
+      {
+        return EXIT_FAILURE;
+      }
+    }
+    if(state->waiting & (1 << i))
+    {
+      Data *head = &state->heads[i];
+      if(car.timeOfArrival != head->timeOfArrival || car.travelDirection != head->travelDirection || car.turnDirection != head->turnDirection)
+      {
+        return EXIT_FAILURE;
+      }
+    }
+    else if(!(state->pending & (1 << i)) && nextCarOfSource(source,config->directions[i],&car))
+    {
+      return EXIT_FAILURE;
+    }
+  }
+
+  discardOutput(output,0);
+  if(output != NULL)
+  {
+    output->written = state->outputBytes;
+  }
+  return EXIT_SUCCESS;
+}
+
+/**Function to put the approaches that have a car in the order the one car engine would send their cars, earliest
+*arrival first with cars arriving together settled by resolveTie. This has a big O notation of k^2.
+*@param config the junction
+*@param compare function comparing the timeOfArrival of two cars
+*@param heads the first car of each approach
+*@param waiting bit set of the approaches that have a car
+*@param order where the approaches are stored in order
+*@return the number of approaches in order
+**/
+static int orderWaiting(IntersectionConfig *config, int (*compare)(void *first,void *second), Data *heads, int waiting, int *order)
+{
+  int count = 0;
+  int left = waiting;
+
+  while(left != 0)
+  {
+    int earliest = -1;
+    int tied = 0;
+    for(int i = 0; i < config->approaches; i++)
+    {
+      if((left & (1 << i)) && (earliest < 0 || compare(&heads[i],&heads[earliest]) < 0))
+      {
+        earliest = i;
+      }
+    }
+    for(int i = 0; i < config->approaches; i++)
+    {
+      if((left & (1 << i)) && compare(&heads[i],&heads[earliest]) == 0)
+      {
+        tied = tied | (1 << i);
+      }
+    }
+    int winner = resolveTie(config,tied,heads);
+    order[count++] = winner;
+    left = left & ~(1 << winner);
+  }
+  return count;
+}
+
+/**Function to run the intersection with cars whose movements do not conflict in it at the same time. Cars are
+*looked at in the order the one car engine would send them, and a car that has arrived goes in as soon as no car
+*in the intersection has a conflicting movement. A car never goes in ahead of an earlier car it conflicts with,
+*so nobody waits forever behind cars that keep slipping past. With every movement in conflict this gives the same
+*times as the one car engine. The events are cars arriving and cars leaving, and each one costs O(k^2). The pending
+*approaches are asked again before an event at or after pendingUntil, and when the source has nothing new yet the
+*run stops there, leaving state to carry on from.
+*@param source where the cars come from
+*@param config the junction
+*@param compare function comparing the timeOfArrival of two cars
+*@param state the state of the run, with the first car of each approach, the cars in the intersection and the
+*totals, timeCounter is left at the time the last car leaves
+*@param waits where the waits of the cars are kept until they are added to the totals
+*@param output where the cars are written
+*@param mode one of OUTPUT_CARS, OUTPUT_SUMMARY, OUTPUT_MACHINE
+**/
+static void simulateSharedBox(CarSource *source, IntersectionConfig *config, int (*compare)(void *first,void *second), EngineState *state, WaitBuffer *waits, OutputBuffer *output, int mode)
+{
+  Data *heads = state->heads;
+  IntersectionStats *totals = &state->totals;
+  int order[INTERSECTION_MAX_APPROACHES];
+  uint64_t checkpointAt = nextCheckpoint(config,state->served);
+
+  while(state->waiting != 0 || state->inside != 0 || state->pending != 0)
+  {
+    //the state between two events is all there is to carry on from
+    if(state->served >= checkpointAt)
+    {
+      saveCheckpoint(config,state,waits,output,mode);
+      checkpointAt = nextCheckpoint(config,state->served);
+    }
+
+    //cars that are through by now leave the intersection
+    for(int i = 0; i < config->approaches; i++)
+    {
+      if((state->inside & (1 << i)) && state->leaveTime[i] <= state->now)
+      {
+        state->inside = state->inside & ~(1 << i);
+        state->occupied = state->occupied & ~((uint32_t)1 << state->movement[i]);
+      }
+    }
+
+    //letting in every car that can go now, looking again from the first car after each one goes in
+    int entered = 1;
+    while(entered)
+    {
+      //a pending approach may have a car that has arrived by now, it is asked again before anyone goes in
+      while(state->pending != 0 && state->pendingUntil <= state->now)
+      {
+        if(!takePending(source,config,state))
+        {
+          return;
+        }
+      }
+      uint32_t reserved = 0;  //movements conflicting with a car that has to wait, later cars may not take them
+      int count = orderWaiting(config,compare,heads,state->waiting,order);
+      entered = 0;
+      for(int i = 0; i < count && heads[order[i]].timeOfArrival <= state->now; i++)
+      {
+        int approach = order[i];
+        int carMovement = movementOf(approach,heads[approach].turnDirection);
+        if((config->conflicts[carMovement] & state->occupied) != 0 || (reserved & ((uint32_t)1 << carMovement)) != 0)
+        {
+          reserved = reserved | config->conflicts[carMovement];
+          continue;
+        }
+
+        printEntering(output,mode,&heads[approach],state->now);
+        recordWait(waits,totals,approach,heads[approach].turnDirection,state->now - heads[approach].timeOfArrival);
+        state->leaveTime[approach] = state->now + turnTime(&heads[approach]);
+        printLeaving(output,mode,state->leaveTime[approach]);
+        if(totals->timeCounter < state->leaveTime[approach])
+        {
+          totals->timeCounter = state->leaveTime[approach];
+        }
+        if(state->rollup != NULL)
+        {
+          recordRollup(state->rollup,approach,heads[approach].timeOfArrival,state->now - heads[approach].timeOfArrival,state->leaveTime[approach]);
+        }
+        state->movement[approach] = carMovement;
+        state->occupied = state->occupied | ((uint32_t)1 << carMovement);
+        state->inside = state->inside | (1 << approach);
+        state->served++;
+        if(!takeCar(source,config,state,approach))
+        {
+          state->waiting = state->waiting & ~(1 << approach);
+        }
+        closeWindows(config,state,approach);
+        entered = 1;
+        break;
+      }
+    }
+
+    //moving on to the next car leaving or arriving, a car that has arrived and has to wait only goes when one leaves
+    int found = 0;
+    SimTime next = state->now;
+    for(int i = 0; i < config->approaches; i++)
+    {
+      if((state->inside & (1 << i)) && (!found || state->leaveTime[i] < next))
+      {
+        next = state->leaveTime[i];
+        found = 1;
+      }
+      if((state->waiting & (1 << i)) && heads[i].timeOfArrival > state->now && (!found || heads[i].timeOfArrival < next))
+      {
+        next = heads[i].timeOfArrival;
+        found = 1;
+      }
+    }
+    //a pending approach may have a car arriving by then, it is asked again first
+    if(state->pending != 0 && (!found || next >= state->pendingUntil))
+    {
+      if(!takePending(source,config,state))
+      {
+        break;
+      }
+      continue;
+    }
+    if(!found)
+    {
+      break;
+    }
+    state->now = next;
+  }
+}
+
+/**Function to run the intersection over cars handed out by a source, writing the times of cars and the averages.
+*the approach heads are kept in a min heap keyed by time of arrival and rank, so each decision is O(log k) in the
+*number of approaches and this has a big O notation of N log k in the number of cars.
+*@pre source must hand out the cars of each direction sorted by time of arrival
+*@param source where the cars come from
+*@param config the junction, NULL for the four way intersection of INTERSECTION_DEFAULT_APPROACHES
+*@param compare function comparing the timeOfArrival of two cars
+*@param output where the results are written, it is flushed before returning
+*@param mode OUTPUT_CARS to write every car and the summary, OUTPUT_SUMMARY for only the summary, OUTPUT_MACHINE for a JSON summary
+*@param stats where the counts and waits of the run are left, may be NULL, its histograms have to be freed
+*@return the time the last car leaves the intersection
+**/
+SimTime simulateIntersection(CarSource *source, IntersectionConfig *config, int (*compare)(void *first,void *second), OutputBuffer *output, int mode, IntersectionStats *stats)
+{
+  IntersectionConfig defaultConfig;
+  EngineState state;
+  int heap[INTERSECTION_MAX_APPROACHES];
+  int heapSize = 0;
+  WaitBuffer waits;
+
+  if(config == NULL)
+  {
+    configureIntersection(&defaultConfig,NULL,NULL,1);
+    config = &defaultConfig;
+  }
+
+  waits.count = 0;
+  if(config->incremental != NULL)
+  {
+    state = *config->incremental;
+    config->incremental->totals.histograms = NULL;
+    takeHeads(source,config,&state,(1 << config->approaches) - 1);
+  }
+  else if(config->resume == NULL)
+  {
+//assigning the first of each direction to its respective head
+    clearEngineState(&state,config);
+    takeHeads(source,config,&state,(1 << config->approaches) - 1);
+  }
+  else if(resumeEngine(source,config,&state,output) != EXIT_SUCCESS)
+  {
+    fprintf(stderr,"the cars of the input are not the ones the checkpoint was taken from\n");
+    config->resume->failed = 1;
+    deleteWaitHistograms(state.totals.histograms);
+    state.totals.histograms = NULL;
+    if(stats != NULL)
+    {
+      *stats = state.totals;
+    }
+    return 0;
+  }
+
+  //a run that prints nothing has no use for windows
+  state.rollup = NULL;
+  if(config->window > 0 && output != NULL)
+  {
+    state.rollup = initializeRollup(config->window,config,output,mode);
+    if(state.rollup == NULL)
+    {
+      fprintf(stderr,"not enough memory for the windows, the run goes on without them\n");
+    }
+  }
+
+  if(config->shareBox)
+  {
+    simulateSharedBox(source,config,compare,&state,&waits,output,mode);
+  }
+  else
+  {
+    for(int i = 0; i < config->approaches; i++)
+    {
+      if(state.waiting & (1 << i))
+      {
+        pushApproach(heap,&heapSize,i,state.heads,config,compare);
+      }
+    }
+  }
+
+//sending the cars through one at a time
+  uint64_t checkpointAt = nextCheckpoint(config,state.served);
+  while(!config->shareBox && (heapSize > 0 || state.pending != 0))
+  {
+    if(state.served >= checkpointAt)
+    {
+      saveCheckpoint(config,&state,&waits,output,mode);
+      checkpointAt = nextCheckpoint(config,state.served);
+    }
+    //a pending approach may have a car arriving with the earliest head or before it, it is asked again first
+    if(state.pending != 0 && (heapSize == 0 || state.heads[heap[0]].timeOfArrival >= state.pendingUntil))
+    {
+      int waiting = state.waiting;
+      if(!takePending(source,config,&state))
+      {
+        break;
+      }
+      for(int i = 0; i < config->approaches; i++)
+      {
+        if((state.waiting & ~waiting) & (1 << i))
+        {
+          pushApproach(heap,&heapSize,i,state.heads,config,compare);
+        }
+      }
+      continue;
+    }
+    int approach = pickApproach(heap,&heapSize,state.heads,config,compare);
+    if(serveCar(source,config,&state,approach,&waits,output,mode))
+    {
+      pushApproach(heap,&heapSize,approach,state.heads,config,compare);
+    }
+    else
+    {
+      state.waiting = state.waiting & ~(1 << approach);
+    }
+    closeWindows(config,&state,approach);
+  }
+
+  //the windows still open are printed before the summary, none of them can get more cars
+  if(state.rollup != NULL)
+  {
+    closeRollup(state.rollup,INT64_MAX);
+    deleteRollup(state.rollup);
+    state.rollup = NULL;
+  }
+  addWaits(&state.totals,&waits);
+  if(config->incremental != NULL)
+  {
+    //kept before the shortest waits of approaches without cars are set to 0 for printing, the next run goes on from it
+    *config->incremental = state;
+  }
+  for(int i = 0; i < config->approaches; i++)
+  {
+    if(state.totals.amount[i] == 0)
+    {
+      state.totals.minWait[i] = 0;
+    }
+  }
+
+  printSummary(output,mode,config,&state.totals);
+  flushOutput(output);
+  if(stats != NULL)
+  {
+    *stats = state.totals;
+    if(config->incremental != NULL)
+    {
+      stats->histograms = NULL;
+    }
+  }
+  else if(config->incremental == NULL)
+  {
+    deleteWaitHistograms(state.totals.histograms);
+  }
+  return state.totals.timeCounter;
+}
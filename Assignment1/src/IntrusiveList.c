@@ -0,0 +1,174 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include "../include/IntrusiveList.h"
+#include "../include/Counters.h"
+
+/**Function to give the links inside a record.
+*@param list the list the record is for
+*@param record the record
+*@return its links
+**/
+static ListLinks *linksOf(IntrusiveList *list, void *record)
+{
+  return (ListLinks *)((char *)record + list->offset);
+}
+
+/**Function to give the record holding some links.
+*@param list the list the links are in
+*@param links the links, may be NULL
+*@return the record, NULL if links is NULL
+**/
+static void *recordOf(IntrusiveList *list, ListLinks *links)
+{
+  if(links == NULL)
+  {
+    return NULL;
+  }
+  return (char *)links - list->offset;
+}
+
+/**Function to make an empty intrusive list in memory the caller owns, nothing is allocated.
+*@param list the list
+*@param offset where the ListLinks are inside a record, offsetof(record type, links member)
+*@param compareFunction function pointer to compare two records in order to test for order, NULL if linkSorted is not used
+**/
+void initializeIntrusiveList(IntrusiveList *list, size_t offset, int (*compareFunction)(void *first,void *second))
+{
+  list->head = NULL;
+  list->tail = NULL;
+  list->offset = offset;
+  list->compare = compareFunction;
+}
+
+/**Function to put a record at the back of the list. This has a big O notation of 1.
+*@pre record is not in a list through the same links
+*@param list the list
+*@param record the record
+**/
+void linkBack(IntrusiveList *list, void *record)
+{
+  ListLinks *links = linksOf(list,record);
+
+  links->next = NULL;
+  links->previous = list->tail;
+  if(list->tail == NULL)
+  {
+    list->head = links;
+  }
+  else
+  {
+    list->tail->next = links;
+  }
+  list->tail = links;
+}
+
+/**Function to put a record in front of the first record of the list that is not smaller, the same place insertSorted
+*gives a List. This has a big O notation of n, but each step reads a single record.
+*@pre record is not in a list through the same links, the list was made with a compare function
+*@param list the list
+*@param record the record
+**/
+void linkSorted(IntrusiveList *list, void *record)
+{
+  ListLinks *links = linksOf(list,record);
+  ListLinks *linksToBeCompared = list->head;
+  unsigned long long visited = 0;  //records compared, for --stats
+
+  while(linksToBeCompared != NULL && (visited++, list->compare(recordOf(list,linksToBeCompared),record) < 0))
+  {
+    linksToBeCompared = linksToBeCompared->next;
+  }
+  COUNT_SCAN(visited);
+  COUNT(compares,visited);
+
+  if(linksToBeCompared == NULL)
+  {
+    linkBack(list,record);
+    return;
+  }
+
+  //adding in front of linksToBeCompared
+  links->next = linksToBeCompared;
+  links->previous = linksToBeCompared->previous;
+  if(linksToBeCompared->previous == NULL)
+  {
+    list->head = links;
+  }
+  else
+  {
+    linksToBeCompared->previous->next = links;
+  }
+  linksToBeCompared->previous = links;
+}
+
+/**Function to take a record out of the list. No compare function is called, this has a big O notation of 1.
+*@pre record is in the list
+*@param list the list
+*@param record the record, its links can be used for another list afterwards
+**/
+void unlinkRecord(IntrusiveList *list, void *record)
+{
+  ListLinks *links = linksOf(list,record);
+
+  if(links->previous == NULL)
+  {
+    list->head = links->next;
+  }
+  else
+  {
+    links->previous->next = links->next;
+  }
+  if(links->next == NULL)
+  {
+    list->tail = links->previous;
+  }
+  else
+  {
+    links->next->previous = links->previous;
+  }
+  links->previous = NULL;
+  links->next = NULL;
+}
+
+/**Function to take the record at the front out of the list.
+*@param list the list
+*@return the record, NULL if the list is empty
+**/
+void *unlinkFront(IntrusiveList *list)
+{
+  void *record = recordOf(list,list->head);
+  if(record != NULL)
+  {
+    unlinkRecord(list,record);
+  }
+  return record;
+}
+
+/**Function to give the record at the front of the list.
+*@param list the list
+*@return the record, NULL if the list is empty
+**/
+void *firstRecord(IntrusiveList *list)
+{
+  return recordOf(list,list->head);
+}
+
+/**Function to give the record after a record of the list.
+*@param list the list
+*@param record record of the list
+*@return the next record, NULL if record is the last
+**/
+void *nextRecord(IntrusiveList *list, void *record)
+{
+  return recordOf(list,linksOf(list,record)->next);
+}
+
+/**Function to give the record in front of a record of the list.
+*@param list the list
+*@param record record of the list
+*@return the previous record, NULL if record is the first
+**/
+void *previousRecord(IntrusiveList *list, void *record)
+{
+  return recordOf(list,linksOf(list,record)->previous);
+}
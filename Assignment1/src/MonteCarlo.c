@@ -0,0 +1,363 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <pthread.h>
+#include "../include/MonteCarlo.h"
+#include "../include/ThreadPool.h"
+#include "../include/Counters.h"
+#include "../include/main.h"
+
+/**
+ *One replicate handed to the pool, it only writes its own totals so the replicates share nothing but the pooled
+ *histograms, which are added to under the lock.
+ **/
+typedef struct replicateJob{
+    const GeneratorConfig *settings;
+    IntersectionConfig *config;
+    uint64_t replicate;
+    IntersectionStats *stats;
+    WaitHistograms *pooled;
+    pthread_mutex_t *lock;
+} ReplicateJob;
+
+/**Function to give the two sided 95% point of Student's t distribution, rounded down to the nearest degrees of
+*freedom in the table so the interval is never too narrow.
+*@param freedom degrees of freedom, at least 1
+**/
+static double studentT95(size_t freedom)
+{
+  static const double table[30] = {12.706,4.303,3.182,2.776,2.571,2.447,2.365,2.306,2.262,2.228,
+                                   2.201,2.179,2.160,2.145,2.131,2.120,2.110,2.101,2.093,2.086,
+                                   2.080,2.074,2.069,2.064,2.060,2.056,2.052,2.048,2.045,2.042};
+  if(freedom <= 30)
+  {
+    return table[freedom - 1];
+  }
+  if(freedom < 40)
+  {
+    return 2.042;
+  }
+  if(freedom < 60)
+  {
+    return 2.021;
+  }
+  if(freedom < 120)
+  {
+    return 2.000;
+  }
+  if(freedom < 1000)
+  {
+    return 1.980;
+  }
+  return 1.960;
+}
+
+/**Function run on the pool for one replicate, the cars are made as the intersection asks for them. The histograms of
+*the replicate are added to the pooled ones and freed, so only the running replicates hold any.
+*@param argument the ReplicateJob
+**/
+static void runReplicate(void *argument)
+{
+  ReplicateJob *job = argument;
+  CarGenerator generator;
+  PhaseTimer timer;
+
+  initializeGenerator(&generator,job->settings,job->config,job->replicate);
+  CarSource source = generatorSource(&generator);
+  START_PHASE(timer);
+  simulateIntersection(&source,job->config,compareTimeFunction,NULL,OUTPUT_SUMMARY,job->stats);
+  END_PHASE(PHASE_SIMULATE,timer);
+
+  if(job->stats->histograms != NULL)
+  {
+    pthread_mutex_lock(job->lock);
+    mergeWaitHistograms(job->pooled,job->stats->histograms);
+    pthread_mutex_unlock(job->lock);
+    deleteWaitHistograms(job->stats->histograms);
+    job->stats->histograms = NULL;
+  }
+}
+
+/**Function to simulate replicates of the generator on a thread pool, each one streaming its cars straight into the
+*intersection without storing them. Replicate r gives the same results whatever the number of threads.
+*@return the totals of each replicate in order, NULL if memory could not be allocated or the threads not started
+*@param settings what the cars look like
+*@param config the junction
+*@param replicates number of replicates, at least 1
+*@param threadCount number of threads, 0 for one per processor
+*@param pooled where the waits of every replicate are added when the junction keeps percentiles, may be NULL
+**/
+IntersectionStats *runReplicates(const GeneratorConfig *settings, IntersectionConfig *config, size_t replicates, int threadCount, WaitHistograms *pooled)
+{
+  pthread_mutex_t lock = PTHREAD_MUTEX_INITIALIZER;
+  IntersectionStats *runs = calloc(replicates,sizeof(IntersectionStats));
+  ReplicateJob *jobs = malloc(sizeof(ReplicateJob)*replicates);
+  if(runs == NULL || jobs == NULL)
+  {
+    free(runs);
+    free(jobs);
+    return NULL;
+  }
+
+  //no more threads than replicates
+  if(threadCount <= 0)
+  {
+    threadCount = processorCount();
+  }
+  if((size_t)threadCount > replicates)
+  {
+    threadCount = (int)replicates;
+  }
+  ThreadPool *pool = initializeThreadPool(threadCount);
+  if(pool == NULL)
+  {
+    free(runs);
+    free(jobs);
+    return NULL;
+  }
+
+  size_t submitted = 0;
+  for(size_t r = 0; r < replicates; r++)
+  {
+    jobs[r].settings = settings;
+    jobs[r].config = config;
+    jobs[r].replicate = r;
+    jobs[r].stats = &runs[r];
+    jobs[r].pooled = pooled;
+    jobs[r].lock = &lock;
+    if(submitTask(pool,runReplicate,&jobs[r]) != EXIT_SUCCESS)
+    {
+      break;
+    }
+    submitted++;
+  }
+  deleteThreadPool(pool);
+  pthread_mutex_destroy(&lock);
+  free(jobs);
+
+  if(submitted < replicates)
+  {
+    free(runs);
+    return NULL;
+  }
+  return runs;
+}
+
+/**Function to find the mean, standard deviation, 95% confidence interval and highest value of a result over the
+*replicates that have it.
+*@param values the result of each replicate
+*@param present 1 for the replicates that have the result, NULL when they all do
+*@param count number of replicates
+*@return the spread
+**/
+ReplicateSpread spreadOf(const double *values, const int *present, size_t count)
+{
+  ReplicateSpread spread;
+  double sum = 0.0;
+  double squares = 0.0;
+
+  spread.count = 0;
+  spread.highest = 0.0;
+  for(size_t i = 0; i < count; i++)
+  {
+    if(present == NULL || present[i])
+    {
+      if(spread.count == 0 || values[i] > spread.highest)
+      {
+        spread.highest = values[i];
+      }
+      spread.count++;
+      sum = sum + values[i];
+    }
+  }
+  spread.mean = (spread.count > 0) ? sum/spread.count : 0.0;
+
+  //second pass around the mean, the sum of squares minus the square of the sum loses everything to cancellation
+  for(size_t i = 0; i < count; i++)
+  {
+    if(present == NULL || present[i])
+    {
+      squares = squares + (values[i] - spread.mean)*(values[i] - spread.mean);
+    }
+  }
+  spread.deviation = 0.0;
+  spread.halfWidth = 0.0;
+  if(spread.count > 1)
+  {
+    spread.deviation = sqrt(squares/(spread.count - 1));
+    spread.halfWidth = studentT95(spread.count - 1)*spread.deviation/sqrt((double)spread.count);
+  }
+  return spread;
+}
+
+/**Function to print one result of the replicates as a line of the table.
+*@param output where the line goes
+*@param label what the result is
+*@param spread the result
+**/
+static void printSpreadLine(OutputBuffer *output, const char *label, ReplicateSpread spread)
+{
+  writeText(output,label);
+  writeChar(output,':');
+  writeFixed(output,spread.mean,9,2);
+  writeText(output," +/-");
+  writeFixed(output,spread.halfWidth,8,2);
+  writeText(output,"  sd");
+  writeFixed(output,spread.deviation,8,2);
+  writeText(output,"  highest");
+  writeFixed(output,spread.highest,9,2);
+  writeChar(output,'\n');
+}
+
+/**Function to print one result of the replicates as a JSON member.
+*@param output where the member goes
+*@param name name of the member
+*@param spread the result
+**/
+static void printSpreadJSON(OutputBuffer *output, const char *name, ReplicateSpread spread)
+{
+  writeText(output,",\"");
+  writeText(output,name);
+  writeText(output,"\":");
+  if(spread.count == 0)
+  {
+    writeText(output,"null");
+    return;
+  }
+  writeText(output,"{\"mean\":");
+  writeFixed(output,spread.mean,0,4);
+  writeText(output,",\"ci95\":");
+  writeFixed(output,spread.halfWidth,0,4);
+  writeText(output,",\"sd\":");
+  writeFixed(output,spread.deviation,0,4);
+  writeText(output,",\"highest\":");
+  writeFixed(output,spread.highest,0,4);
+  writeText(output,",\"replicates\":");
+  writeUnsigned(output,(unsigned long long)spread.count);
+  writeChar(output,'}');
+}
+
+/**Function to print the average and max wait of each approach and of the whole junction over the replicates,
+*followed by the percentiles of the waits of all replicates together.
+*@param output where the results are written
+*@param mode OUTPUT_MACHINE for one JSON line, a table otherwise
+*@param config the junction
+*@param runs the totals of each replicate
+*@param count number of replicates
+*@param pooled the waits of every replicate, NULL to print no percentiles
+**/
+void printReplicates(OutputBuffer *output, int mode, IntersectionConfig *config, IntersectionStats *runs, size_t count, const WaitHistograms *pooled)
+{
+  double *values = malloc(sizeof(double)*count);
+  int *present = malloc(sizeof(int)*count);
+  char letter[2];
+  char label[64];
+  if(values == NULL || present == NULL)
+  {
+    free(values);
+    free(present);
+    return;
+  }
+
+  if(mode == OUTPUT_MACHINE)
+  {
+    writeText(output,"{\"replicates\":");
+    writeUnsigned(output,(unsigned long long)count);
+  }
+  else
+  {
+    writeText(output,"replicates: ");
+    writeUnsigned(output,(unsigned long long)count);
+    writeText(output,", mean +/- half width of the 95% confidence interval\n");
+  }
+
+  for(size_t r = 0; r < count; r++)
+  {
+    double cars = 0.0;
+    for(int a = 0; a < config->approaches; a++)
+    {
+      cars = cars + runs[r].amount[a];
+    }
+    values[r] = cars;
+  }
+  if(mode == OUTPUT_MACHINE)
+  {
+    printSpreadJSON(output,"cars",spreadOf(values,NULL,count));
+  }
+  else
+  {
+    printSpreadLine(output,"cars",spreadOf(values,NULL,count));
+  }
+
+  for(int a = 0; a < config->approaches; a++)
+  {
+    const char *name = directionName(config->directions[a],letter);
+
+    for(size_t r = 0; r < count; r++)
+    {
+      present[r] = (runs[r].amount[a] != 0);
+      values[r] = present[r] ? secondsOf(runs[r].totalWait[a])/runs[r].amount[a] : 0.0;
+    }
+    ReplicateSpread average = spreadOf(values,present,count);
+    for(size_t r = 0; r < count; r++)
+    {
+      values[r] = secondsOf(runs[r].maxWait[a]);
+    }
+    ReplicateSpread highest = spreadOf(values,present,count);
+
+    if(mode == OUTPUT_MACHINE)
+    {
+      writeText(output,",\"");
+      writeText(output,name);
+      writeText(output,"\":{\"cars\":");
+      writeUnsigned(output,(unsigned long long)average.count);
+      printSpreadJSON(output,"averageWait",average);
+      printSpreadJSON(output,"maxWait",highest);
+      writeChar(output,'}');
+    }
+    else if(average.count > 0)
+    {
+      snprintf(label,sizeof(label),"average wait time for %s",name);
+      printSpreadLine(output,label,average);
+      snprintf(label,sizeof(label),"max wait time for %s",name);
+      printSpreadLine(output,label,highest);
+    }
+  }
+
+  for(size_t r = 0; r < count; r++)
+  {
+    double cars = 0.0;
+    SimTime wait = 0;
+    for(int a = 0; a < config->approaches; a++)
+    {
+      cars = cars + runs[r].amount[a];
+      wait = wait + runs[r].totalWait[a];
+    }
+    present[r] = (cars > 0.0);
+    values[r] = present[r] ? secondsOf(wait)/cars : 0.0;
+  }
+  ReplicateSpread average = spreadOf(values,present,count);
+  for(size_t r = 0; r < count; r++)
+  {
+    values[r] = secondsOf(runs[r].maxWaitTime);
+  }
+  ReplicateSpread highest = spreadOf(values,NULL,count);
+
+  if(mode == OUTPUT_MACHINE)
+  {
+    printSpreadJSON(output,"averageWait",average);
+    printSpreadJSON(output,"maxWait",highest);
+    printWaitPercentiles(output,mode,config,pooled);
+    writeText(output,"}\n");
+  }
+  else
+  {
+    printSpreadLine(output,"average wait time",average);
+    printSpreadLine(output,"Max wait time",highest);
+    printWaitPercentiles(output,mode,config,pooled);
+  }
+
+  free(values);
+  free(present);
+}
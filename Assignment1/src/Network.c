@@ -0,0 +1,985 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../include/Network.h"
+#include "../include/Parser.h"
+
+#define EVENT_DECIDE ((uint64_t)1 << 63)  //set in the order of a decision, so arrivals at the same time come first
+
+/**
+ *Event waiting on the calendar. target is a car for an arrival and an intersection for a decision, order breaks
+ *ties between events at the same time so they come out in the order they were scheduled.
+ **/
+typedef struct networkEvent{
+    SimTime time;
+    uint32_t target;
+    uint64_t order;
+} NetworkEvent;
+
+/**
+ *Global event calendar, a binary min heap on time and order.
+ **/
+typedef struct eventCalendar{
+    NetworkEvent *events;
+    size_t count;
+    size_t capacity;
+    uint64_t scheduled;
+} EventCalendar;
+
+/**
+ *FIFO of the cars waiting at one approach of an intersection, by their index in the entries.
+ **/
+typedef struct carIdQueue{
+    uint32_t *ids;
+    uint32_t first;
+    uint32_t count;
+    uint32_t capacity;
+} CarIdQueue;
+
+/**
+ *What an intersection is doing during a run and its totals.
+ **/
+typedef struct intersectionState{
+    SimTime busyUntil;
+    int waiting;
+    int decisionPending;
+    uint32_t amount;
+    SimTime totalWait;
+    SimTime maxWaitTime;
+} IntersectionState;
+
+/**Function to skip the spaces and tabs at text.
+*@param text where to start
+*@return the first character that is not a space or tab
+**/
+static char *skipBlanks(char *text)
+{
+  while(*text == ' ' || *text == '\t' || *text == '\r')
+  {
+    text++;
+  }
+  return text;
+}
+
+/**Function to read a whole number at text.
+*@param text where the number starts, blanks in front are skipped
+*@param value where the number is written
+*@return the first character after the number, NULL if there is no number
+**/
+static char *readNumber(char *text, uint32_t *value)
+{
+  char *end;
+  text = skipBlanks(text);
+  if(*text < '0' || *text > '9')
+  {
+    return NULL;
+  }
+  unsigned long number = strtoul(text,&end,10);
+  if(number > UINT32_MAX - 1)
+  {
+    return NULL;
+  }
+  *value = (uint32_t)number;
+  return end;
+}
+
+/**Function to read a time at text.
+*@param text where the time starts, blanks in front are skipped
+*@param value where the time is written
+*@return the first character after the time, NULL if there is no time
+**/
+static char *readTime(char *text, SimTime *value)
+{
+  text = skipBlanks(text);
+  return (char *)parseTime(text,text + strlen(text),value);
+}
+
+/**Function to read a direction letter of the junction at text.
+*@param text where the letter is, blanks in front are skipped
+*@param config the junction
+*@param approach where the approach of the letter is written
+*@return the first character after the letter, NULL if it is not an approach of the junction
+**/
+static char *readApproach(char *text, IntersectionConfig *config, int *approach)
+{
+  text = skipBlanks(text);
+  *approach = config->approachOf[(unsigned char)*text];
+  if(*approach < 0)
+  {
+    return NULL;
+  }
+  return text + 1;
+}
+
+/**Function to tell whether only blanks are left on a line.
+*@param text the rest of the line
+*@return 1 when nothing but blanks is left
+**/
+static int lineEnded(char *text)
+{
+  text = skipBlanks(text);
+  return *text == '\0' || *text == '\n';
+}
+
+/**Function to give the links of a network their memory once the number of intersections is known.
+*@param network the network
+*@param count number of intersections
+*@return EXIT_SUCCESS on success, EXIT_FAILURE if memory could not be allocated
+**/
+static int allocateLinks(Network *network, uint32_t count)
+{
+  size_t sides = (size_t)count*(size_t)network->config->approaches;
+  network->links = malloc(sizeof(NetworkLink)*(sides == 0 ? 1 : sides));
+  if(network->links == NULL)
+  {
+    return EXIT_FAILURE;
+  }
+  for(size_t i = 0; i < sides; i++)
+  {
+    network->links[i].to = NETWORK_NO_LINK;
+    network->links[i].approach = -1;
+    network->links[i].travelTime = 0;
+  }
+  network->count = count;
+  return EXIT_SUCCESS;
+}
+
+/**Function to link a grid of N, E, S, W intersections to their neighbours.
+*@param network the network, with rows*columns intersections
+*@param rows rows of the grid, north to south
+*@param columns columns of the grid, west to east
+*@param travelTime time to drive from one intersection to the next
+**/
+static void linkGrid(Network *network, uint32_t rows, uint32_t columns, SimTime travelTime)
+{
+  IntersectionConfig *config = network->config;
+  int north = config->approachOf['N'];
+  int east = config->approachOf['E'];
+  int south = config->approachOf['S'];
+  int west = config->approachOf['W'];
+  int k = config->approaches;
+
+  for(uint32_t row = 0; row < rows; row++)
+  {
+    for(uint32_t column = 0; column < columns; column++)
+    {
+      NetworkLink *links = &network->links[(size_t)(row*columns + column)*k];
+      //leaving on the north side arrives at the south approach of the intersection above, and so on
+      if(row > 0)
+      {
+        links[north].to = (row - 1)*columns + column;
+        links[north].approach = south;
+        links[north].travelTime = travelTime;
+      }
+      if(row + 1 < rows)
+      {
+        links[south].to = (row + 1)*columns + column;
+        links[south].approach = north;
+        links[south].travelTime = travelTime;
+      }
+      if(column > 0)
+      {
+        links[west].to = row*columns + column - 1;
+        links[west].approach = east;
+        links[west].travelTime = travelTime;
+      }
+      if(column + 1 < columns)
+      {
+        links[east].to = row*columns + column + 1;
+        links[east].approach = west;
+        links[east].travelTime = travelTime;
+      }
+    }
+  }
+}
+
+/**Function to read the layout of a network. Each line is one of
+*  intersections <count>
+*  link <from> <side> <to> <approach> <travel time>
+*  grid <rows> <columns> <travel time>
+*where the sides and approaches are direction letters of the junction, and grid links every intersection of a
+*rows by columns grid of N, E, S, W intersections to its neighbours. Blank lines and lines starting with # are skipped.
+*@return the network, NULL if the file could not be read or is not valid, the reason is printed on stderr
+*@param fileName path of the network file
+*@param config layout of every intersection, it must live as long as the network
+**/
+Network *readNetwork(const char *fileName, IntersectionConfig *config)
+{
+  char line[1024];
+  size_t lineNumber = 0;
+  const char *error = NULL;
+
+  FILE *fp = fopen(fileName,"r");
+  if(fp == NULL)
+  {
+    return NULL;
+  }
+
+  Network *newNetwork = malloc(sizeof(Network)*1);
+  if(newNetwork == NULL)
+  {
+    fclose(fp);
+    return NULL;
+  }
+  newNetwork->config = config;
+  newNetwork->count = 0;
+  newNetwork->links = NULL;
+
+  while(error == NULL && fgets(line,sizeof(line),fp) != NULL)
+  {
+    char *position = skipBlanks(line);
+    lineNumber++;
+
+    if(*position == '#' || lineEnded(position))
+    {
+      continue;
+    }
+
+    if(strncmp(position,"intersections",13) == 0)
+    {
+      uint32_t count;
+      position = readNumber(position + 13,&count);
+      if(position == NULL || !lineEnded(position) || count == 0)
+      {
+        error = "expected intersections <count>";
+      }
+      else if(newNetwork->links != NULL)
+      {
+        error = "the number of intersections is already known";
+      }
+      else if(allocateLinks(newNetwork,count) != EXIT_SUCCESS)
+      {
+        error = "not enough memory for the intersections";
+      }
+    }
+    else if(strncmp(position,"grid",4) == 0)
+    {
+      uint32_t rows;
+      uint32_t columns;
+      SimTime travelTime;
+      position = readNumber(position + 4,&rows);
+      position = (position == NULL) ? NULL : readNumber(position,&columns);
+      position = (position == NULL) ? NULL : readTime(position,&travelTime);
+      if(position == NULL || !lineEnded(position) || rows == 0 || columns == 0 || (uint64_t)rows*columns >= NETWORK_NO_LINK)
+      {
+        error = "expected grid <rows> <columns> <travel time>";
+      }
+      else if(config->approachOf['N'] < 0 || config->approachOf['E'] < 0 || config->approachOf['S'] < 0 || config->approachOf['W'] < 0)
+      {
+        error = "a grid needs intersections with N, E, S and W approaches";
+      }
+      else if(newNetwork->links == NULL && allocateLinks(newNetwork,rows*columns) != EXIT_SUCCESS)
+      {
+        error = "not enough memory for the intersections";
+      }
+      else if(newNetwork->count != rows*columns)
+      {
+        error = "the grid does not have the number of intersections of the network";
+      }
+      else
+      {
+        linkGrid(newNetwork,rows,columns,travelTime);
+      }
+    }
+    else if(strncmp(position,"link",4) == 0)
+    {
+      uint32_t from;
+      uint32_t to;
+      int side;
+      int approach;
+      SimTime travelTime;
+      position = readNumber(position + 4,&from);
+      position = (position == NULL) ? NULL : readApproach(position,config,&side);
+      position = (position == NULL) ? NULL : readNumber(position,&to);
+      position = (position == NULL) ? NULL : readApproach(position,config,&approach);
+      position = (position == NULL) ? NULL : readTime(position,&travelTime);
+      if(position == NULL || !lineEnded(position) || travelTime < 0)
+      {
+        error = "expected link <from> <side> <to> <approach> <travel time>";
+      }
+      else if(newNetwork->links == NULL)
+      {
+        error = "the number of intersections has to be given before the links";
+      }
+      else if(from >= newNetwork->count || to >= newNetwork->count)
+      {
+        error = "no such intersection";
+      }
+      else
+      {
+        NetworkLink *link = &newNetwork->links[(size_t)from*config->approaches + side];
+        link->to = to;
+        link->approach = approach;
+        link->travelTime = travelTime;
+      }
+    }
+    else
+    {
+      error = "expected intersections, grid or link";
+    }
+  }
+  fclose(fp);
+
+  if(error == NULL && newNetwork->links == NULL)
+  {
+    error = "the network has no intersections";
+  }
+  if(error != NULL)
+  {
+    fprintf(stderr,"%s:%lu: %s\n",fileName,(unsigned long)lineNumber,error);
+    deleteNetwork(newNetwork);
+    return NULL;
+  }
+  return newNetwork;
+}
+
+/**Function to sort cars by time of entry with a bottom up merge sort, which keeps cars entering at the same time in order.
+*@param cars the cars to sort
+*@param count number of cars
+*@return EXIT_SUCCESS on success, EXIT_FAILURE if memory could not be allocated
+**/
+static int sortEntries(NetworkCar *cars, size_t count)
+{
+  NetworkCar *buffer = malloc(sizeof(NetworkCar)*(count == 0 ? 1 : count));
+  NetworkCar *from = cars;
+  NetworkCar *to = buffer;
+  NetworkCar *swap;
+
+  if(buffer == NULL)
+  {
+    return EXIT_FAILURE;
+  }
+
+  for(size_t width = 1; width < count; width = width*2)
+  {
+    for(size_t left = 0; left < count; left = left + 2*width)
+    {
+      size_t middle = (left + width < count) ? left + width : count;
+      size_t right = (left + 2*width < count) ? left + 2*width : count;
+      size_t i = left;
+      size_t j = middle;
+      size_t k = left;
+      while(i < middle && j < right)
+      {
+        to[k++] = (from[j].entryTime < from[i].entryTime) ? from[j++] : from[i++];
+      }
+      while(i < middle)
+      {
+        to[k++] = from[i++];
+      }
+      while(j < right)
+      {
+        to[k++] = from[j++];
+      }
+    }
+    swap = from;
+    from = to;
+    to = swap;
+  }
+
+  if(from != cars)
+  {
+    memcpy(cars,from,sizeof(NetworkCar)*count);
+  }
+  free(buffer);
+  return EXIT_SUCCESS;
+}
+
+/**Function to read the cars entering a network, one per line as "<intersection> <approach> <turns> <time>",
+*turns being the turn the car makes at each intersection of its route, like "FFR". Lines that are not valid are
+*reported with their line number and skipped. The cars are sorted by time of entry, cars entering at the same
+*time are kept in the order a sorted List would keep them.
+*@return the entries, NULL if the file could not be opened or memory could not be allocated
+*@param fileName path of the entries file
+*@param network the network the cars enter
+**/
+NetworkEntries *readNetworkEntries(const char *fileName, Network *network)
+{
+  char line[4096];
+  size_t lineNumber = 0;
+  size_t carCapacity = 0;
+  size_t routeCapacity = 0;
+  int failed = 0;
+
+  FILE *fp = fopen(fileName,"r");
+  if(fp == NULL)
+  {
+    return NULL;
+  }
+
+  NetworkEntries *newEntries = malloc(sizeof(NetworkEntries)*1);
+  if(newEntries == NULL)
+  {
+    fclose(fp);
+    return NULL;
+  }
+  newEntries->cars = NULL;
+  newEntries->count = 0;
+  newEntries->routes = NULL;
+  newEntries->routesUsed = 0;
+
+  while(!failed && fgets(line,sizeof(line),fp) != NULL)
+  {
+    char *position = skipBlanks(line);
+    uint32_t intersection;
+    int approach;
+    char *turns;
+    size_t turnCount = 0;
+    SimTime entryTime;
+    const char *error = NULL;
+
+    lineNumber++;
+    if(lineEnded(position))
+    {
+      continue;
+    }
+
+    position = readNumber(position,&intersection);
+    position = (position == NULL) ? NULL : readApproach(position,network->config,&approach);
+    if(position != NULL)
+    {
+      turns = skipBlanks(position);
+      while(turns[turnCount] == 'F' || turns[turnCount] == 'R' || turns[turnCount] == 'L')
+      {
+        turnCount++;
+      }
+      position = readTime(turns + turnCount,&entryTime);
+    }
+    if(position == NULL || !lineEnded(position))
+    {
+      error = "expected <intersection> <approach> <turns> <time>";
+    }
+    else if(intersection >= network->count)
+    {
+      error = "no such intersection";
+    }
+    else if(turnCount == 0 || turnCount > UINT16_MAX)
+    {
+      error = "the route must have 1 to 65535 turns, each one of F, R, L";
+    }
+    if(error != NULL)
+    {
+      char *lineEnd = line + strlen(line);
+      while(lineEnd > line && (lineEnd[-1] == '\n' || lineEnd[-1] == '\r'))
+      {
+        lineEnd--;
+      }
+      fprintf(stderr,"%s:%lu: %s: \"%.*s\"\n",fileName,(unsigned long)lineNumber,error,(int)(lineEnd - line),line);
+      continue;
+    }
+
+    //growing the cars and the route pool by doubling
+    if(newEntries->count == carCapacity)
+    {
+      carCapacity = (carCapacity == 0) ? 1024 : carCapacity*2;
+      NetworkCar *newCars = realloc(newEntries->cars,sizeof(NetworkCar)*carCapacity);
+      if(newCars == NULL)
+      {
+        failed = 1;
+        break;
+      }
+      newEntries->cars = newCars;
+    }
+    if(newEntries->routesUsed + turnCount > routeCapacity)
+    {
+      while(newEntries->routesUsed + turnCount > routeCapacity)
+      {
+        routeCapacity = (routeCapacity == 0) ? 4096 : routeCapacity*2;
+      }
+      char *newRoutes = (routeCapacity > UINT32_MAX) ? NULL : realloc(newEntries->routes,routeCapacity);
+      if(newRoutes == NULL)
+      {
+        failed = 1;
+        break;
+      }
+      newEntries->routes = newRoutes;
+    }
+
+    NetworkCar *car = &newEntries->cars[newEntries->count++];
+    car->car.travelDirection = network->config->directions[approach];
+    car->car.turnDirection = turns[0];
+    car->car.timeOfArrival = entryTime;
+    car->intersection = intersection;
+    car->route = (uint32_t)newEntries->routesUsed;
+    car->routeLength = (uint16_t)turnCount;
+    car->step = 0;
+    car->entryTime = entryTime;
+    memcpy(newEntries->routes + newEntries->routesUsed,turns,turnCount);
+    newEntries->routesUsed = newEntries->routesUsed + turnCount;
+  }
+  fclose(fp);
+
+  //like insertSortedBulk, cars entering at the same time end up last read first
+  if(!failed)
+  {
+    for(size_t i = 0; i < newEntries->count/2; i++)
+    {
+      NetworkCar swap = newEntries->cars[i];
+      newEntries->cars[i] = newEntries->cars[newEntries->count - 1 - i];
+      newEntries->cars[newEntries->count - 1 - i] = swap;
+    }
+    failed = (sortEntries(newEntries->cars,newEntries->count) != EXIT_SUCCESS);
+  }
+  if(failed || newEntries->count >= NETWORK_NO_LINK)
+  {
+    fprintf(stderr,"not enough memory for the cars entering the network\n");
+    deleteNetworkEntries(newEntries);
+    return NULL;
+  }
+  return newEntries;
+}
+
+/**Function to tell whether one event comes before another.
+*@param first the first event
+*@param second the second event
+*@return 1 when first is earlier, or at the same time and scheduled first
+**/
+static int eventBefore(NetworkEvent *first, NetworkEvent *second)
+{
+  if(first->time != second->time)
+  {
+    return first->time < second->time;
+  }
+  return first->order < second->order;
+}
+
+/**Function to put an event on the calendar. This has a big O notation of log C.
+*@param calendar the calendar
+*@param time when the event happens
+*@param target car of an arrival, intersection of a decision
+*@param decision 1 for a decision, 0 for an arrival
+*@return EXIT_SUCCESS on success, EXIT_FAILURE if memory could not be allocated
+**/
+static int scheduleEvent(EventCalendar *calendar, SimTime time, uint32_t target, int decision)
+{
+  if(calendar->count == calendar->capacity)
+  {
+    size_t newCapacity = (calendar->capacity == 0) ? 1024 : calendar->capacity*2;
+    NetworkEvent *newEvents = realloc(calendar->events,sizeof(NetworkEvent)*newCapacity);
+    if(newEvents == NULL)
+    {
+      return EXIT_FAILURE;
+    }
+    calendar->events = newEvents;
+    calendar->capacity = newCapacity;
+  }
+
+  NetworkEvent event;
+  event.time = time;
+  event.target = target;
+  event.order = calendar->scheduled++ | (decision ? EVENT_DECIDE : 0);
+
+  size_t position = calendar->count++;
+  while(position > 0)
+  {
+    size_t parent = (position - 1)/2;
+    if(!eventBefore(&event,&calendar->events[parent]))
+    {
+      break;
+    }
+    calendar->events[position] = calendar->events[parent];
+    position = parent;
+  }
+  calendar->events[position] = event;
+  return EXIT_SUCCESS;
+}
+
+/**Function to take the earliest event off the calendar. This has a big O notation of log C.
+*@pre the calendar must not be empty
+*@param calendar the calendar
+*@return the event
+**/
+static NetworkEvent nextEvent(EventCalendar *calendar)
+{
+  NetworkEvent top = calendar->events[0];
+  NetworkEvent last = calendar->events[--calendar->count];
+  size_t position = 0;
+
+  while(2*position + 1 < calendar->count)
+  {
+    size_t child = 2*position + 1;
+    if(child + 1 < calendar->count && eventBefore(&calendar->events[child + 1],&calendar->events[child]))
+    {
+      child++;
+    }
+    if(!eventBefore(&calendar->events[child],&last))
+    {
+      break;
+    }
+    calendar->events[position] = calendar->events[child];
+    position = child;
+  }
+  calendar->events[position] = last;
+  return top;
+}
+
+/**Function to add a car to the back of an approach queue.
+*@param queue the queue
+*@param id index of the car in the entries
+*@return EXIT_SUCCESS on success, EXIT_FAILURE if memory could not be allocated
+**/
+static int pushCarId(CarIdQueue *queue, uint32_t id)
+{
+  //doubling the ring when it is full, unwrapping it into the new memory
+  if(queue->count == queue->capacity)
+  {
+    uint32_t newCapacity = (queue->capacity == 0) ? 8 : queue->capacity*2;
+    uint32_t *newIds = malloc(sizeof(uint32_t)*newCapacity);
+    if(newIds == NULL)
+    {
+      return EXIT_FAILURE;
+    }
+    for(uint32_t i = 0; i < queue->count; i++)
+    {
+      newIds[i] = queue->ids[(queue->first + i) % queue->capacity];
+    }
+    free(queue->ids);
+    queue->ids = newIds;
+    queue->first = 0;
+    queue->capacity = newCapacity;
+  }
+  queue->ids[(queue->first + queue->count) % queue->capacity] = id;
+  queue->count++;
+  return EXIT_SUCCESS;
+}
+
+/**Function to remove the car at the front of an approach queue.
+*@pre the queue must not be empty
+*@param queue the queue
+*@return index of the car
+**/
+static uint32_t popCarId(CarIdQueue *queue)
+{
+  uint32_t id = queue->ids[queue->first];
+  queue->first = (queue->first + 1) % queue->capacity;
+  queue->count--;
+  return id;
+}
+
+/**Function to pick the approach of an intersection whose car goes next, the same way simulateIntersection does.
+*@pre the intersection must have a car waiting
+*@param config the junction
+*@param queues the approach queues of the intersection
+*@param cars every car of the run
+*@param compare function comparing the timeOfArrival of two cars
+*@return the approach that goes next
+**/
+static int pickNetworkApproach(IntersectionConfig *config, CarIdQueue *queues, NetworkCar *cars, int (*compare)(void *first,void *second))
+{
+  Data heads[INTERSECTION_MAX_APPROACHES];
+  int earliest = -1;
+  int tied = 0;
+
+  for(int i = 0; i < config->approaches; i++)
+  {
+    if(queues[i].count == 0)
+    {
+      continue;
+    }
+    heads[i] = cars[queues[i].ids[queues[i].first]].car;
+    int result = (earliest < 0) ? -1 : compare(&heads[i],&heads[earliest]);
+    if(result < 0)
+    {
+      earliest = i;
+      tied = 1 << i;
+    }
+    else if(result == 0)
+    {
+      tied = tied | (1 << i);
+    }
+  }
+
+  if(tied == (1 << earliest))
+  {
+    return earliest;
+  }
+  return resolveTie(config,tied,heads);
+}
+
+/**Function to print the totals of one intersection.
+*@param output where the line goes
+*@param index number of the intersection
+*@param state the intersection
+**/
+static void printIntersectionLine(OutputBuffer *output, uint32_t index, IntersectionState *state)
+{
+  writeText(output,"intersection ");
+  writeUnsigned(output,index);
+  writeText(output,": cars ");
+  writeUnsigned(output,state->amount);
+  if(state->amount != 0)
+  {
+    writeText(output,", average wait ");
+    writeAverageTime(output,state->totalWait,state->amount,0,2);
+    writeText(output,", max wait ");
+    writeTime(output,state->maxWaitTime,0,2);
+  }
+  writeChar(output,'\n');
+}
+
+/**Function to print the totals of a network run.
+*@param output where the lines go
+*@param mode OUTPUT_CARS and OUTPUT_SUMMARY print lines of text, OUTPUT_MACHINE prints one line of JSON
+*@param stats the totals
+**/
+static void printNetworkSummary(OutputBuffer *output, int mode, NetworkStats *stats)
+{
+  if(mode == OUTPUT_MACHINE)
+  {
+    writeText(output,"{\"cars\":");
+    writeUnsigned(output,stats->carsEntered);
+    writeText(output,",\"passes\":");
+    writeUnsigned(output,stats->passes);
+    writeText(output,",\"events\":");
+    writeUnsigned(output,stats->events);
+    writeText(output,",\"averageWait\":");
+    if(stats->passes != 0)
+    {
+      writeAverageTime(output,stats->totalWait,stats->passes,0,2);
+    }
+    else
+    {
+      writeText(output,"null");
+    }
+    writeText(output,",\"averageTrip\":");
+    if(stats->carsExited != 0)
+    {
+      writeAverageTime(output,stats->totalTripTime,stats->carsExited,0,2);
+    }
+    else
+    {
+      writeText(output,"null");
+    }
+    writeText(output,",\"maxWait\":");
+    writeTime(output,stats->maxWaitTime,0,2);
+    writeText(output,",\"endTime\":");
+    writeTime(output,stats->endTime,0,2);
+    writeText(output,"}\n");
+    return;
+  }
+
+  writeText(output,"cars:");
+  writeUnsigned(output,stats->carsEntered);
+  writeText(output,"\nintersections crossed:");
+  writeUnsigned(output,stats->passes);
+  writeText(output,"\nevents:");
+  writeUnsigned(output,stats->events);
+  writeChar(output,'\n');
+  if(stats->passes != 0)
+  {
+    writeText(output,"average wait time:");
+    writeAverageTime(output,stats->totalWait,stats->passes,6,2);
+    writeChar(output,'\n');
+  }
+  if(stats->carsExited != 0)
+  {
+    writeText(output,"average trip time:");
+    writeAverageTime(output,stats->totalTripTime,stats->carsExited,6,2);
+    writeChar(output,'\n');
+  }
+  writeText(output,"Max wait time:");
+  writeTime(output,stats->maxWaitTime,6,2);
+  writeChar(output,'\n');
+}
+
+/**Function to run the network with a global event calendar. A car arriving at an intersection joins the queue of
+*its approach, and an intersection that is free decides which car goes next the same way simulateIntersection does,
+*once every car arriving at that time has joined its queue. This has a big O notation of E log C, E the number of
+*events and C the most events waiting on the calendar.
+*@pre entries must have been read for this network, their cars are moved through it
+*@param network the network
+*@param entries the cars entering the network
+*@param compare function comparing the timeOfArrival of two cars
+*@param output where the results are written, it is flushed before returning
+*@param mode OUTPUT_CARS for a line per intersection and the totals, OUTPUT_SUMMARY for the totals, OUTPUT_MACHINE for a JSON summary
+*@param stats where the totals of the run are left, may be NULL
+*@return the time the last car leaves an intersection
+**/
+SimTime simulateNetwork(Network *network, NetworkEntries *entries, int (*compare)(void *first,void *second), OutputBuffer *output, int mode, NetworkStats *stats)
+{
+  IntersectionConfig *config = network->config;
+  int k = config->approaches;
+  NetworkStats localStats;
+  EventCalendar calendar;
+  size_t nextEntry = 0;
+  int failed = 0;
+
+  if(stats == NULL)
+  {
+    stats = &localStats;
+  }
+  memset(stats,0,sizeof(NetworkStats));
+  calendar.events = NULL;
+  calendar.count = 0;
+  calendar.capacity = 0;
+  calendar.scheduled = 0;
+
+  IntersectionState *states = calloc(network->count,sizeof(IntersectionState));
+  CarIdQueue *queues = calloc((size_t)network->count*k,sizeof(CarIdQueue));
+  if(states == NULL || queues == NULL)
+  {
+    fprintf(stderr,"not enough memory for the intersections\n");
+    free(states);
+    free(queues);
+    return 0;
+  }
+
+  while(!failed && (nextEntry < entries->count || calendar.count > 0))
+  {
+    NetworkEvent event;
+
+    //cars entering the network are merged in from the sorted entries instead of waiting on the calendar
+    if(nextEntry < entries->count && (calendar.count == 0 || entries->cars[nextEntry].entryTime <= calendar.events[0].time))
+    {
+      event.time = entries->cars[nextEntry].entryTime;
+      event.target = (uint32_t)nextEntry;
+      event.order = 0;
+      nextEntry++;
+      stats->carsEntered++;
+    }
+    else
+    {
+      event = nextEvent(&calendar);
+    }
+    stats->events++;
+
+    if(!(event.order & EVENT_DECIDE))
+    {
+      //a car joins the queue of its approach, the intersection decides once everything at this time has arrived
+      NetworkCar *car = &entries->cars[event.target];
+      IntersectionState *state = &states[car->intersection];
+      int approach = config->approachOf[(unsigned char)car->car.travelDirection];
+      if(pushCarId(&queues[(size_t)car->intersection*k + approach],event.target) != EXIT_SUCCESS)
+      {
+        failed = 1;
+        break;
+      }
+      state->waiting++;
+      if(!state->decisionPending)
+      {
+        state->decisionPending = 1;
+        SimTime decisionTime = (state->busyUntil > event.time) ? state->busyUntil : event.time;
+        failed = (scheduleEvent(&calendar,decisionTime,car->intersection,1) != EXIT_SUCCESS);
+      }
+    }
+    else
+    {
+      //the intersection is free, the car picked goes through and drives on to the next intersection of its route
+      uint32_t index = event.target;
+      IntersectionState *state = &states[index];
+      CarIdQueue *intersectionQueues = &queues[(size_t)index*k];
+      int approach = pickNetworkApproach(config,intersectionQueues,entries->cars,compare);
+      uint32_t id = popCarId(&intersectionQueues[approach]);
+      NetworkCar *car = &entries->cars[id];
+      SimTime timeCounter = state->busyUntil;
+      SimTime waitTime;
+
+      if(timeCounter < car->car.timeOfArrival)
+      {
+        timeCounter = car->car.timeOfArrival;
+      }
+      waitTime = timeCounter - car->car.timeOfArrival;
+      if(state->maxWaitTime < waitTime)
+      {
+        state->maxWaitTime = waitTime;
+      }
+      if(stats->maxWaitTime < waitTime)
+      {
+        stats->maxWaitTime = waitTime;
+      }
+      state->totalWait = state->totalWait + waitTime;
+      state->amount++;
+      stats->totalWait = stats->totalWait + waitTime;
+      stats->passes++;
+      timeCounter = timeCounter + turnTime(&car->car);
+      state->busyUntil = timeCounter;
+      state->waiting--;
+      if(stats->endTime < timeCounter)
+      {
+        stats->endTime = timeCounter;
+      }
+
+      //the side the car leaves on, then the road from that side
+      int side = exitSide(config,approach,car->car.turnDirection);
+      NetworkLink *link = &network->links[(size_t)index*k + side];
+      car->step++;
+      if(car->step < car->routeLength && link->to != NETWORK_NO_LINK)
+      {
+        car->intersection = link->to;
+        car->car.travelDirection = config->directions[link->approach];
+        car->car.turnDirection = entries->routes[car->route + car->step];
+        car->car.timeOfArrival = timeCounter + link->travelTime;
+        failed = (scheduleEvent(&calendar,car->car.timeOfArrival,id,0) != EXIT_SUCCESS);
+      }
+      else
+      {
+        stats->carsExited++;
+        stats->totalTripTime = stats->totalTripTime + (timeCounter - car->entryTime);
+      }
+
+      if(!failed && state->waiting > 0)
+      {
+        failed = (scheduleEvent(&calendar,timeCounter,index,1) != EXIT_SUCCESS);
+      }
+      else
+      {
+        state->decisionPending = 0;
+      }
+    }
+
+    if(calendar.count > stats->peakCalendar)
+    {
+      stats->peakCalendar = calendar.count;
+    }
+  }
+  if(failed)
+  {
+    fprintf(stderr,"not enough memory for the events of the network\n");
+  }
+
+  if(mode == OUTPUT_CARS)
+  {
+    for(uint32_t i = 0; i < network->count; i++)
+    {
+      printIntersectionLine(output,i,&states[i]);
+    }
+  }
+  printNetworkSummary(output,mode,stats);
+  flushOutput(output);
+
+  for(size_t i = 0; i < (size_t)network->count*k; i++)
+  {
+    free(queues[i].ids);
+  }
+  free(queues);
+  free(states);
+  free(calendar.events);
+  return stats->endTime;
+}
+
+/**Function to free the entries.
+*@param entries the entries to be deleted
+**/
+void deleteNetworkEntries(NetworkEntries *entries)
+{
+  if(entries == NULL)
+  {
+    return;
+  }
+  free(entries->cars);
+  free(entries->routes);
+  free(entries);
+}
+
+/**Function to free the network, its config is not freed.
+*@param network the network to be deleted
+**/
+void deleteNetwork(Network *network)
+{
+  if(network == NULL)
+  {
+    return;
+  }
+  free(network->links);
+  free(network);
+}
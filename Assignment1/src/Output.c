@@ -0,0 +1,274 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../include/Output.h"
+#include "../include/Counters.h"
+
+//powers of ten used to move the decimals in front of the decimal point
+static const double powersOfTen[] = {
+  1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9
+};
+
+/**Function to create a writer for a file.
+*@return pointer to the writer, NULL if memory could not be allocated
+*@param fp file the text goes to, it is not closed by the writer, NULL to keep all the text in memory
+*@param capacity bytes collected before they are written, 0 for OUTPUT_DEFAULT_CAPACITY
+**/
+OutputBuffer *initializeOutput(FILE *fp, size_t capacity)
+{
+  OutputBuffer *newOutput = malloc(sizeof(OutputBuffer)*1);
+  if(newOutput == NULL)
+  {
+    return NULL;
+  }
+
+  //a buffer of at least 64 bytes always has room for one formatted number
+  newOutput->capacity = (capacity == 0) ? OUTPUT_DEFAULT_CAPACITY : capacity;
+  if(newOutput->capacity < 64)
+  {
+    newOutput->capacity = 64;
+  }
+  newOutput->buffer = malloc(newOutput->capacity);
+  if(newOutput->buffer == NULL)
+  {
+    free(newOutput);
+    return NULL;
+  }
+  newOutput->fp = fp;
+  newOutput->used = 0;
+  newOutput->written = 0;
+  newOutput->discarding = 0;
+  return newOutput;
+}
+
+/**Function to double the buffer of a writer that keeps its text in memory.
+*@param output the writer, its fp is NULL
+*@return EXIT_SUCCESS on success, EXIT_FAILURE if memory could not be allocated
+**/
+static int growOutput(OutputBuffer *output)
+{
+  char *newBuffer = realloc(output->buffer,output->capacity*2);
+  if(newBuffer == NULL)
+  {
+    return EXIT_FAILURE;
+  }
+  output->buffer = newBuffer;
+  output->capacity = output->capacity*2;
+  return EXIT_SUCCESS;
+}
+
+/**Function to make room for some bytes, handing the buffer to the file when it is too full.
+*a writer without a file grows instead, text that does not fit when memory runs out is dropped from the front.
+*@param output the writer
+*@param length number of bytes about to be added, at most 64
+**/
+static void reserve(OutputBuffer *output, size_t length)
+{
+  if(output->capacity - output->used < length)
+  {
+    if(output->fp == NULL && growOutput(output) == EXIT_SUCCESS)
+    {
+      return;
+    }
+    flushOutput(output);
+    if(output->fp == NULL)
+    {
+      output->used = 0;
+    }
+  }
+}
+
+/**Function to add a string to the writer.
+*@param output the writer
+*@param text string to add
+**/
+void writeText(OutputBuffer *output, const char *text)
+{
+  if(output == NULL || text == NULL)
+  {
+    return;
+  }
+
+  size_t length = strlen(text);
+  while(length > 0)
+  {
+    if(output->used == output->capacity)
+    {
+      reserve(output,1);
+    }
+    size_t room = output->capacity - output->used;
+    size_t part = (length < room) ? length : room;
+    memcpy(output->buffer + output->used,text,part);
+    output->used = output->used + part;
+    text = text + part;
+    length = length - part;
+  }
+}
+
+/**Function to add a single character to the writer.
+*@param output the writer
+*@param c character to add
+**/
+void writeChar(OutputBuffer *output, char c)
+{
+  if(output == NULL)
+  {
+    return;
+  }
+  reserve(output,1);
+  output->buffer[output->used++] = c;
+}
+
+/**Function to add an unsigned whole number to the writer.
+*@param output the writer
+*@param value number to add
+**/
+void writeUnsigned(OutputBuffer *output, unsigned long long value)
+{
+  char digits[24];
+  int length = 0;
+
+  if(output == NULL)
+  {
+    return;
+  }
+
+  //digits come out last to first
+  do
+  {
+    digits[length++] = (char)('0' + value % 10);
+    value = value/10;
+  }while(value > 0);
+
+  reserve(output,(size_t)length);
+  while(length > 0)
+  {
+    output->buffer[output->used++] = digits[--length];
+  }
+}
+
+/**Function to add a number with a fixed amount of decimals, right aligned, the same as printf("%*.*f").
+*rounding matches printf exactly for values that came from a float.
+*@param output the writer
+*@param value number to add
+*@param width minimum number of characters, padded with spaces on the left
+*@param decimals digits after the decimal point
+**/
+void writeFixed(OutputBuffer *output, double value, int width, int decimals)
+{
+  char digits[64];
+  int length = 0;
+  int negative = 0;
+
+  if(output == NULL)
+  {
+    return;
+  }
+
+  //anything the whole number part can not hold goes through printf
+  if(decimals < 0 || decimals > 9 || width > 40 || !(value > -9e15/powersOfTen[decimals] && value < 9e15/powersOfTen[decimals]))
+  {
+    char text[512];
+    snprintf(text,sizeof(text),"%*.*f",width,decimals,value);
+    writeText(output,text);
+    return;
+  }
+
+  if(value < 0 || (value == 0 && 1/value < 0))
+  {
+    negative = 1;
+    value = -value;
+  }
+
+  //a float times a power of ten up to 10^9 is exact in a double, so only the last step rounds, half to even like printf
+  double scaled = value*powersOfTen[decimals];
+  unsigned long long whole = (unsigned long long)scaled;
+  double fraction = scaled - (double)whole;
+  if(fraction > 0.5 || (fraction == 0.5 && (whole & 1)))
+  {
+    whole++;
+  }
+
+  //digits come out last to first, decimals then the point then the whole part
+  for(int i = 0; i < decimals; i++)
+  {
+    digits[length++] = (char)('0' + whole % 10);
+    whole = whole/10;
+  }
+  if(decimals > 0)
+  {
+    digits[length++] = '.';
+  }
+  do
+  {
+    digits[length++] = (char)('0' + whole % 10);
+    whole = whole/10;
+  }while(whole > 0);
+  if(negative)
+  {
+    digits[length++] = '-';
+  }
+
+  reserve(output,(size_t)(width > length ? width : length));
+  for(int i = length; i < width; i++)
+  {
+    output->buffer[output->used++] = ' ';
+  }
+  while(length > 0)
+  {
+    output->buffer[output->used++] = digits[--length];
+  }
+}
+
+/**Function to hand everything collected so far to the file, a writer without a file keeps its text.
+*@param output the writer
+**/
+void flushOutput(OutputBuffer *output)
+{
+  if(output == NULL || output->used == 0 || output->fp == NULL)
+  {
+    return;
+  }
+  if(output->discarding)
+  {
+    output->used = 0;
+    return;
+  }
+  PhaseTimer timer;
+  START_PHASE(timer);
+  fwrite(output->buffer,1,output->used,output->fp);
+  END_PHASE(PHASE_OUTPUT,timer);
+  COUNT(outputWrites,1);
+  COUNT(outputBytes,output->used);
+  output->written = output->written + output->used;
+  output->used = 0;
+}
+
+/**Function to throw away the text collected so far and, while discarding is 1, every block after it instead of
+*handing it to the file. A resumed run leaves out this way what the interrupted run had already printed.
+*@param output the writer, may be NULL
+*@param discarding 1 to keep throwing text away, 0 to hand text to the file again from here on
+**/
+void discardOutput(OutputBuffer *output, int discarding)
+{
+  if(output == NULL)
+  {
+    return;
+  }
+  output->used = 0;
+  output->discarding = discarding;
+}
+
+/**Function to flush the writer and free it, the file stays open.
+*@param output the writer to be deleted
+**/
+void deleteOutput(OutputBuffer *output)
+{
+  if(output == NULL)
+  {
+    return;
+  }
+  flushOutput(output);
+  free(output->buffer);
+  free(output);
+}
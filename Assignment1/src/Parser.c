@@ -0,0 +1,472 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include "../include/Parser.h"
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+//powers of ten that fit in 64 bits
+static const uint64_t powersOfTen[] = {
+  UINT64_C(1), UINT64_C(10), UINT64_C(100), UINT64_C(1000), UINT64_C(10000), UINT64_C(100000),
+  UINT64_C(1000000), UINT64_C(10000000), UINT64_C(100000000), UINT64_C(1000000000), UINT64_C(10000000000),
+  UINT64_C(100000000000), UINT64_C(1000000000000), UINT64_C(10000000000000), UINT64_C(100000000000000),
+  UINT64_C(1000000000000000), UINT64_C(10000000000000000), UINT64_C(100000000000000000),
+  UINT64_C(1000000000000000000), UINT64_C(10000000000000000000)
+};
+
+/**Function to check for a space or tab, newlines end a line so they are not blanks.
+*@param c character to check
+**/
+static int isBlank(char c)
+{
+  return c == ' ' || c == '\t' || c == '\r' || c == '\v' || c == '\f';
+}
+
+/**Function to check for a decimal digit.
+*@param c character to check
+**/
+static int isDigit(char c)
+{
+  return c >= '0' && c <= '9';
+}
+
+/**Function to turn a decimal number of seconds into ticks. Digits finer than a tick are rounded to the nearest
+*tick, half to even, so the result never depends on how a double would have rounded the number.
+*@param mantissa the digits of the number
+*@param exponent power of ten to multiply the digits by to get seconds
+*@param value where the ticks are written
+*@return 1 on success, 0 if the time does not fit in a SimTime
+**/
+static int scaleToTicks(uint64_t mantissa, int exponent, SimTime *value)
+{
+  exponent = exponent + TIME_DECIMALS;
+  if(mantissa == 0)
+  {
+    *value = 0;
+    return 1;
+  }
+
+  if(exponent >= 0)
+  {
+    if(exponent > 19 || mantissa > (uint64_t)INT64_MAX/powersOfTen[exponent])
+    {
+      return 0;
+    }
+    *value = (SimTime)(mantissa*powersOfTen[exponent]);
+    return 1;
+  }
+
+  //the mantissa is below 10^19, so anything more than 19 digits past the tick rounds to 0
+  if(exponent < -19)
+  {
+    *value = 0;
+    return 1;
+  }
+  uint64_t divisor = powersOfTen[-exponent];
+  uint64_t quotient = mantissa/divisor;
+  uint64_t remainder = mantissa%divisor;
+  if(remainder > divisor - remainder || (remainder == divisor - remainder && (quotient & 1)))
+  {
+    quotient++;
+  }
+  *value = (SimTime)quotient;
+  return 1;
+}
+
+/**Function to parse a time written as a decimal number, like "12", "3.2" or "1.5e2". It does not depend on the locale.
+*The number is read straight into ticks of the time base without going through a double.
+*@return pointer to the first character after the number, NULL if there is no number at text or it is too large
+*@param text first character of the number
+*@param end one past the last character that may be read
+*@param value where the time is written, in ticks
+**/
+const char *parseTime(const char *text, const char *end, SimTime *value)
+{
+  uint64_t mantissa = 0;
+  int exponent = 0;
+  int digits = 0;
+  const char *position = text;
+
+  if(position < end && *position == '+')
+  {
+    position++;
+  }
+
+  //digits before the decimal point, digits past what fits in the mantissa only move the exponent
+  while(position < end && isDigit(*position))
+  {
+    if(mantissa < UINT64_C(1000000000000000000))
+    {
+      mantissa = mantissa*10 + (uint64_t)(*position - '0');
+    }
+    else
+    {
+      exponent++;
+    }
+    digits++;
+    position++;
+  }
+
+  //digits after the decimal point
+  if(position < end && *position == '.')
+  {
+    position++;
+    while(position < end && isDigit(*position))
+    {
+      if(mantissa < UINT64_C(1000000000000000000))
+      {
+        mantissa = mantissa*10 + (uint64_t)(*position - '0');
+        exponent--;
+      }
+      digits++;
+      position++;
+    }
+  }
+
+  if(digits == 0)
+  {
+    return NULL;
+  }
+
+  //optional exponent
+  if(position < end && (*position == 'e' || *position == 'E'))
+  {
+    int exponentSign = 1;
+    int exponentValue = 0;
+
+    position++;
+    if(position < end && (*position == '+' || *position == '-'))
+    {
+      exponentSign = (*position == '-') ? -1 : 1;
+      position++;
+    }
+    if(position >= end || !isDigit(*position))
+    {
+      return NULL;
+    }
+    while(position < end && isDigit(*position))
+    {
+      if(exponentValue < 10000)
+      {
+        exponentValue = exponentValue*10 + (*position - '0');
+      }
+      position++;
+    }
+    exponent = exponent + exponentSign*exponentValue;
+  }
+
+  if(!scaleToTicks(mantissa,exponent,value))
+  {
+    return NULL;
+  }
+  return position;
+}
+
+/**Function to report a line that is not a car and move the reader past it.
+*@param reader the reader that found the line
+*@param lineStart first character of the line
+*@param reason what was wrong with the line
+**/
+static void skipMalformedLine(CarReader *reader, const char *lineStart, const char *reason)
+{
+  const char *lineEnd = lineStart;
+  while(lineEnd < reader->end && *lineEnd != '\n')
+  {
+    lineEnd++;
+  }
+
+  //not printing the carriage return of windows line endings
+  const char *printEnd = lineEnd;
+  while(printEnd > lineStart && isBlank(printEnd[-1]))
+  {
+    printEnd--;
+  }
+
+  fprintf(stderr,"%s:%lu: %s: \"%.*s\"\n",reader->fileName,(unsigned long)reader->lineNumber,reason,(int)(printEnd - lineStart),lineStart);
+  reader->malformedLines++;
+  reader->position = (lineEnd < reader->end) ? (char *)lineEnd + 1 : (char *)lineEnd;
+}
+
+/**Function to open a car input file for reading.
+*@return pointer to the reader, NULL if the file could not be opened or read or memory could not be allocated
+*@param fileName path of the car input file
+**/
+CarReader *openCarReader(const char *fileName)
+{
+  if(fileName == NULL)
+  {
+    return NULL;
+  }
+
+  CarReader *newReader = malloc(sizeof(CarReader)*1);
+  if(newReader == NULL)
+  {
+    return NULL;
+  }
+  newReader->fileName = fileName;
+  newReader->start = NULL;
+  newReader->length = 0;
+  newReader->lineNumber = 0;
+  newReader->malformedLines = 0;
+  newReader->mapped = 0;
+  setCarDirections(newReader,"NESW");
+
+#ifndef _WIN32
+  //mapping the whole file, the pages are read in by the kernel as the reader walks through them
+  int fileDescriptor = open(fileName,O_RDONLY);
+  struct stat fileInformation;
+  if(fileDescriptor < 0)
+  {
+    free(newReader);
+    return NULL;
+  }
+  if(fstat(fileDescriptor,&fileInformation) == 0 && fileInformation.st_size > 0)
+  {
+    void *mapping = mmap(NULL,(size_t)fileInformation.st_size,PROT_READ,MAP_PRIVATE,fileDescriptor,0);
+    if(mapping != MAP_FAILED)
+    {
+      madvise(mapping,(size_t)fileInformation.st_size,MADV_SEQUENTIAL);
+      newReader->start = mapping;
+      newReader->length = (size_t)fileInformation.st_size;
+      newReader->mapped = 1;
+    }
+  }
+  close(fileDescriptor);
+#endif
+
+  //reading the file into memory when it could not be mapped
+  if(!newReader->mapped)
+  {
+    FILE *fp = fopen(fileName,"rb");
+    size_t capacity = 0;
+    size_t bytesRead;
+    if(fp == NULL)
+    {
+      free(newReader);
+      return NULL;
+    }
+    do
+    {
+      if(newReader->length == capacity)
+      {
+        capacity = (capacity == 0) ? 65536 : capacity*2;
+        char *newStart = realloc(newReader->start,capacity);
+        if(newStart == NULL)
+        {
+          free(newReader->start);
+          fclose(fp);
+          free(newReader);
+          return NULL;
+        }
+        newReader->start = newStart;
+      }
+      bytesRead = fread(newReader->start + newReader->length,1,capacity - newReader->length,fp);
+      newReader->length = newReader->length + bytesRead;
+    }while(bytesRead > 0);
+    fclose(fp);
+  }
+
+  newReader->end = newReader->start + newReader->length;
+  newReader->position = newReader->start;
+  return newReader;
+}
+
+/**Function to set the travel directions the reader accepts, for junctions that are not N, E, S, W.
+*@pre reader must exist
+*@param reader the reader
+*@param directions every direction letter accepted
+**/
+void setCarDirections(CarReader *reader, const char *directions)
+{
+  for(int i = 0; i < 256; i++)
+  {
+    reader->knownDirection[i] = 0;
+  }
+  for(; *directions != '\0'; directions++)
+  {
+    reader->knownDirection[(unsigned char)*directions] = 1;
+  }
+}
+
+/**Function to read the next car from the file. Malformed lines are reported on stderr and skipped.
+*@pre reader must exist
+*@post car holds the next car of the file when 1 is returned
+*@return 1 when a car was read, 0 at the end of the file
+*@param reader the reader to take the car from
+*@param car where the car is written
+**/
+int readCar(CarReader *reader, Data *car)
+{
+  if(reader == NULL)
+  {
+    return 0;
+  }
+
+  const char *position = reader->position;
+  const char *end = reader->end;
+
+  while(position < end)
+  {
+    const char *lineStart = position;
+    char travelDirection;
+    char turnDirection;
+    SimTime timeOfArrival;
+
+    reader->lineNumber++;
+
+    //skipping blank lines
+    while(position < end && isBlank(*position))
+    {
+      position++;
+    }
+    if(position >= end)
+    {
+      break;
+    }
+    if(*position == '\n')
+    {
+      position++;
+      continue;
+    }
+
+    //travel direction
+    travelDirection = *position++;
+    if(!reader->knownDirection[(unsigned char)travelDirection])
+    {
+      skipMalformedLine(reader,lineStart,"travel direction is not one of the approaches of the intersection");
+      position = reader->position;
+      continue;
+    }
+    if(position >= end || *position == '\n')
+    {
+      skipMalformedLine(reader,lineStart,"missing turn direction");
+      position = reader->position;
+      continue;
+    }
+    if(!isBlank(*position))
+    {
+      skipMalformedLine(reader,lineStart,"expected a space after the travel direction");
+      position = reader->position;
+      continue;
+    }
+    while(position < end && isBlank(*position))
+    {
+      position++;
+    }
+
+    //turn direction
+    turnDirection = (position < end) ? *position++ : '\0';
+    if(turnDirection != 'F' && turnDirection != 'R' && turnDirection != 'L')
+    {
+      skipMalformedLine(reader,lineStart,"turn direction must be one of F, R, L");
+      position = reader->position;
+      continue;
+    }
+    if(position >= end || *position == '\n')
+    {
+      skipMalformedLine(reader,lineStart,"missing time of arrival");
+      position = reader->position;
+      continue;
+    }
+    if(!isBlank(*position))
+    {
+      skipMalformedLine(reader,lineStart,"expected a space after the turn direction");
+      position = reader->position;
+      continue;
+    }
+    while(position < end && isBlank(*position))
+    {
+      position++;
+    }
+
+    //time of arrival, followed by nothing but blanks
+    position = parseTime(position,end,&timeOfArrival);
+    if(position == NULL)
+    {
+      skipMalformedLine(reader,lineStart,"time of arrival is not a number or is too large");
+      position = reader->position;
+      continue;
+    }
+    while(position < end && isBlank(*position))
+    {
+      position++;
+    }
+    if(position < end && *position != '\n')
+    {
+      skipMalformedLine(reader,lineStart,"unexpected text after the time of arrival");
+      position = reader->position;
+      continue;
+    }
+    if(position < end)
+    {
+      position++;
+    }
+
+    reader->position = (char *)position;
+    car->travelDirection = travelDirection;
+    car->turnDirection = turnDirection;
+    car->timeOfArrival = timeOfArrival;
+    return 1;
+  }
+
+  reader->position = (char *)end;
+  return 0;
+}
+
+/**Function to leave out the last line of the file when it does not end with a newline yet, for a file that is
+*still being written. A later reader over the file reads it once it is complete.
+*@pre nothing must have been read yet
+*@param reader the reader
+**/
+void dropPartialLine(CarReader *reader)
+{
+  while(reader->end > reader->start && reader->end[-1] != '\n')
+  {
+    reader->end--;
+  }
+}
+
+/**Function to carry on reading from where an earlier reader over the same file stopped.
+*@pre nothing must have been read yet
+*@return EXIT_SUCCESS on success, EXIT_FAILURE if the file is shorter than offset
+*@param reader the reader
+*@param offset bytes of the file the earlier reader had gone through
+*@param lineNumber lines the earlier reader had gone through
+**/
+int seekCarReader(CarReader *reader, size_t offset, size_t lineNumber)
+{
+  if(offset > (size_t)(reader->end - reader->start))
+  {
+    return EXIT_FAILURE;
+  }
+  reader->position = reader->start + offset;
+  reader->lineNumber = lineNumber;
+  return EXIT_SUCCESS;
+}
+
+/**Function to close the reader and unmap the file.
+*@param reader the reader to be closed
+**/
+void closeCarReader(CarReader *reader)
+{
+  if(reader == NULL)
+  {
+    return;
+  }
+
+#ifndef _WIN32
+  if(reader->mapped)
+  {
+    munmap(reader->start,reader->length);
+    free(reader);
+    return;
+  }
+#endif
+  free(reader->start);
+  free(reader);
+}
@@ -1,17 +1,36 @@
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include "../include/Queue.h"
+#include "../include/Intersection.h"
+#include "../include/Counters.h"
 
 /**Function to point the list head to the appropriate functions. Allocates memory to the struct.
-*@return pointer to the list head
+*@return pointer to the list head, NULL if memory could not be allocated
 *@param printFunction function pointer to print a single node of the list
 *@param deleteFunction function pointer to delete a single piece of data from the list
 *@param compareFunction function pointer to compare two nodes of the list in order to test for equality or order
 **/
 List *initializeList(void (*printFunction)(void *toBePrinted),void (*deleteFunction)(void *toBeDeleted),int (*compareNodeFunction)(void *first, void *second),int (*compareFunction)(void *first, void *second))
+{
+  return initializeListWithAllocator(printFunction,deleteFunction,compareNodeFunction,compareFunction,NULL);
+}
+
+/**Function to create a list whose nodes come from the given allocator instead of malloc.
+*@return pointer to the list head, NULL if memory could not be allocated
+*@param printFunction function pointer to print a single node of the list
+*@param deleteFunction function pointer to delete a single piece of data from the list, NULL if the list does not own its data
+*@param compareFunction function pointer to compare two nodes of the list in order to test for equality or order
+*@param allocator memory hooks for the nodes, NULL to use malloc. The allocator must outlive the list.
+**/
+List *initializeListWithAllocator(void (*printFunction)(void *toBePrinted),void (*deleteFunction)(void *toBeDeleted),int (*compareNodeFunction)(void *first, void *second),int (*compareFunction)(void *first, void *second),Allocator *allocator)
 {
   //creating new list and allocating space for list
   List *newList = malloc(sizeof(List)*1);
+  if(newList == NULL)
+  {
+    return NULL;
+  }
 
   //initializing list elements
   newList->head = NULL;
@@ -20,11 +39,461 @@ List *initializeList(void (*printFunction)(void *toBePrinted),void (*deleteFunct
   newList->compare = compareFunction;
   newList->compareNode = compareNodeFunction;
   newList->deleteData = deleteFunction;
+  newList->allocator = allocator;
+  newList->index = NULL;
 
   //returning new list
   return newList;
 }
 
+/**Function to create a sorted list with a skip list index over its nodes. insertSorted and deleteDataFromList take
+*expected O(log n) instead of a walk of the list, and the list keeps exactly the order insertSorted gives a plain list.
+*@return pointer to the list head, NULL if memory could not be allocated
+*@param printFunction function pointer to print a single node of the list
+*@param deleteFunction function pointer to delete a single piece of data from the list, NULL if the list does not own its data
+*@param compareNodeFunction function pointer telling whether two pieces of data are the same, data it finds the same
+*must also be equal by compareFunction
+*@param compareFunction function pointer to compare two nodes of the list in order to test for equality or order
+*@param allocator memory hooks for the nodes and the links of the index, NULL to use malloc. The allocator must outlive the list.
+**/
+List *initializeSkipList(void (*printFunction)(void *toBePrinted),void (*deleteFunction)(void *toBeDeleted),int (*compareNodeFunction)(void *first, void *second),int (*compareFunction)(void *first, void *second),Allocator *allocator)
+{
+  List *newList = initializeListWithAllocator(printFunction,deleteFunction,compareNodeFunction,compareFunction,allocator);
+  if(newList == NULL)
+  {
+    return NULL;
+  }
+  SkipIndex *index = malloc(sizeof(SkipIndex)*1);
+  if(index == NULL)
+  {
+    free(newList);
+    return NULL;
+  }
+
+  index->levels = 1;
+  index->random = 0x9E3779B97F4A7C15ULL;  //any seed but 0, the same every run so the index is laid out the same
+  for(int i = 0; i < SKIP_LIST_MAX_LEVELS; i++)
+  {
+    index->heads[i].node = NULL;
+    index->heads[i].right = NULL;
+    index->heads[i].down = (i == 0) ? NULL : &index->heads[i - 1];
+  }
+  newList->index = index;
+  return newList;
+}
+
+/**Function for creating a node with the list's allocator, falls back to initializeNode when there is none.
+*@param list list the node will belong to
+*@param data generic pointer stored in the node
+*@return the new node, NULL if memory could not be allocated
+**/
+static Node *allocateNode(List *list, void *data)
+{
+  COUNT(allocations,1);
+  COUNT(bytes,sizeof(Node));
+  if(list->allocator == NULL)
+  {
+    return initializeNode(data);
+  }
+
+  Node *newNode = list->allocator->allocate(list->allocator->context,sizeof(Node));
+  if(newNode == NULL)
+  {
+    return NULL;
+  }
+  newNode->data = data;
+  newNode->next = NULL;
+  newNode->previous = NULL;
+  return newNode;
+}
+
+/**Function for giving a node back to the list's allocator, the node's data is not touched.
+*@param list list the node belonged to
+*@param toBeReleased node that is no longer linked into the list
+**/
+static void releaseNode(List *list, Node *toBeReleased)
+{
+  if(list->allocator == NULL)
+  {
+    free(toBeReleased);
+    return;
+  }
+  list->allocator->release(list->allocator->context,toBeReleased,sizeof(Node));
+}
+
+/**Function for deleting a piece of data that was in the list, lists without a deleteData function do not own their data.
+*@param list list the data belonged to
+*@param toBeDeleted data that is no longer in the list
+**/
+static void deleteNodeData(List *list, void *toBeDeleted)
+{
+  if(list->deleteData != NULL)
+  {
+    list->deleteData(toBeDeleted);
+  }
+}
+
+/**Function for creating a link of a skip list index with the list's allocator.
+*@param list list the link will belong to
+*@param node node the link points to
+*@return the new link, NULL if memory could not be allocated
+**/
+static SkipLink *allocateLink(List *list, Node *node)
+{
+  SkipLink *newLink;
+  COUNT(allocations,1);
+  COUNT(bytes,sizeof(SkipLink));
+  if(list->allocator == NULL)
+  {
+    newLink = malloc(sizeof(SkipLink)*1);
+  }
+  else
+  {
+    newLink = list->allocator->allocate(list->allocator->context,sizeof(SkipLink));
+  }
+  if(newLink == NULL)
+  {
+    return NULL;
+  }
+  newLink->node = node;
+  newLink->right = NULL;
+  newLink->down = NULL;
+  return newLink;
+}
+
+/**Function for giving a link of a skip list index back to the list's allocator.
+*@param list list the link belonged to
+*@param toBeReleased link that is no longer in the index
+**/
+static void releaseLink(List *list, SkipLink *toBeReleased)
+{
+  if(list->allocator == NULL)
+  {
+    free(toBeReleased);
+    return;
+  }
+  list->allocator->release(list->allocator->context,toBeReleased,sizeof(SkipLink));
+}
+
+/**Function to draw how many levels of the index a new node goes up, each level with a chance of a quarter, from an
+*xorshift sequence kept in the index.
+*@param index the index
+*@return 0 to SKIP_LIST_MAX_LEVELS
+**/
+static int towerHeight(SkipIndex *index)
+{
+  uint64_t bits;
+  int height = 0;
+
+  index->random ^= index->random << 13;
+  index->random ^= index->random >> 7;
+  index->random ^= index->random << 17;
+  bits = index->random;
+  while(height < SKIP_LIST_MAX_LEVELS && (bits & 3) == 0)
+  {
+    height++;
+    bits = bits >> 2;
+  }
+  return height;
+}
+
+/**Function to go down the index of a skip list to the last link of each level whose node is smaller than data.
+*@param list the skip list
+*@param data the data looked for
+*@param before where the link of each level is stored, levels the index does not use yet get their head
+*@return the link of level 0, a head without a node when no node of level 0 is smaller
+**/
+static SkipLink *findBefore(List *list, void *data, SkipLink **before)
+{
+  SkipIndex *index = list->index;
+  SkipLink *link = &index->heads[index->levels - 1];
+  unsigned long long visited = 0;   //links stepped over, for --stats
+  unsigned long long compared = 0;  //calls of compare, for --stats
+
+  for(int level = SKIP_LIST_MAX_LEVELS - 1; level >= index->levels; level--)
+  {
+    before[level] = &index->heads[level];
+  }
+  for(int level = index->levels - 1; level >= 0; level--)
+  {
+    while(link->right != NULL && (compared++, list->compare(link->right->node->data,data) < 0))
+    {
+      visited++;
+      link = link->right;
+    }
+    before[level] = link;
+    if(level > 0)
+    {
+      link = link->down;
+    }
+  }
+
+  COUNT_SCAN(visited);
+  COUNT(compares,compared);
+  return link;
+}
+
+/**Function to find the first node of a skip list that is not smaller than data, going through the index and then
+*along the few nodes that are not in it.
+*@param list the skip list
+*@param data the data looked for
+*@param before where the link of each level in front of the node is stored
+*@return the node, NULL when every node is smaller
+**/
+static Node *findInSkipList(List *list, void *data, SkipLink **before)
+{
+  SkipLink *link = findBefore(list,data,before);
+  Node *nodeToBeCompared = (link->node == NULL) ? list->head : link->node->next;
+  unsigned long long visited = 0;  //nodes compared, for --stats
+
+  while(nodeToBeCompared != NULL && (visited++, list->compare(nodeToBeCompared->data,data) < 0))
+  {
+    nodeToBeCompared = nodeToBeCompared->next;
+  }
+  COUNT_SCAN(visited);
+  COUNT(compares,visited);
+  return nodeToBeCompared;
+}
+
+/**Function to shrink the levels in use of a skip list index past the levels that have become empty.
+*@param index the index
+**/
+static void trimLevels(SkipIndex *index)
+{
+  while(index->levels > 1 && index->heads[index->levels - 1].right == NULL)
+  {
+    index->levels--;
+  }
+}
+
+/**Function to free every link of a skip list index and empty its levels, the nodes are not touched.
+*@param list the skip list
+**/
+static void clearSkipIndex(List *list)
+{
+  SkipIndex *index = list->index;
+  int inBulk = (list->allocator != NULL && list->allocator->freesInBulk);  //links an arena takes back by itself
+
+  for(int level = 0; level < index->levels; level++)
+  {
+    SkipLink *link = index->heads[level].right;
+    while(link != NULL && !inBulk)
+    {
+      SkipLink *next = link->right;
+      releaseLink(list,link);
+      link = next;
+    }
+    index->heads[level].right = NULL;
+  }
+  index->levels = 1;
+}
+
+/**Function to build the index of a skip list again over all of its nodes in one pass, after nodes were added
+*without it. This has a big O notation of n. A node whose links could not be allocated gets a shorter tower, the
+*index only gets sparser.
+*@param list the skip list
+**/
+static void rebuildSkipIndex(List *list)
+{
+  SkipIndex *index = list->index;
+  SkipLink *last[SKIP_LIST_MAX_LEVELS];  //end of each level so far
+
+  clearSkipIndex(list);
+  for(int level = 0; level < SKIP_LIST_MAX_LEVELS; level++)
+  {
+    last[level] = &index->heads[level];
+  }
+  for(Node *node = list->head; node != NULL; node = node->next)
+  {
+    int height = towerHeight(index);
+    SkipLink *below = NULL;
+    for(int level = 0; level < height; level++)
+    {
+      SkipLink *newLink = allocateLink(list,node);
+      if(newLink == NULL)
+      {
+        height = level;
+        break;
+      }
+      newLink->down = below;
+      last[level]->right = newLink;
+      last[level] = newLink;
+      below = newLink;
+    }
+    if(height > index->levels)
+    {
+      index->levels = height;
+    }
+  }
+}
+
+/**Function to link a node into the list in front of another node.
+*@param list the list
+*@param nodeToBeAdded node that is not in the list yet
+*@param nodeToBeCompared node that the new node goes in front of, NULL to add it at the end
+**/
+static void linkBefore(List *list, Node *nodeToBeAdded, Node *nodeToBeCompared)
+{
+  if(nodeToBeCompared == NULL)
+  {
+    //adding to the end of the list
+    nodeToBeAdded->previous = list->tail;
+    if(list->tail == NULL)
+    {
+      list->head = nodeToBeAdded;
+    }
+    else
+    {
+      list->tail->next = nodeToBeAdded;
+    }
+    list->tail = nodeToBeAdded;
+    return;
+  }
+
+  //adding in front of nodeToBeCompared
+  nodeToBeAdded->next = nodeToBeCompared;
+  nodeToBeAdded->previous = nodeToBeCompared->previous;
+  if(nodeToBeCompared->previous == NULL)
+  {
+    list->head = nodeToBeAdded;
+  }
+  else
+  {
+    nodeToBeCompared->previous->next = nodeToBeAdded;
+  }
+  nodeToBeCompared->previous = nodeToBeAdded;
+}
+
+/**Function to take a node out of the list, the node itself is not released.
+*@param list the list
+*@param toBeUnlinked node of the list
+**/
+static void unlinkNode(List *list, Node *toBeUnlinked)
+{
+  if(toBeUnlinked->previous == NULL)
+  {
+    list->head = toBeUnlinked->next;
+  }
+  else
+  {
+    toBeUnlinked->previous->next = toBeUnlinked->next;
+  }
+  if(toBeUnlinked->next == NULL)
+  {
+    list->tail = toBeUnlinked->previous;
+  }
+  else
+  {
+    toBeUnlinked->next->previous = toBeUnlinked->previous;
+  }
+}
+
+/**Function to insert data into a skip list in front of the first node that is not smaller, like insertSorted does
+*on a plain list, and give the node links on the levels drawn for it. This has an expected big O notation of log n.
+*@param list the skip list
+*@param data data to be added
+*@return the node holding the data, NULL if memory could not be allocated. When only links could not be allocated
+*the node is added with a shorter tower.
+**/
+static Node *insertIntoSkipList(List *list, void *data)
+{
+  SkipIndex *index = list->index;
+  SkipLink *before[SKIP_LIST_MAX_LEVELS];
+  Node *nodeToBeAdded = allocateNode(list,data);
+  SkipLink *below = NULL;
+  int height;
+
+  if(nodeToBeAdded == NULL)
+  {
+    return NULL;
+  }
+  linkBefore(list,nodeToBeAdded,findInSkipList(list,data,before));
+
+  //the new links go right after the links in front of the node on each level, which keeps every level in list order
+  height = towerHeight(index);
+  for(int level = 0; level < height; level++)
+  {
+    SkipLink *newLink = allocateLink(list,nodeToBeAdded);
+    if(newLink == NULL)
+    {
+      height = level;
+      break;
+    }
+    newLink->down = below;
+    newLink->right = before[level]->right;
+    before[level]->right = newLink;
+    below = newLink;
+  }
+  if(height > index->levels)
+  {
+    index->levels = height;
+  }
+  return nodeToBeAdded;
+}
+
+/**Function to take the links of a node out of the index of a skip list, the node stays in the list. Its links are
+*among the links of equal nodes after before on each level, up to the top of its tower, a node added with insertBack
+*has none.
+*@param list the skip list
+*@param node node of the list
+*@param before the links in front of the node, from findBefore
+**/
+static void unindexNode(List *list, Node *node, SkipLink **before)
+{
+  SkipIndex *index = list->index;
+
+  for(int level = 0; level < index->levels; level++)
+  {
+    SkipLink *link = before[level];
+    while(link->right != NULL && link->right->node != node && list->compare(link->right->node->data,node->data) == 0)
+    {
+      link = link->right;
+    }
+    if(link->right == NULL || link->right->node != node)
+    {
+      break;
+    }
+    SkipLink *removed = link->right;
+    link->right = removed->right;
+    releaseLink(list,removed);
+  }
+  trimLevels(index);
+}
+
+/**Function to remove data from a skip list, searching the data equal to toBeDeleted by compare for the one that
+*compareNode finds the same. This has an expected big O notation of log n plus the number of equal data.
+*@param list the skip list
+*@param toBeDeleted data that is to be removed
+*@return EXIT_SUCCESS on success, -1 when the data cannot be found
+**/
+static int deleteFromSkipList(List *list, void *toBeDeleted)
+{
+  SkipLink *before[SKIP_LIST_MAX_LEVELS];
+  Node *nodeToBeCompared = findInSkipList(list,toBeDeleted,before);
+  unsigned long long visited = 0;  //calls of compareNode, for --stats
+
+  while(nodeToBeCompared != NULL && list->compare(nodeToBeCompared->data,toBeDeleted) == 0)
+  {
+    visited++;
+    if(list->compareNode(nodeToBeCompared->data,toBeDeleted) == 0)
+    {
+      break;
+    }
+    nodeToBeCompared = nodeToBeCompared->next;
+  }
+  COUNT(nodeCompares,visited);
+  if(nodeToBeCompared == NULL || list->compare(nodeToBeCompared->data,toBeDeleted) != 0)
+  {
+    return -1;
+  }
+
+  unindexNode(list,nodeToBeCompared,before);
+  unlinkNode(list,nodeToBeCompared);
+  deleteNodeData(list,nodeToBeCompared->data);
+  releaseNode(list,nodeToBeCompared);
+  return EXIT_SUCCESS;
+}
+
 
 /**Function for creating a node for a linked list. This node contains generic data and may be connected to
 other notes in a list.
@@ -38,6 +507,10 @@ Node *initializeNode(void * data)
 {
   //creating new node and allocating space for node
   Node * newNode = malloc(sizeof(Node)*1);
+  if(newNode == NULL)
+  {
+    return NULL;
+  }
   //initializing node elements
 
   newNode->data = data;
@@ -53,31 +526,37 @@ Node *initializeNode(void * data)
 *@pre 'List' type must exist and be used in order to keep track of the linked list.
 *@param list pointer to the dummy head of the list
 *@param toBeAdded a pointer to data that is to be added to the linked list
+*@return the node holding the data, a handle for removeNode, nextNode and previousNode that stays valid until the
+*node is removed or the list deleted. NULL if list is NULL or memory could not be allocated
 **/
-void insertBack(List *list, void *data)
+Node *insertBack(List *list, void *data)
 {
   //check if list list does not point to anything
   if(list == NULL)
   {
-    return;
+    return NULL;
   }
 
   //creating node to be added
-  Node *nodeToBeAdded = initializeNode(data);
+  Node *nodeToBeAdded = allocateNode(list,data);
+  if(nodeToBeAdded == NULL)
+  {
+    return NULL;
+  }
 
   //checking if head is NULL(head can be checked because then if head exists, we know there is at least 1 node)
   if(list->head == NULL)
   {
     list->head = nodeToBeAdded;
     list->tail = nodeToBeAdded;
-    return;
+    return nodeToBeAdded;
   }
 
   //adding node to end if head is not NULL
   list->tail->next = nodeToBeAdded;
   nodeToBeAdded->previous = list->tail;
   list->tail = nodeToBeAdded;
-  return;
+  return nodeToBeAdded;
 }
 /**Function to remove a node from the list and alter the pointers accordingly to not disrupt the order of the
  *data structure.
@@ -94,61 +573,88 @@ int deleteDataFromList(List *list, void *toBeDeleted)
   {
     return EXIT_FAILURE;
   }
+  if(list->index != NULL)
+  {
+    return deleteFromSkipList(list,toBeDeleted);
+  }
   //creating node
   Node *nodeToBeCompared = list->head;
+  unsigned long long visited = 0;  //nodes compared, for --stats
 
-  //comparing nodes to see if one is the same as toBeDeleted
-  if (nodeToBeCompared != NULL)
+  //comparing nodes to see if one is the same as toBeDeleted, the one found is then removed by its handle
+  while(nodeToBeCompared != NULL)
   {
-    if((nodeToBeCompared==list->tail)&&(list->compareNode(nodeToBeCompared->data,toBeDeleted) == 0))
+    visited++;
+    if(list->compareNode(nodeToBeCompared->data,toBeDeleted) == 0)
     {
-      list->deleteData(nodeToBeCompared->data);
-      free(nodeToBeCompared);
-      list->head=NULL;
-      list->tail=NULL;
+      COUNT_SCAN(visited);
+      COUNT(nodeCompares,visited);
+      deleteNodeData(list,removeNode(list,nodeToBeCompared));
       return EXIT_SUCCESS;
     }
-    while(nodeToBeCompared->next != NULL)
-    {
-      if (list->compareNode(nodeToBeCompared->data,toBeDeleted) == 0)
-      {
-        //check if head
-        if (nodeToBeCompared ==list->head)
-        {
-          list->head = nodeToBeCompared->next;
-          list->deleteData(nodeToBeCompared->data);
-          free(nodeToBeCompared);
-          return EXIT_SUCCESS;
-        }
 
-        //check if tail
-        else if(nodeToBeCompared==list->tail)
-        {
-          list->tail=nodeToBeCompared->previous;
-          list->deleteData(nodeToBeCompared->data);
-          free(nodeToBeCompared);
-          return EXIT_SUCCESS;
-        }
+    //moving to next node to be checked
+    nodeToBeCompared = nodeToBeCompared->next;
+  }
+  COUNT_SCAN(visited);
+  COUNT(nodeCompares,visited);
+  return -1;
+}
 
-        //if not head or tail
-        else
-        {
-          nodeToBeCompared->previous->next = nodeToBeCompared->next;
-          nodeToBeCompared->next->previous = nodeToBeCompared->previous;
-          list->deleteData(nodeToBeCompared->data);
-          free(nodeToBeCompared);
-          return EXIT_SUCCESS;
-        }
-      }
+/**Function to remove a node the caller already holds from the list without deleting its data. No compare function
+ *is called and nothing is searched for, this has a big O notation of 1. On a skip list the links of the index to the
+ *node have to go too, which is found in an expected log n.
+ *@pre toBeRemoved is a node of list
+ *@post the node is freed and the handle must not be used again
+ *@param list pointer to the dummy head of the list
+ *@param toBeRemoved node returned by insertBack or insertSorted, or reached from one with nextNode or previousNode
+ *@return pointer to the data that was in the node, NULL if list or toBeRemoved is NULL
+ **/
+void *removeNode(List *list, Node *toBeRemoved)
+{
+  if(list == NULL || toBeRemoved == NULL)
+  {
+    return NULL;
+  }
 
-      //moving to next node to be checked
-      nodeToBeCompared = nodeToBeCompared->next;
-    }
-    return -1;
+  void *data = toBeRemoved->data;
+  if(list->index != NULL)
+  {
+    SkipLink *before[SKIP_LIST_MAX_LEVELS];
+    findBefore(list,data,before);
+    unindexNode(list,toBeRemoved,before);
   }
+  unlinkNode(list,toBeRemoved);
+  releaseNode(list,toBeRemoved);
+  return data;
+}
 
-  return -1;
+/**Function to give the node after a node of a list. This has a big O notation of 1.
+ *@param node node of a list
+ *@return the next node, NULL if node is the tail or NULL
+ **/
+Node *nextNode(Node *node)
+{
+  if(node == NULL)
+  {
+    return NULL;
+  }
+  return node->next;
+}
+
+/**Function to give the node in front of a node of a list. This has a big O notation of 1.
+ *@param node node of a list
+ *@return the previous node, NULL if node is the head or NULL
+ **/
+Node *previousNode(Node *node)
+{
+  if(node == NULL)
+  {
+    return NULL;
+  }
+  return node->previous;
 }
+
 /** Deletes the entire linked list head to tail, starting with the nodes, followed by the list itself.
 *@pre 'List' type must exist and be used in order to keep track of the linked list.
 *@param list pointer to the List-type dummy node
@@ -164,13 +670,27 @@ void deleteList(List *list)
   //create placeholder for node.
   Node *nodeHolder;
 
+  //the links of a skip list index go first, they only point to the nodes
+  if(list->index != NULL)
+  {
+    clearSkipIndex(list);
+    free(list->index);
+  }
+
+  //nodes from a bulk allocator go away with the allocator, so there is only something to do if the data is owned
+  if(list->allocator != NULL && list->allocator->freesInBulk && list->deleteData == NULL)
+  {
+    free(list);
+    return;
+  }
+
   //free each node including data in note(data in node is cleared through deleteData)
   while(list->head!=NULL)
   {
     nodeHolder = list->head;
     list->head = list->head->next;
-    list->deleteData(nodeHolder->data);//might need to add more for deleting many data types
-    free(nodeHolder);
+    deleteNodeData(list,nodeHolder->data);//might need to add more for deleting many data types
+    releaseNode(list,nodeHolder);
   }
   //free the list itself
   free(list);
@@ -185,68 +705,336 @@ void deleteList(List *list)
 *@param list a pointer to the dummy head of the list containing function pointers for delete and compare, as well
 as a pointer to the first and last element of the list.
 *@param toBeAdded a pointer to data that is to be added to the linked list
+*@return the node holding the data, a handle like the one insertBack returns. NULL if list is NULL or memory could not be allocated
 **/
-void insertSorted(List *list, void *data)
+Node *insertSorted(List *list, void *data)
 {
   //check if list exists
   if(list == NULL)
   {
-    return;
+    return NULL;
+  }
+  if(list->index != NULL)
+  {
+    return insertIntoSkipList(list,data);
   }
 
   //creating nodes
-  Node *nodeToBeAdded = initializeNode(data);
+  Node *nodeToBeAdded = allocateNode(list,data);
   Node *nodeToBeCompared = list->head;
+  unsigned long long visited = 0;  //nodes compared, for --stats
+  if(nodeToBeAdded == NULL)
+  {
+    return NULL;
+  }
 
   //check if head == null
   if (list->head == NULL)
   {
     list->head = nodeToBeAdded;
     list->tail = nodeToBeAdded;
-    return;
+    return nodeToBeAdded;
   }
   while(nodeToBeCompared!=NULL)
   {
+    visited++;
     if(list->compare(nodeToBeCompared->data,nodeToBeAdded->data) < 0)
     {
       if(nodeToBeCompared->next == NULL)
       {
+        COUNT_SCAN(visited);
+        COUNT(compares,visited);
         nodeToBeCompared->next = nodeToBeAdded;
         nodeToBeAdded->previous = nodeToBeCompared;
         list->tail = nodeToBeAdded;
-        return;
+        return nodeToBeAdded;
       }
       nodeToBeCompared=nodeToBeCompared->next;
     }
     else
     {
+      COUNT_SCAN(visited);
+      COUNT(compares,visited);
       if (list->head == nodeToBeCompared)
       {
         list->head = nodeToBeAdded;
         nodeToBeCompared->previous = nodeToBeAdded;
         nodeToBeAdded->next = nodeToBeCompared;
-        return;
+        return nodeToBeAdded;
       }
       nodeToBeCompared->previous->next = nodeToBeAdded;
       nodeToBeAdded->previous = nodeToBeCompared->previous;
       nodeToBeCompared->previous = nodeToBeAdded;
       nodeToBeAdded->next = nodeToBeCompared;
-      return;
+      return nodeToBeAdded;
 
     }
   }
 
-  return;
+  return nodeToBeAdded;
+}
+/**Function to stably sort an array of data with the list's compare function. This is a bottom up merge sort,
+this has a big O notation of N log N.
+*@pre data and buffer must both have room for count pointers
+*@param compare function used to order the data
+*@param data array to be sorted
+*@param buffer scratch space of the same size as data
+**/
+static void mergeSortData(int (*compare)(void *first,void *second), void **data, void **buffer, size_t count)
+{
+  void **from = data;
+  void **to = buffer;
+  void **swap;
+  size_t width;
+  size_t left;
+  unsigned long long compared = 0;  //calls of compare, for --stats
+
+  for(width = 1; width < count; width = width*2)
+  {
+    for(left = 0; left < count; left = left + 2*width)
+    {
+      size_t middle = (left + width < count) ? left + width : count;
+      size_t right = (left + 2*width < count) ? left + 2*width : count;
+      size_t i = left;
+      size_t j = middle;
+      size_t k = left;
+
+      //taking from the left run on ties keeps the sort stable
+      while(i < middle && j < right)
+      {
+        compared++;
+        if(compare(from[j],from[i]) < 0)
+        {
+          to[k++] = from[j++];
+        }
+        else
+        {
+          to[k++] = from[i++];
+        }
+      }
+      while(i < middle)
+      {
+        to[k++] = from[i++];
+      }
+      while(j < right)
+      {
+        to[k++] = from[j++];
+      }
+    }
+    swap = from;
+    from = to;
+    to = swap;
+  }
+
+  COUNT(compares,compared);
+
+  //making sure the sorted result ends up in data
+  if(from != data)
+  {
+    memcpy(data, from, count*sizeof(void *));
+  }
+}
+
+/**Function to merge data that is already sorted into the list in one pass, new data goes before the first node
+*that is not smaller, so it lands in front of the equal nodes already in the list. The index of a skip list is
+*built again afterwards.
+*@param list a pointer to the dummy head of the list containing the compare function pointer
+*@param sorted the data to be added, sorted with the compare function of the list
+*@param count number of elements in sorted
+*@return EXIT_SUCCESS on success, EXIT_FAILURE if memory could not be allocated, the data merged before that stays
+*in the list
+**/
+static int mergeIntoList(List *list, void **sorted, size_t count)
+{
+  size_t i;
+  Node *nodeToBeCompared = list->head;
+  unsigned long long visited = 0;   //nodes stepped over, for --stats
+  unsigned long long compared = 0;  //calls of compare, for --stats
+  for(i = 0; i < count; i++)
+  {
+    Node *nodeToBeAdded = allocateNode(list,sorted[i]);
+    if(nodeToBeAdded == NULL)
+    {
+      break;
+    }
+
+    while(nodeToBeCompared != NULL && (compared++, list->compare(nodeToBeCompared->data,nodeToBeAdded->data) < 0))
+    {
+      visited++;
+      nodeToBeCompared = nodeToBeCompared->next;
+    }
+
+    linkBefore(list,nodeToBeAdded,nodeToBeCompared);
+  }
+
+  COUNT_SCAN(visited);
+  COUNT(compares,compared);
+
+  //the new nodes are not in the index yet, building it again costs no more than the pass that was just made
+  if(list->index != NULL)
+  {
+    rebuildSkipIndex(list);
+  }
+  return (i == count) ? EXIT_SUCCESS : EXIT_FAILURE;
 }
+
+/** Inserts a whole array of data into the list with one sort and one pass over the list, instead of calling
+*insertSorted once per element. The list ends up exactly as if insertSorted had been called on each element in
+*array order, meaning equal elements are placed in front of the equal elements that were added before them.
+*this has a big O notation of N log N + M, N being count and M being the length of the list.
+*@pre List exists and has memory allocated to it. Every element of data is valid.
+*@post the list owns all of the data and stays sorted
+*@param list a pointer to the dummy head of the list containing the compare function pointer
+*@param data array of pointers to the data to be added, the array itself is not kept by the list
+*@param count number of elements in data
+*@return EXIT_SUCCESS on success, EXIT_FAILURE if memory could not be allocated
+**/
+int insertSortedBulk(List *list, void **data, size_t count)
+{
+  //check if list exists
+  if(list == NULL || data == NULL)
+  {
+    return EXIT_FAILURE;
+  }
+  if(count == 0)
+  {
+    return EXIT_SUCCESS;
+  }
+
+  void **sorted = malloc(sizeof(void *)*count);
+  void **buffer = malloc(sizeof(void *)*count);
+  if(sorted == NULL || buffer == NULL)
+  {
+    free(sorted);
+    free(buffer);
+    return EXIT_FAILURE;
+  }
+
+  //insertSorted puts later elements in front of equal ones, so a stable sort of the reversed array gives the same order
+  size_t i;
+  for(i = 0; i < count; i++)
+  {
+    sorted[i] = data[count - 1 - i];
+  }
+  mergeSortData(list->compare, sorted, buffer, count);
+  free(buffer);
+
+  int result = mergeIntoList(list, sorted, count);
+  free(sorted);
+  return result;
+}
+
+/**Function to sort cars by time of arrival with a least significant digit first radix sort, a byte of the time at
+*a time. Each pass is stable, so cars with the same time keep the order they had. Bytes that are the same for
+*every car are skipped, for times of a day only three or four of the eight passes are done.
+*@param cars the cars to be sorted
+*@param buffer scratch space of the same size as cars
+*@param count number of cars
+**/
+static void radixSortCars(Data **cars, Data **buffer, size_t count)
+{
+  size_t histogram[8][256];
+  Data **from = cars;
+  Data **to = buffer;
+  Data **swap;
+
+  memset(histogram,0,sizeof(histogram));
+  //flipping the sign bit puts negative times in front of the others
+  for(size_t i = 0; i < count; i++)
+  {
+    uint64_t key = (uint64_t)cars[i]->timeOfArrival ^ ((uint64_t)1 << 63);
+    for(int digit = 0; digit < 8; digit++)
+    {
+      histogram[digit][(key >> (8*digit)) & 0xff]++;
+    }
+  }
+
+  for(int digit = 0; digit < 8; digit++)
+  {
+    size_t *counts = histogram[digit];
+    size_t start = 0;
+    uint64_t firstKey = (uint64_t)from[0]->timeOfArrival ^ ((uint64_t)1 << 63);
+    if(counts[(firstKey >> (8*digit)) & 0xff] == count)
+    {
+      continue;
+    }
+    //turning the counts into the first position of each byte value
+    for(int value = 0; value < 256; value++)
+    {
+      size_t amount = counts[value];
+      counts[value] = start;
+      start = start + amount;
+    }
+    for(size_t i = 0; i < count; i++)
+    {
+      uint64_t key = (uint64_t)from[i]->timeOfArrival ^ ((uint64_t)1 << 63);
+      to[counts[(key >> (8*digit)) & 0xff]++] = from[i];
+    }
+    swap = from;
+    from = to;
+    to = swap;
+  }
+
+  //making sure the sorted result ends up in cars
+  if(from != cars)
+  {
+    memcpy(cars, from, count*sizeof(Data *));
+  }
+}
+
+/** Inserts a whole array of cars into a list sorted by time of arrival, like insertSortedBulk, but the cars are put
+*in order with a radix sort of their whole number times instead of calls to the compare function.
+*this has a big O notation of N + M, N being count and M being the length of the list.
+*@pre List exists, holds Data and is sorted by timeOfArrival with compareTimeFunction. Every car is valid.
+*@post the list owns all of the cars and stays sorted
+*@param list a pointer to the dummy head of the list
+*@param cars array of pointers to the cars to be added, the array itself is not kept by the list
+*@param count number of elements in cars
+*@return EXIT_SUCCESS on success, EXIT_FAILURE if memory could not be allocated
+**/
+int insertSortedByTime(List *list, Data **cars, size_t count)
+{
+  //check if list exists
+  if(list == NULL || cars == NULL)
+  {
+    return EXIT_FAILURE;
+  }
+  if(count == 0)
+  {
+    return EXIT_SUCCESS;
+  }
+
+  Data **sorted = malloc(sizeof(Data *)*count);
+  Data **buffer = malloc(sizeof(Data *)*count);
+  if(sorted == NULL || buffer == NULL)
+  {
+    free(sorted);
+    free(buffer);
+    return EXIT_FAILURE;
+  }
+
+  //the same reversal as insertSortedBulk, so cars with the same time end up in the same order
+  for(size_t i = 0; i < count; i++)
+  {
+    sorted[i] = cars[count - 1 - i];
+  }
+  radixSortCars(sorted, buffer, count);
+  free(buffer);
+
+  int result = mergeIntoList(list, (void **)sorted, count);
+  free(sorted);
+  return result;
+}
+
 /**Function to return the data at the front of the list.
  *@pre The list exists and has memory allocated to it
  *@param list pointer to the dummy head of the list containing the head of the list
- *@return pointer to the data located at the head of the list
+ *@return pointer to the data located at the head of the list, NULL if the list is empty
  **/
 void *getFromFront(List *list)
 {
-  //check if list exists
-  if(list == NULL)
+  //check if list exists and has a head
+  if(list == NULL || list->head == NULL)
   {
     return NULL;
   }
@@ -254,6 +1042,54 @@ void *getFromFront(List *list)
   //returns pointer to data located at head of the list.
   return list->head->data;
 }
+
+/**Function to remove the node at the front of the list without deleting its data.
+ *@pre The list exists and has memory allocated to it
+ *@post the head node is freed and the head of the list is moved to the next node
+ *@param list pointer to the dummy head of the list
+ *@return pointer to the data that was at the head of the list, NULL if the list is empty
+ **/
+void *deleteFromFront(List *list)
+{
+  //check if list exists and has a head
+  if(list == NULL || list->head == NULL)
+  {
+    return NULL;
+  }
+
+  Node *oldHead = list->head;
+  void *data = oldHead->data;
+
+  //the links of the head are the first links of the levels its tower reaches
+  if(list->index != NULL)
+  {
+    for(int level = 0; level < list->index->levels; level++)
+    {
+      SkipLink *first = list->index->heads[level].right;
+      if(first == NULL || first->node != oldHead)
+      {
+        break;
+      }
+      list->index->heads[level].right = first->right;
+      releaseLink(list,first);
+    }
+    trimLevels(list->index);
+  }
+
+  //moving the head forward
+  list->head = oldHead->next;
+  if(list->head == NULL)
+  {
+    list->tail = NULL;
+  }
+  else
+  {
+    list->head->previous = NULL;
+  }
+  releaseNode(list,oldHead);
+
+  return data;
+}
 /**Function to print list from head to tail. This will utilize the list's printData function pointer to print.
  *@pre List must exist, but does not have to have elements.
  *@param list Pointer to linked list dummy head.
@@ -308,702 +1144,115 @@ void printBackwards(List *list)
   return;
 }
 
-float calculateTime(List *list)
+/**
+ *Direction queues handed to simulateIntersection by simulateList, one per approach of the junction.
+ **/
+typedef struct listQueues{
+  IntersectionConfig *config;
+  List *queues[INTERSECTION_MAX_APPROACHES];
+} ListQueues;
+
+/**Car source function for calculateTime, hands out the cars of a direction queue in order.
+*@param state the ListQueues
+*@param direction direction of the car wanted
+*@param car where the car is copied to
+*@return 1 when a car was copied, 0 when the direction has no more cars
+**/
+static int nextCarFromQueues(void *state, char direction, Data *car)
 {
-  Data *firstDataN = NULL;
-  Data *firstDataE = NULL;
-  Data *firstDataS = NULL;
-  Data *firstDataW = NULL;
-
+  ListQueues *split = state;
+  int approach = split->config->approachOf[(unsigned char)direction];
+  Data *nextData = NULL;
 
+  if(approach >= 0)
+  {
+    nextData = deleteFromFront(split->queues[approach]);
+  }
+  if(nextData == NULL)
+  {
+    return 0;
+  }
+  *car = *nextData;
+  return 1;
+}
 
-  int west = 0;
-  int east = 0;
-  int north = 0;
-  int south = 0;
-  int amountNorth = 0;
-  int amountEast = 0;
-  int amountWest = 0;
-  int amountSouth = 0;
-  float averageNorth = 0.0;
-  float averageEast = 0.0;
-  float averageSouth = 0.0;
-  float averageWest = 0.0;
-  float maxWaitTime = 0.0;
+SimTime calculateTime(List *list)
+{
+  OutputBuffer *output = initializeOutput(stdout,0);
+  SimTime timeCounter = simulateList(list,NULL,output,OUTPUT_CARS,NULL);
+  deleteOutput(output);
+  return timeCounter;
+}
 
-  //char lastCarThroughIntersectionDirection = 'X';  //stores the last car through
-  //float lastCarThoughIntersectionTime = 0.0;
+/**Function to run the intersection over the cars of a sorted list, writing the results to output.
+*the list is split once into a FIFO queue per direction, so picking the next car of a direction is O(1).
+*@pre List must exist and be sorted by time of arrival, but does not have to have elements.
+*@param list pointer to linked list dummy head
+*@param config the junction (see Intersection.h), NULL for the four way intersection
+*@param output where the results are written
+*@param mode one of OUTPUT_CARS, OUTPUT_SUMMARY, OUTPUT_MACHINE
+*@param stats where the counts and waits of the run are left (see Intersection.h), may be NULL
+*@return the time the last car leaves the intersection
+**/
+SimTime simulateList(List *list, IntersectionConfig *config, OutputBuffer *output, int mode, IntersectionStats *stats)
+{
+  IntersectionConfig defaultConfig;
+  ListQueues split;
+  SimTime timeCounter;
 
-  int northVSEast = -999;
-  int southVsWest = -999;
-  int NEVsSW      = -999;
+  if(config == NULL)
+  {
+    configureIntersection(&defaultConfig,NULL,NULL,1);
+    config = &defaultConfig;
+  }
 
-  float timeCounter=0;
+  //one FIFO per approach, these only borrow the cars (the sorted list still owns them)
+  split.config = config;
+  for(int i = 0; i < config->approaches; i++)
+  {
+    split.queues[i] = initializeListWithAllocator(list->printData,NULL,list->compareNode,list->compare,list->allocator);
+  }
 
   Node *tempNode = list->head;
   Data *tempData = NULL;
 
-//assigning the first of each direction to its respective firstData
+//splitting the sorted list into its approaches once, so each queue stays in order of arrival
   while(tempNode!=NULL)
   {
     tempData = (Data *)tempNode->data;
-    if (tempData->travelDirection == 'N' && north==0)
-    {
-      firstDataN = tempData;
-      north = 1;
-    }
-    if (tempData->travelDirection == 'E' && east==0)
-    {
-      firstDataE = tempData;
-      east = 1;
-    }
-    if (tempData->travelDirection == 'S' && south==0)
+    int approach = config->approachOf[(unsigned char)tempData->travelDirection];
+    if(approach >= 0)
     {
-      firstDataS = tempData;
-      south = 1;
-    }
-    if (tempData->travelDirection == 'W' && west==0)
-    {
-      firstDataW = tempData;
-      west = 1;
+      insertBack(split.queues[approach],tempData);
     }
     tempNode=tempNode->next;
   }
 
-//checking what car goes first
-  while(north!=0 || south!=0 || west!=0 || east!=0)
-  {
-    //comparing north against east
-    if(east == 0)
-    {
-      if(north == 1)
-      {
-        northVSEast = -1;
-      }
-      else
-      {
-        northVSEast = -999;
-      }
-    }
-    else if(north == 0)
-    {
-      northVSEast = 1;
-    }
-    else
-    {
-      northVSEast = list->compare(firstDataN, firstDataE);
-    }
+  CarSource source;
+  source.nextCar = nextCarFromQueues;
+  source.horizon = NULL;
+  source.state = &split;
+  timeCounter = simulateIntersection(&source,config,list->compare,output,mode,stats);
 
-    //comparing south against west
-    if(west == 0)
-    {
-      if(south == 1)
-      {
-        southVsWest = -1;
-      }
-      else
-      {
-        (southVsWest = -999);
-      }
-    }
-    else if(south == 0)
-    {
-      southVsWest = 1;
-    }
-    else
-    {
-      southVsWest = list->compare(firstDataS,firstDataW);
-    }
-
-    //comparing north + east vs south + west
-    if (northVSEast == -999)
-    {
-      if(southVsWest == -999)
-      {
-        return timeCounter;
-      }
-      else
-      {
-        //if both north and east have no cars
-        switch(southVsWest)
-        {
-          case 1: //west arrive first
-            if(timeCounter < firstDataW->timeOfArrival)
-            {
-              timeCounter = firstDataW->timeOfArrival;
-            }
-
-
-            printf("Car going %c, turning %c, arrival time of %6.2f is entering intersection at %6.2f and will leave at "
-                   ,firstDataW->travelDirection
-                   ,firstDataW->turnDirection
-                   ,firstDataW->timeOfArrival
-                   ,timeCounter);
-            if(maxWaitTime<(timeCounter-firstDataW->timeOfArrival)){
-              maxWaitTime = timeCounter-firstDataW->timeOfArrival;
-            }
-            averageWest = averageWest + (timeCounter - firstDataW->timeOfArrival);
-            amountWest++;
-            timeCounter = timeCounter+turnTime(firstDataW);
-            printf("%6.2f\n",timeCounter);
-
-            firstDataW = findNewFirst(list,firstDataW,'W');
-            if (firstDataW == NULL)
-            {
-              west = 0;
-            }
-            break;
-
-          case 0:   //west and south arrive at the same time (south has priority since on the right)
-          case -1:  //south arrives before west
-            if(timeCounter < firstDataS->timeOfArrival)
-            {
-              timeCounter = firstDataS->timeOfArrival;
-            }
-            printf("Car going %c, turning %c, arrival time of %6.2f is entering intersection at %6.2f and will leave at "
-                   ,firstDataS->travelDirection
-                   ,firstDataS->turnDirection
-                   ,firstDataS->timeOfArrival
-                   ,timeCounter);
-            averageSouth = averageSouth + (timeCounter - firstDataS->timeOfArrival);
-            amountSouth++;
-            timeCounter = timeCounter+turnTime(firstDataS);
-            printf("%6.2f\n",timeCounter);
-
-            firstDataS = findNewFirst(list,firstDataS,'S');
-            if (firstDataS == NULL)
-            {
-              south = 0;
-            }
-            break;
-        }
-      }
-    }
-    else if (southVsWest == -999)
-    {
-      //if both south and west have no cards
-      switch(northVSEast)
-      {
-        case 1://east arrives first
-          if(timeCounter < firstDataE->timeOfArrival)
-          {
-            timeCounter = firstDataE->timeOfArrival;
-          }
-          printf("Car going %c, turning %c, arrival time of %6.2f is entering intersection at %6.2f and will leave at "
-                 ,firstDataE->travelDirection
-                 ,firstDataE->turnDirection
-                 ,firstDataE->timeOfArrival
-                 ,timeCounter);
-          averageEast = averageEast + (timeCounter - firstDataE->timeOfArrival);
-          amountEast++;
-          timeCounter = timeCounter+turnTime(firstDataE);
-          printf("%6.2f\n",timeCounter);
-
-          firstDataE = findNewFirst(list,firstDataE,'E');
-          if (firstDataE == NULL)
-          {
-            east = 0;
-          }
-          break;
-        case 0://north and east arrive at same time(north is on right so has priority)
-        case -1:// north arrives first
-          if(timeCounter < firstDataN->timeOfArrival)
-          {
-            timeCounter=firstDataN->timeOfArrival;
-          }
-          printf("Car going %c, turning %c, arrival time of %6.2f is entering intersection at %6.2f and will leave at "
-                 ,firstDataN->travelDirection
-                 ,firstDataN->turnDirection
-                 ,firstDataN->timeOfArrival
-                 ,timeCounter);
-          timeCounter = timeCounter+turnTime(firstDataN);
-          printf("%6.2f\n",timeCounter);
-          firstDataN = findNewFirst(list,firstDataN,'N');
-          if (firstDataN == NULL)
-          {
-            north = 0;
-          }
-          break;
-      }
-    }
-    //checking which cars are to be compared for north + east vs south + west, then comparing
-    else if(northVSEast>=0)//east arrives first or north and east arrive at the same time
-    {
-      if(southVsWest>=0)//west arrives first or south and west arrive at the same time
-      {
-        NEVsSW = list->compare(firstDataE,firstDataW);
-      }
-      else //south arrives first between south and west
-      {
-        NEVsSW = list->compare(firstDataE,firstDataS);
-      }
-    }
-    else //north arrives first between north and east
-    {
-      if(southVsWest >= 0)//west arrives first or south and west arrive at the same time
-      {
-        NEVsSW = list->compare(firstDataN,firstDataW);
-      }
-      else//south arrives first between south and west
-      {
-        NEVsSW = list->compare(firstDataN,firstDataS);
-      }
-    }
-
-    //comparing cars to see which is first if there is at least one car in either north + east and at least one car in either south + west
-    switch(NEVsSW)
-    {
-      case 1://if NEVsSW==1 southVsWest arrives before northVsEast
-        switch(southVsWest)
-        {
-          case 1:
-            if(timeCounter < firstDataW->timeOfArrival)
-            {
-              timeCounter = firstDataW->timeOfArrival;
-            }
-            printf("Car going %c, turning %c, arrival time of %6.2f is entering intersection at %6.2f and will leave at "
-                   ,firstDataW->travelDirection
-                   ,firstDataW->turnDirection
-                   ,firstDataW->timeOfArrival
-                   ,timeCounter);
-            if(maxWaitTime<(timeCounter-firstDataW->timeOfArrival)){
-              maxWaitTime = timeCounter-firstDataW->timeOfArrival;
-            }
-            averageWest = averageWest + (timeCounter - firstDataW->timeOfArrival);
-            amountWest++;
-            timeCounter = timeCounter+turnTime(firstDataW);
-            printf("%6.2f\n",timeCounter);
-            firstDataW = findNewFirst(list,firstDataW,'W');
-            if (firstDataW == NULL)
-            {
-              west = 0;
-            }
-            break;
-          case 0:
-            if(timeCounter < firstDataS->timeOfArrival)
-            {
-              timeCounter = firstDataS->timeOfArrival;
-            }
-            printf("Car going %c, turning %c, arrival time of %6.2f is entering intersection at %6.2f and will leave at "
-                   ,firstDataS->travelDirection
-                   ,firstDataS->turnDirection
-                   ,firstDataS->timeOfArrival
-                   ,timeCounter);
-            if(maxWaitTime<(timeCounter-firstDataS->timeOfArrival)){
-              maxWaitTime = timeCounter-firstDataS->timeOfArrival;
-            }
-            averageSouth = averageSouth + (timeCounter - firstDataS->timeOfArrival);
-            amountSouth++;
-            timeCounter = timeCounter+turnTime(firstDataS);
-            printf("%6.2f\n",timeCounter);
-
-            firstDataS = findNewFirst(list,firstDataS,'S');
-            if (firstDataS == NULL)
-            {
-              south = 0;
-            }
-            break;
-          case -1:
-            if(timeCounter < firstDataS->timeOfArrival)
-            {
-              timeCounter = firstDataS->timeOfArrival;
-            }
-            printf("Car going %c, turning %c, arrival time of %6.2f is entering intersection at %6.2f and will leave at "
-                   ,firstDataS->travelDirection
-                   ,firstDataS->turnDirection
-                   ,firstDataS->timeOfArrival
-                   ,timeCounter);
-            if(maxWaitTime<(timeCounter-firstDataS->timeOfArrival)){
-              maxWaitTime = timeCounter-firstDataS->timeOfArrival;
-            }
-            averageSouth = averageSouth + (timeCounter - firstDataS->timeOfArrival);
-            amountSouth++;
-            timeCounter = timeCounter+turnTime(firstDataS);
-            printf("%6.2f\n",timeCounter);
-            firstDataS = findNewFirst(list,firstDataS,'S');
-            if (firstDataS == NULL)
-            {
-              south = 0;
-            }
-            break;
-        }
-        break;
-      //ifNSVsSW==-1
-      case -1:
-        switch(northVSEast)
-        {
-          case 1:
-            if(timeCounter < firstDataE->timeOfArrival)
-            {
-              timeCounter = firstDataE->timeOfArrival;
-            }
-            printf("Car going %c, turning %c, arrival time of %6.2f is entering intersection at %6.2f and will leave at "
-                   ,firstDataE->travelDirection
-                   ,firstDataE->turnDirection
-                   ,firstDataE->timeOfArrival
-                   ,timeCounter);
-            if(maxWaitTime<(timeCounter-firstDataE->timeOfArrival)){
-              maxWaitTime = timeCounter-firstDataE->timeOfArrival;
-            }
-            averageEast = averageEast + (timeCounter - firstDataE->timeOfArrival);
-            amountEast++;
-            timeCounter = timeCounter+turnTime(firstDataE);
-            printf("%6.2f\n",timeCounter);
-            firstDataE = findNewFirst(list,firstDataE,'E');
-            if (firstDataE == NULL)
-            {
-              east = 0;
-            }
-            break;
-          case 0:
-            if(timeCounter < firstDataN->timeOfArrival)
-            {
-              timeCounter = firstDataN->timeOfArrival;
-            }
-            printf("Car going %c, turning %c, arrival time of %6.2f is entering intersection at %6.2f and will leave at "
-                   ,firstDataN->travelDirection
-                   ,firstDataN->turnDirection
-                   ,firstDataN->timeOfArrival
-                   ,timeCounter);
-            if(maxWaitTime<(timeCounter-firstDataN->timeOfArrival)){
-              maxWaitTime = timeCounter-firstDataN->timeOfArrival;
-            }
-            averageNorth = averageNorth + (timeCounter - firstDataN->timeOfArrival);
-            amountNorth++;
-            timeCounter = timeCounter+turnTime(firstDataN);
-            printf("%6.2f\n",timeCounter);
-            firstDataN = findNewFirst(list,firstDataN,'N');
-            if (firstDataN == NULL)
-            {
-              north = 0;
-            }
-            break;
-          case -1:
-            if(timeCounter < firstDataN->timeOfArrival)
-            {
-              timeCounter = firstDataN->timeOfArrival;
-            }
-            printf("Car going %c, turning %c, arrival time of %6.2f is entering intersection at %6.2f and will leave at "
-                   ,firstDataN->travelDirection
-                   ,firstDataN->turnDirection
-                   ,firstDataN->timeOfArrival
-                   ,timeCounter);
-            if(maxWaitTime<(timeCounter-firstDataN->timeOfArrival)){
-              maxWaitTime = timeCounter-firstDataN->timeOfArrival;
-            }
-            averageNorth = averageNorth + (timeCounter - firstDataN->timeOfArrival);
-            amountNorth++;
-            timeCounter = timeCounter+turnTime(firstDataN);
-            printf("%6.2f\n",timeCounter);
-
-            firstDataN = findNewFirst(list,firstDataN,'N');
-            if (firstDataN == NULL)
-            {
-              north = 0;
-            }
-            break;
-        }
-        break;
-      //ifNEvsSW==0
-      case 0:// northVsEast and southVsWest arrived at same time
-        switch(northVSEast)
-        {
-          case 1://east first vs north
-            switch(southVsWest)
-            {
-              case 1: //east and west are both first
-                if(   (turnTime(firstDataE)==2)                                      //east going straight wins
-                      || (turnTime(firstDataE)==turnTime(firstDataW))                   //east and west have same turning direction, east wins
-                      || (turnTime(firstDataE)==1.5 && turnTime(firstDataW)==3.5) )     //east turning right vs west turning left, east wins
-                {
-                  if(timeCounter < firstDataE->timeOfArrival)
-                  {
-                    timeCounter = firstDataE->timeOfArrival;
-                  }
-                  printf("Car going %c, turning %c, arrival time of %6.2f is entering intersection at %6.2f and will leave at "
-                         ,firstDataE->travelDirection
-                         ,firstDataE->turnDirection
-                         ,firstDataE->timeOfArrival
-                         ,timeCounter);
-                  if(maxWaitTime<(timeCounter-firstDataE->timeOfArrival)){
-                    maxWaitTime = timeCounter-firstDataE->timeOfArrival;
-                  }
-                  averageEast = averageEast + (timeCounter - firstDataE->timeOfArrival);
-                  amountEast++;
-                  timeCounter = timeCounter+turnTime(firstDataE);
-                  printf("%6.2f\n",timeCounter);
-                  firstDataE = findNewFirst(list,firstDataE,'E');
-                  if (firstDataE == NULL)
-                  {
-                    east = 0;
-                  }
-                }
-                else //west wins
-                {
-                  if(timeCounter < firstDataW->timeOfArrival)
-                  {
-                    timeCounter=firstDataW->timeOfArrival;
-                  }
-                  printf("Car going %c, turning %c, arrival time of %6.2f is entering intersection at %6.2f and will leave at "
-                         ,firstDataW->travelDirection
-                         ,firstDataW->turnDirection
-                         ,firstDataW->timeOfArrival
-                         ,timeCounter);
-                  if(maxWaitTime<(timeCounter-firstDataW->timeOfArrival)){
-                    maxWaitTime = timeCounter-firstDataW->timeOfArrival;
-                  }
-                  averageWest = averageWest + (timeCounter - firstDataW->timeOfArrival);
-                  amountWest++;
-                  timeCounter = timeCounter+turnTime(firstDataW);
-                  printf("%6.2f\n",timeCounter);
-
-                  firstDataW = findNewFirst(list,firstDataW,'W');
-                  if (firstDataW == NULL)
-                  {
-                    west = 0;
-                  }
-                }
-                break;
-              case -1: //east and south are both first, east is on right of south, east wins
-              case 0: //east and west and south all arrive at the same time, east is on the furthest right, east wins
-                if(timeCounter < firstDataE->timeOfArrival)
-                {
-                  timeCounter=firstDataE->timeOfArrival;
-                }
-                printf("Car going %c, turning %c, arrival time of %6.2f is entering intersection at %6.2f and will leave at "
-                       ,firstDataE->travelDirection
-                       ,firstDataE->turnDirection
-                       ,firstDataE->timeOfArrival
-                       ,timeCounter);
-                if(maxWaitTime<(timeCounter-firstDataE->timeOfArrival)){
-                  maxWaitTime = timeCounter-firstDataE->timeOfArrival;
-                }
-                averageEast = averageEast + (timeCounter - firstDataE->timeOfArrival);
-                amountEast++;
-                timeCounter = timeCounter+turnTime(firstDataE);
-                printf("%6.2f\n",timeCounter);
-                firstDataE = findNewFirst(list,firstDataE,'E');
-                if (firstDataE == NULL)
-                {
-                  east = 0;
-                }
-                break;
-            }
-          case -1: //north is first vs east
-            switch(southVsWest)
-            {
-              case 1://north and west are first, west is on right, west wins
-                if(timeCounter < firstDataW->timeOfArrival)
-                {
-                  timeCounter=firstDataW->timeOfArrival;
-                }
-                printf("Car going %c, turning %c, arrival time of %6.2f is entering intersection at %6.2f and will leave at "
-                       ,firstDataW->travelDirection
-                       ,firstDataW->turnDirection
-                       ,firstDataW->timeOfArrival
-                       ,timeCounter);
-                if(maxWaitTime<(timeCounter-firstDataW->timeOfArrival)){
-                  maxWaitTime = timeCounter-firstDataW->timeOfArrival;
-                }
-                averageWest = averageWest + (timeCounter - firstDataW->timeOfArrival);
-                amountWest++;
-                timeCounter = timeCounter+turnTime(firstDataW);
-                printf("%6.2f\n",timeCounter);
-
-                firstDataW = findNewFirst(list,firstDataW,'W');
-                if (firstDataW == NULL)
-                {
-                  west = 0;
-                }
-                break;
-              case -1: //north and south are first
-                if(   (turnTime(firstDataN)==2)                                      //north going straight wins
-                      || (turnTime(firstDataN)==turnTime(firstDataS))                   //north and south have same turning direction, north wins
-                      || (turnTime(firstDataN)==1.5 && turnTime(firstDataS)==3.5) )     //north turning right vs south turning left, north wins
-                {
-                  if(timeCounter < firstDataN->timeOfArrival)
-                  {
-                    timeCounter=firstDataN->timeOfArrival;
-                  }
-                  printf("Car going %c, turning %c, arrival time of %6.2f is entering intersection at %6.2f and will leave at "
-                         ,firstDataN->travelDirection
-                         ,firstDataN->turnDirection
-                         ,firstDataN->timeOfArrival
-                         ,timeCounter);
-                  if(maxWaitTime<(timeCounter-firstDataN->timeOfArrival)){
-                    maxWaitTime = timeCounter-firstDataN->timeOfArrival;
-                  }
-                  averageNorth = averageNorth + (timeCounter - firstDataN->timeOfArrival);
-                  amountNorth++;
-                  timeCounter = timeCounter+turnTime(firstDataN);
-                  printf("%6.2f\n",timeCounter);
-                  firstDataN = findNewFirst(list,firstDataN,'N');
-                  if (firstDataN == NULL)
-                  {
-                    north = 0;
-                  }
-                }
-                else//south wins
-                {
-                  if(timeCounter < firstDataS->timeOfArrival)
-                  {
-                    timeCounter=firstDataS->timeOfArrival;
-                  }
-                  printf("Car going %c, turning %c, arrival time of %6.2f is entering intersection at %6.2f and will leave at "
-                         ,firstDataS->travelDirection
-                         ,firstDataS->turnDirection
-                         ,firstDataS->timeOfArrival
-                         ,timeCounter);
-                  if(maxWaitTime<(timeCounter-firstDataS->timeOfArrival)){
-                    maxWaitTime = timeCounter-firstDataS->timeOfArrival;
-                  }
-                  averageSouth = averageSouth + (timeCounter - firstDataS->timeOfArrival);
-                  amountSouth++;
-                  timeCounter = timeCounter+turnTime(firstDataS);
-                  printf("%6.2f\n",timeCounter);
-                  firstDataS = findNewFirst(list,firstDataS,'S');
-                  if (firstDataS == NULL)
-                  {
-                    south = 0;
-                  }
-                }
-                break;
-              case 0: //north and south and west all arrive at the same time, south is on the furthest right, south wins
-                if(timeCounter < firstDataS->timeOfArrival)
-                {
-                  timeCounter=firstDataS->timeOfArrival;
-                }
-                printf("Car going %c, turning %c, arrival time of %6.2f is entering intersection at %6.2f and will leave at "
-                       ,firstDataS->travelDirection
-                       ,firstDataS->turnDirection
-                       ,firstDataS->timeOfArrival
-                       ,timeCounter);
-                if(maxWaitTime<(timeCounter-firstDataS->timeOfArrival)){
-                  maxWaitTime = timeCounter-firstDataS->timeOfArrival;
-                }
-                averageSouth = averageSouth + (timeCounter - firstDataS->timeOfArrival);
-                amountSouth++;
-                timeCounter = timeCounter+turnTime(firstDataS);
-                printf("%6.2f\n",timeCounter);
-                firstDataS = findNewFirst(list,firstDataS,'S');
-                if (firstDataS == NULL)
-                {
-                  south = 0;
-                }
-                break;
-            }
-          case 0: //north and east arrive at the same time
-            switch(southVsWest)
-            {
-              case 1://north and east and west arrive at the same time, west is the furthest right, west wins
-                if(timeCounter < firstDataW->timeOfArrival)
-                {
-                  timeCounter=firstDataW->timeOfArrival;
-                }
-                printf("Car going %c, turning %c, arrival time of %6.2f is entering intersection at %6.2f and will leave at "
-                       ,firstDataW->travelDirection
-                       ,firstDataW->turnDirection
-                       ,firstDataW->timeOfArrival
-                       ,timeCounter);
-                if(maxWaitTime<(timeCounter-firstDataW->timeOfArrival)){
-                  maxWaitTime = timeCounter-firstDataW->timeOfArrival;
-                }
-                averageWest = averageWest + (timeCounter - firstDataW->timeOfArrival);
-                amountWest++;
-                timeCounter = timeCounter+turnTime(firstDataW);
-                printf("%6.2f\n",timeCounter);
-                firstDataW = findNewFirst(list,firstDataW,'W');
-                if (firstDataW == NULL)
-                {
-                  west = 0;
-                }
-                break;
-              case -1:// north and east and south all arrive at the same time, north is the furthest to the right, north wins
-                if(timeCounter < firstDataN->timeOfArrival)
-                {
-                  timeCounter=firstDataN->timeOfArrival;
-                }
-                printf("Car going %c, turning %c, arrival time of %6.2f is entering intersection at %6.2f and will leave at "
-                       ,firstDataN->travelDirection
-                       ,firstDataN->turnDirection
-                       ,firstDataN->timeOfArrival
-                       ,timeCounter);
-                if(maxWaitTime<(timeCounter-firstDataN->timeOfArrival)){
-                  maxWaitTime = timeCounter-firstDataN->timeOfArrival;
-                }
-                averageNorth = averageNorth + (timeCounter - firstDataN->timeOfArrival);
-                amountNorth++;
-                timeCounter = timeCounter+turnTime(firstDataN);
-                printf("%6.2f\n",timeCounter);
-
-                firstDataN = findNewFirst(list,firstDataN,'N');
-                if (firstDataN == NULL)
-                {
-                  north = 0;
-                }
-                break;
-              case 0: //all cars arrive at the same time, north wins(assumption made)
-                if(timeCounter < firstDataN->timeOfArrival)
-                {
-                  timeCounter=firstDataN->timeOfArrival;
-                }
-                printf("Car going %c, turning %c, arrival time of %6.2f is entering intersection at %6.2f and will leave at "
-                       ,firstDataN->travelDirection
-                       ,firstDataN->turnDirection
-                       ,firstDataN->timeOfArrival
-                       ,timeCounter);
-                if(maxWaitTime<(timeCounter-firstDataN->timeOfArrival)){
-                  maxWaitTime = timeCounter-firstDataN->timeOfArrival;
-                }
-                averageNorth = averageNorth + (timeCounter - firstDataN->timeOfArrival);
-                amountNorth++;
-                timeCounter = timeCounter+turnTime(firstDataN);
-                printf("%6.2f\n",timeCounter);
-                firstDataN = findNewFirst(list,firstDataN,'N');
-                if (firstDataN == NULL)
-                {
-                  north = 0;
-                }
-                break;
-            }
-        }
-    }
-  }
-  if (amountNorth !=0)
-  {
-    printf("average wait time for north:%6.2f\n",(averageNorth/amountNorth));
-  }
-  if (amountEast!=0)
-  {
-    printf("average wait time for east:%6.2f\n",(averageEast/amountEast));
-  }
-  if (amountSouth!=0)
-  {
-    printf("average wait time for south:%6.2f\n",(averageSouth/amountSouth));
-  }
-  if (amountWest!=0)
+  for(int i = 0; i < config->approaches; i++)
   {
-     printf("average wait time for west:%6.2f\n",(averageWest/amountWest));
+    deleteList(split.queues[i]);
   }
-  if (amountNorth !=0 && amountSouth!=0 && amountEast!=0 && amountWest!=0){
-    printf("average wait time:%6.2f\n",((averageEast+averageNorth+averageSouth+averageWest)/(amountEast+amountNorth+amountSouth+amountWest)));
-  }
-  printf("Max wait time:%6.2f\n",maxWaitTime);
   return timeCounter;
 }
 
-float turnTime(Data *firstData)
+SimTime turnTime(Data *firstData)
 {
   switch(firstData->turnDirection)
   {
     case 'F':
-      return 2.0;
+      return 2*TIME_UNITS_PER_SECOND;
       break;
     case 'R':
-      return 1.5;
+      return 3*TIME_UNITS_PER_SECOND/2;
       break;
     case 'L':
-      return 3.5;
+      return 7*TIME_UNITS_PER_SECOND/2;
       break;
     default:
       printf("invalid input:%c fix input file",firstData->turnDirection);
@@ -1011,29 +1260,28 @@ float turnTime(Data *firstData)
   }
 }
 
-Data* findNewFirst(List *list,Data *firstData, char direction)
+Node *findNewFirst(List *list, Node *first, char direction)
 {
-  Data *newFirstData = NULL;
+  Node *tempNode = nextNode(first);
   Data *tempData = NULL;
+  unsigned long long visited = 0;  //nodes looked at, for --stats
 
-  deleteDataFromList(list,firstData);
-
-
-  Node *tempNode = list->head;
+  //removes old data first, by its handle so two cars that are the same are never mixed up
+  deleteNodeData(list,removeNode(list,first));
 
-  //removes old data first
+  //the cars of the direction in front of the old first are gone, so the new first is after where it was
   while(tempNode!=NULL)
   {
+    visited++;
     tempData= (Data *)tempNode->data;
     if (tempData->travelDirection == direction)
     {
-      newFirstData = tempData;
-      return newFirstData;
+      COUNT_SCAN(visited);
+      return tempNode;
     }
-    tempNode=tempNode->next;
+    tempNode=nextNode(tempNode);
   }
+  COUNT_SCAN(visited);
   return NULL;
 
 }
-
-
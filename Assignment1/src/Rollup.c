@@ -0,0 +1,240 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../include/Rollup.h"
+
+#define ROLLUP_INITIAL_WINDOWS 64  //windows the ring holds at first, it doubles when a car leaves further ahead
+
+/**Function to get the counts of the approaches in a window.
+*@param rollup the windows
+*@param window number of the window, an open one
+*@return the counts of its first approach, the others follow
+**/
+static WindowCounts *countsOf(WindowRollup *rollup, int64_t window)
+{
+  return &rollup->counts[((size_t)window & (rollup->capacity - 1))*(size_t)rollup->config->approaches];
+}
+
+/**Function to create the windows of a run.
+*@return pointer to the windows, NULL if memory could not be allocated
+*@param length ticks of a window, more than 0
+*@param config the junction, giving the approaches and their names
+*@param output where the windows are printed as they close
+*@param mode OUTPUT_CARS and OUTPUT_SUMMARY print a line of text per approach, OUTPUT_MACHINE a line of JSON per window
+**/
+WindowRollup *initializeRollup(SimTime length, IntersectionConfig *config, OutputBuffer *output, int mode)
+{
+  WindowRollup *newRollup = malloc(sizeof(WindowRollup)*1);
+  if(newRollup == NULL)
+  {
+    return NULL;
+  }
+  newRollup->counts = calloc((size_t)ROLLUP_INITIAL_WINDOWS*(size_t)config->approaches,sizeof(WindowCounts));
+  if(newRollup->counts == NULL)
+  {
+    free(newRollup);
+    return NULL;
+  }
+  newRollup->length = length;
+  newRollup->first = 0;
+  newRollup->last = -1;
+  newRollup->closesAt = INT64_MAX;
+  newRollup->capacity = ROLLUP_INITIAL_WINDOWS;
+  newRollup->config = config;
+  newRollup->output = output;
+  newRollup->mode = mode;
+  return newRollup;
+}
+
+/**Function to make the ring hold every window up to one, doubling it until it does and moving the open windows to
+*their places in the new ring.
+*@return EXIT_SUCCESS on success, EXIT_FAILURE if memory could not be allocated
+*@param rollup the windows
+*@param window number of the window, not before the oldest open one
+**/
+static int growRollup(WindowRollup *rollup, int64_t window)
+{
+  size_t approaches = (size_t)rollup->config->approaches;
+  size_t capacity = rollup->capacity;
+  while((uint64_t)(window - rollup->first) >= capacity)
+  {
+    capacity = capacity*2;
+  }
+
+  WindowCounts *newCounts = calloc(capacity*approaches,sizeof(WindowCounts));
+  if(newCounts == NULL)
+  {
+    return EXIT_FAILURE;
+  }
+  for(int64_t n = rollup->first; n <= rollup->last; n++)
+  {
+    memcpy(&newCounts[((size_t)n & (capacity - 1))*approaches],countsOf(rollup,n),sizeof(WindowCounts)*approaches);
+  }
+  free(rollup->counts);
+  rollup->counts = newCounts;
+  rollup->capacity = capacity;
+  return EXIT_SUCCESS;
+}
+
+/**Function to count a car that has gone into the intersection, in the window it arrived in and the one it leaves in.
+*@param rollup the windows
+*@param approach approach of the car
+*@param timeOfArrival when the car arrived
+*@param waitTime how long it waited
+*@param leaveTime when it leaves the intersection
+**/
+void recordRollup(WindowRollup *rollup, int approach, SimTime timeOfArrival, SimTime waitTime, SimTime leaveTime)
+{
+  int64_t arrived = timeOfArrival/rollup->length;
+  int64_t leaves = leaveTime/rollup->length;
+
+  //with no window open the oldest one is the one this car arrived in, nothing before it has to be printed
+  if(rollup->last < rollup->first)
+  {
+    rollup->first = arrived;
+    rollup->closesAt = (arrived + 1)*rollup->length;
+  }
+  //no car still to go arrives in a window that has closed, a car that did anyway counts in the oldest open one
+  if(arrived < rollup->first)
+  {
+    arrived = rollup->first;
+  }
+  if(leaves < arrived)
+  {
+    leaves = arrived;
+  }
+  if((uint64_t)(leaves - rollup->first) >= rollup->capacity && growRollup(rollup,leaves) != EXIT_SUCCESS)
+  {
+    fprintf(stderr,"not enough memory for the windows, a car is left out of them\n");
+    return;
+  }
+
+  WindowCounts *counts = countsOf(rollup,arrived) + approach;
+  counts->arrivals++;
+  counts->totalWait = counts->totalWait + waitTime;
+  if(waitTime > counts->maxWait)
+  {
+    counts->maxWait = waitTime;
+  }
+  countsOf(rollup,leaves)[approach].departures++;
+  if(leaves > rollup->last)
+  {
+    rollup->last = leaves;
+  }
+}
+
+/**Function to print a window that has closed, nothing when no car arrived or left in it.
+*@param rollup the windows
+*@param window number of the window
+**/
+static void printWindow(WindowRollup *rollup, int64_t window)
+{
+  IntersectionConfig *config = rollup->config;
+  OutputBuffer *output = rollup->output;
+  WindowCounts *counts = countsOf(rollup,window);
+  SimTime start = window*rollup->length;
+  char letter[2];
+  int empty = 1;
+
+  for(int i = 0; i < config->approaches; i++)
+  {
+    empty = empty && counts[i].arrivals == 0 && counts[i].departures == 0;
+  }
+  if(empty)
+  {
+    return;
+  }
+
+  if(rollup->mode == OUTPUT_MACHINE)
+  {
+    writeText(output,"{\"window\":{\"start\":");
+    writeTime(output,start,0,2);
+    writeText(output,",\"end\":");
+    writeTime(output,start + rollup->length,0,2);
+    writeChar(output,'}');
+  }
+  for(int i = 0; i < config->approaches; i++)
+  {
+    //cars an hour leaving the intersection over the window
+    double throughput = (double)counts[i].departures*3600.0*TIME_UNITS_PER_SECOND/(double)rollup->length;
+    if(rollup->mode == OUTPUT_MACHINE)
+    {
+      writeText(output,",\"");
+      writeText(output,directionName(config->directions[i],letter));
+      writeText(output,"\":{\"arrivals\":");
+      writeUnsigned(output,counts[i].arrivals);
+      writeText(output,",\"departures\":");
+      writeUnsigned(output,counts[i].departures);
+      writeText(output,",\"throughput\":");
+      writeFixed(output,throughput,0,2);
+      if(counts[i].arrivals != 0)
+      {
+        writeText(output,",\"averageWait\":");
+        writeAverageTime(output,counts[i].totalWait,counts[i].arrivals,0,2);
+        writeText(output,",\"maxWait\":");
+        writeTime(output,counts[i].maxWait,0,2);
+      }
+      else
+      {
+        writeText(output,",\"averageWait\":null,\"maxWait\":null");
+      }
+      writeChar(output,'}');
+      continue;
+    }
+
+    writeText(output,"window ");
+    writeTime(output,start,0,2);
+    writeText(output," to ");
+    writeTime(output,start + rollup->length,0,2);
+    writeChar(output,' ');
+    writeText(output,directionName(config->directions[i],letter));
+    writeText(output,": ");
+    writeUnsigned(output,counts[i].arrivals);
+    writeText(output," arrived, ");
+    writeUnsigned(output,counts[i].departures);
+    writeText(output," left, ");
+    writeFixed(output,throughput,0,2);
+    writeText(output," cars an hour");
+    if(counts[i].arrivals != 0)
+    {
+      writeText(output,", average wait ");
+      writeAverageTime(output,counts[i].totalWait,counts[i].arrivals,0,2);
+      writeText(output,", max wait ");
+      writeTime(output,counts[i].maxWait,0,2);
+    }
+    writeChar(output,'\n');
+  }
+  if(rollup->mode == OUTPUT_MACHINE)
+  {
+    writeText(output,"}\n");
+  }
+}
+
+/**Function to print and close the windows ending at or before the earliest arrival of the cars still to go, no car
+*counted later arrives or leaves in them.
+*@param rollup the windows
+*@param earliest the earliest arrival of the cars still to go, INT64_MAX to close every window at the end of a run
+**/
+void closeRollup(WindowRollup *rollup, SimTime earliest)
+{
+  while(rollup->last >= rollup->first && rollup->closesAt <= earliest)
+  {
+    printWindow(rollup,rollup->first);
+    memset(countsOf(rollup,rollup->first),0,sizeof(WindowCounts)*(size_t)rollup->config->approaches);
+    rollup->first++;
+    rollup->closesAt = (rollup->last >= rollup->first) ? (rollup->first + 1)*rollup->length : INT64_MAX;
+  }
+}
+
+/**Function to free the windows, the ones still open are not printed.
+*@param rollup the windows to be deleted, may be NULL
+**/
+void deleteRollup(WindowRollup *rollup)
+{
+  if(rollup == NULL)
+  {
+    return;
+  }
+  free(rollup->counts);
+  free(rollup);
+}
@@ -0,0 +1,114 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include "../include/SimTime.h"
+
+//powers of ten used to move the decimals in front of the decimal point
+static const uint64_t powersOfTen[] = {
+  UINT64_C(1), UINT64_C(10), UINT64_C(100), UINT64_C(1000), UINT64_C(10000), UINT64_C(100000),
+  UINT64_C(1000000), UINT64_C(10000000), UINT64_C(100000000), UINT64_C(1000000000)
+};
+
+/**Function to give the tick nearest to a number of seconds.
+*@param seconds the time in seconds
+*@return the time in ticks
+**/
+SimTime timeFromSeconds(double seconds)
+{
+  return (SimTime)llround(seconds*TIME_UNITS_PER_SECOND);
+}
+
+/**Function to give a time in seconds, for printing and for statistics that are not times themselves.
+*@param time the time in ticks
+*@return the time in seconds
+**/
+double secondsOf(SimTime time)
+{
+  return (double)time/TIME_UNITS_PER_SECOND;
+}
+
+/**Function to add a time in seconds with a fixed amount of decimals, right aligned, like writeFixed. The digits
+*are worked out from the ticks, halves going to the even digit like printf, so the text is the same on every
+*machine.
+*@param output the writer
+*@param time the time in ticks
+*@param width minimum number of characters, padded with spaces on the left
+*@param decimals digits after the decimal point, at most 9
+**/
+void writeTime(OutputBuffer *output, SimTime time, int width, int decimals)
+{
+  writeAverageTime(output,time,1,width,decimals);
+}
+
+/**Function to add the average of a sum of times in seconds, rounded to the nearest like writeTime.
+*@pre count must not be 0
+*@param output the writer
+*@param total the sum of the times in ticks
+*@param count number of times in the sum
+*@param width minimum number of characters, padded with spaces on the left
+*@param decimals digits after the decimal point, at most 9
+**/
+void writeAverageTime(OutputBuffer *output, SimTime total, uint64_t count, int width, int decimals)
+{
+  char digits[32];
+  char text[72];
+  int negative = (total < 0);
+  uint64_t magnitude = negative ? (uint64_t)0 - (uint64_t)total : (uint64_t)total;
+
+  if(output == NULL || count == 0)
+  {
+    return;
+  }
+
+  //the exact quotient needs total*10^decimals and count*TIME_UNITS_PER_SECOND to fit, past that a double is close enough
+  if(decimals < 0 || decimals > 9 || width > 40
+     || magnitude > UINT64_MAX/powersOfTen[decimals] || count > UINT64_MAX/TIME_UNITS_PER_SECOND)
+  {
+    writeFixed(output,(double)total/(double)count/TIME_UNITS_PER_SECOND,width,decimals);
+    return;
+  }
+
+  uint64_t divisor = count*TIME_UNITS_PER_SECOND;
+  uint64_t scaled = magnitude*powersOfTen[decimals];
+  uint64_t quotient = scaled/divisor;
+  uint64_t remainder = scaled%divisor;
+  //rounding to the nearest, half to even like printf
+  if(remainder > divisor - remainder || (remainder == divisor - remainder && (quotient & 1)))
+  {
+    quotient++;
+  }
+
+  //digits come out last to first, decimals then the point then the whole part
+  int length = 0;
+  for(int i = 0; i < decimals; i++)
+  {
+    digits[length++] = (char)('0' + quotient % 10);
+    quotient = quotient/10;
+  }
+  if(decimals > 0)
+  {
+    digits[length++] = '.';
+  }
+  do
+  {
+    digits[length++] = (char)('0' + quotient % 10);
+    quotient = quotient/10;
+  }while(quotient > 0);
+  if(negative)
+  {
+    digits[length++] = '-';
+  }
+
+  //turned round into text padded to the width, so the writer copies it in one go
+  int used = 0;
+  for(int i = length; i < width; i++)
+  {
+    text[used++] = ' ';
+  }
+  while(length > 0)
+  {
+    text[used++] = digits[--length];
+  }
+  text[used] = '\0';
+  writeText(output,text);
+}
@@ -0,0 +1,466 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../include/Stream.h"
+#include "../include/Checkpoint.h"
+#include "../include/Counters.h"
+
+#define STREAM_SECTION_MAGIC "CARSTRM1"  //first eight bytes of the stream after the state of a refresh
+#define STREAM_SECTION_TAIL 64           //bytes before the offset kept to check the file has only been appended to
+
+/**
+ *What a refresh keeps of its stream after the state of the run. The cars still in the queues follow, queued[i]
+ *cars of approach i from the front of its queue.
+ **/
+typedef struct streamSection{
+    char magic[8];
+    uint64_t offset;              //bytes of the file read
+    uint64_t lineNumber;
+    uint64_t malformedLines;
+    uint64_t carsRead;
+    uint64_t outOfOrderCars;
+    SimTime lastTimeRead;
+    uint64_t queued[INTERSECTION_MAX_APPROACHES];
+    uint32_t tailLength;
+    char tail[STREAM_SECTION_TAIL];   //the last tailLength bytes before offset
+    char reserved[4];
+} StreamSection;
+
+/**Function to get a car of the queue by its position from the front.
+*@param queue the queue
+*@param position 0 for the front of the queue
+**/
+static Data *carAt(CarQueue *queue, size_t position)
+{
+  return &queue->cars[(queue->first + position) % queue->capacity];
+}
+
+/**Function to double the ring of a queue, unwrapping it into the new memory.
+*@return EXIT_SUCCESS on success, EXIT_FAILURE if memory could not be allocated
+*@param queue the queue
+**/
+static int growQueue(CarQueue *queue)
+{
+  size_t newCapacity = (queue->capacity == 0) ? 64 : queue->capacity*2;
+  Data *newCars = malloc(sizeof(Data)*newCapacity);
+  if(newCars == NULL)
+  {
+    return EXIT_FAILURE;
+  }
+  for(size_t i = 0; i < queue->count; i++)
+  {
+    newCars[i] = *carAt(queue,i);
+  }
+  free(queue->cars);
+  queue->cars = newCars;
+  queue->first = 0;
+  queue->capacity = newCapacity;
+  return EXIT_SUCCESS;
+}
+
+/**Function to add a car to the back of a queue. Like insertSorted, a car goes in front of the cars with the same
+*time that were read before it, so the queue is in the same order the sorted list would keep.
+*@pre the car must not arrive before the car at the back of the queue
+*@return EXIT_SUCCESS on success, EXIT_FAILURE if memory could not be allocated
+*@param queue the queue of the car's direction
+*@param car the car to add
+**/
+static int pushCar(CarQueue *queue, Data *car)
+{
+  if(queue->count == queue->capacity && growQueue(queue) != EXIT_SUCCESS)
+  {
+    return EXIT_FAILURE;
+  }
+
+  //moving the run of cars with the same time back by one
+  size_t position = queue->count;
+  while(position > 0 && carAt(queue,position - 1)->timeOfArrival == car->timeOfArrival)
+  {
+    *carAt(queue,position) = *carAt(queue,position - 1);
+    position--;
+  }
+  *carAt(queue,position) = *car;
+  queue->count++;
+  return EXIT_SUCCESS;
+}
+
+/**Function to remove the car at the front of a queue.
+*@pre the queue must not be empty
+*@param queue the queue
+*@param car where the car is copied to
+**/
+static void popCar(CarQueue *queue, Data *car)
+{
+  *car = *carAt(queue,0);
+  queue->first = (queue->first + 1) % queue->capacity;
+  queue->count--;
+}
+
+/**Function to read the next car of the file into the queue of its direction.
+*@param stream the streaming run
+*@return 1 when a car was read, 0 at the end of the file
+**/
+static int readAhead(CarStream *stream)
+{
+  Data car;
+
+  while(readCar(stream->reader,&car))
+  {
+    //a car arriving before one already read can not be placed any more
+    if(stream->carsRead > 0 && car.timeOfArrival < stream->lastTimeRead)
+    {
+      fprintf(stderr,"%s:%lu: arrival time %.2f is before the car read ahead of it (%.2f), skipped since the input must be sorted\n"
+              ,stream->reader->fileName
+              ,(unsigned long)stream->reader->lineNumber
+              ,secondsOf(car.timeOfArrival)
+              ,secondsOf(stream->lastTimeRead));
+      stream->outOfOrderCars++;
+      continue;
+    }
+
+    //cars of a direction the junction does not have never reach the intersection
+    int approach = stream->config->approachOf[(unsigned char)car.travelDirection];
+    if(approach < 0)
+    {
+      continue;
+    }
+
+    if(pushCar(&stream->queues[approach],&car) != EXIT_SUCCESS)
+    {
+      fprintf(stderr,"not enough memory to hold the cars waiting at the intersection\n");
+      stream->endOfFile = 1;
+      return 0;
+    }
+    stream->lastTimeRead = car.timeOfArrival;
+    stream->carsRead++;
+    stream->carsBuffered++;
+    if(stream->carsBuffered > stream->peakCarsBuffered)
+    {
+      stream->peakCarsBuffered = stream->carsBuffered;
+    }
+    return 1;
+  }
+
+  stream->endOfFile = 1;
+  return 0;
+}
+
+/**Car source horizon of a stream, every car not read yet arrives at the time of the last car read or later. Once the
+*whole file is read every car is known, unless it is still growing.
+*@param state the CarStream
+*@return the time before which every car is known, INT64_MAX when every car is
+**/
+static SimTime streamHorizon(void *state)
+{
+  CarStream *stream = state;
+  if(stream->endOfFile && !stream->growing)
+  {
+    return INT64_MAX;
+  }
+  return (stream->carsRead == 0) ? INT64_MIN : stream->lastTimeRead;
+}
+
+/**Car source function for simulateStream. A direction without a car read yet is only read for up to the next time
+*in the file, it then has no car before the horizon yet and the engine asks again once it needs to know, so the
+*cars of the other directions are not all read in looking for one. Otherwise the stream reads ahead until every car
+*with the same time as the first car of the direction has been read, so ties come out in the same order as in the
+*sorted list.
+*@param state the CarStream
+*@param direction direction of the car wanted
+*@param car where the car is copied to
+*@return 1 when a car was copied, 0 when the direction has no more cars or none before the horizon yet
+**/
+static int nextCarFromStream(void *state, char direction, Data *car)
+{
+  CarStream *stream = state;
+  int index = stream->config->approachOf[(unsigned char)direction];
+  if(index < 0)
+  {
+    return 0;
+  }
+  CarQueue *queue = &stream->queues[index];
+  SimTime horizon = streamHorizon(stream);
+
+  while(queue->count == 0 && !stream->endOfFile && streamHorizon(stream) == horizon)
+  {
+    readAhead(stream);
+  }
+  if(queue->count == 0)
+  {
+    return 0;
+  }
+  while(!stream->endOfFile && stream->lastTimeRead <= carAt(queue,0)->timeOfArrival)
+  {
+    readAhead(stream);
+  }
+  if(stream->growing && stream->endOfFile && carAt(queue,0)->timeOfArrival >= stream->lastTimeRead)
+  {
+    return 0;
+  }
+
+  popCar(queue,car);
+  stream->carsBuffered--;
+  return 1;
+}
+
+/**Function to set up a streaming run over a reader, with nothing read yet.
+*@param stream the streaming run
+*@param reader the reader over the car file
+*@param config the junction
+**/
+static void openStream(CarStream *stream, CarReader *reader, IntersectionConfig *config)
+{
+  stream->reader = reader;
+  stream->config = config;
+  for(int i = 0; i < INTERSECTION_MAX_APPROACHES; i++)
+  {
+    stream->queues[i].cars = NULL;
+    stream->queues[i].first = 0;
+    stream->queues[i].count = 0;
+    stream->queues[i].capacity = 0;
+  }
+  stream->lastTimeRead = 0;
+  stream->endOfFile = 0;
+  stream->growing = 0;
+  stream->carsRead = 0;
+  stream->carsBuffered = 0;
+  stream->peakCarsBuffered = 0;
+  stream->outOfOrderCars = 0;
+}
+
+/**Function to send the cars of a streaming run through the intersection.
+*@param stream the streaming run
+*@param compare function comparing the timeOfArrival of two cars
+*@param output where the results are written
+*@param mode one of OUTPUT_CARS, OUTPUT_SUMMARY, OUTPUT_MACHINE
+*@return the time the last car leaves the intersection
+**/
+static SimTime runStream(CarStream *stream, int (*compare)(void *first,void *second), OutputBuffer *output, int mode)
+{
+  CarSource source;
+  source.nextCar = nextCarFromStream;
+  source.horizon = streamHorizon;
+  source.state = stream;
+  return simulateIntersection(&source,stream->config,compare,output,mode,NULL);
+}
+
+/**Function to free the queues of a streaming run.
+*@param stream the streaming run
+**/
+static void closeStream(CarStream *stream)
+{
+  for(int i = 0; i < INTERSECTION_MAX_APPROACHES; i++)
+  {
+    free(stream->queues[i].cars);
+    stream->queues[i].cars = NULL;
+  }
+}
+
+/**Function to write where a refresh has got to in its file and the cars it has read ahead, the write of its
+*CheckpointSection.
+*@param fp file being written
+*@param context the CarStream
+*@return EXIT_SUCCESS on success, EXIT_FAILURE if the file could not be written
+**/
+static int writeStreamSection(FILE *fp, void *context)
+{
+  CarStream *stream = context;
+  CarReader *reader = stream->reader;
+  StreamSection section;
+
+  memset(&section,0,sizeof(StreamSection));
+  memcpy(section.magic,STREAM_SECTION_MAGIC,8);
+  section.offset = (uint64_t)(reader->position - reader->start);
+  section.lineNumber = reader->lineNumber;
+  section.malformedLines = reader->malformedLines;
+  section.carsRead = stream->carsRead;
+  section.outOfOrderCars = stream->outOfOrderCars;
+  section.lastTimeRead = stream->lastTimeRead;
+  for(int i = 0; i < INTERSECTION_MAX_APPROACHES; i++)
+  {
+    section.queued[i] = stream->queues[i].count;
+  }
+  section.tailLength = (section.offset < STREAM_SECTION_TAIL) ? (uint32_t)section.offset : STREAM_SECTION_TAIL;
+  if(section.tailLength > 0)
+  {
+    memcpy(section.tail,reader->position - section.tailLength,section.tailLength);
+  }
+  if(fwrite(&section,sizeof(StreamSection),1,fp) != 1)
+  {
+    return EXIT_FAILURE;
+  }
+
+  for(int i = 0; i < INTERSECTION_MAX_APPROACHES; i++)
+  {
+    for(size_t j = 0; j < stream->queues[i].count; j++)
+    {
+      //copied field by field so the padding of the file is always 0
+      Data car;
+      memset(&car,0,sizeof(Data));
+      car.travelDirection = carAt(&stream->queues[i],j)->travelDirection;
+      car.turnDirection = carAt(&stream->queues[i],j)->turnDirection;
+      car.timeOfArrival = carAt(&stream->queues[i],j)->timeOfArrival;
+      if(fwrite(&car,sizeof(Data),1,fp) != 1)
+      {
+        return EXIT_FAILURE;
+      }
+    }
+  }
+  return EXIT_SUCCESS;
+}
+
+/**Function to carry on a refresh from where the last one got to in its file, the read of its CheckpointSection.
+*Only the last bytes before where it got to are compared with what was read then, reading the whole start of the
+*file again is what a refresh is there to save.
+*@param fp file being read
+*@param context the CarStream, with nothing read yet
+*@return EXIT_SUCCESS on success, EXIT_FAILURE if the section is damaged or the file is not the one read then
+**/
+static int readStreamSection(FILE *fp, void *context)
+{
+  CarStream *stream = context;
+  CarReader *reader = stream->reader;
+  StreamSection section;
+
+  if(fread(&section,sizeof(StreamSection),1,fp) != 1 || memcmp(section.magic,STREAM_SECTION_MAGIC,8) != 0
+     || section.tailLength > STREAM_SECTION_TAIL || section.tailLength > section.offset)
+  {
+    fprintf(stderr,"the state given is not one of a refresh of %s\n",reader->fileName);
+    return EXIT_FAILURE;
+  }
+  if(seekCarReader(reader,(size_t)section.offset,(size_t)section.lineNumber) != EXIT_SUCCESS
+     || (section.tailLength > 0 && memcmp(reader->position - section.tailLength,section.tail,section.tailLength) != 0))
+  {
+    fprintf(stderr,"%s has changed other than by lines added at its end since the state was saved\n",reader->fileName);
+    return EXIT_FAILURE;
+  }
+  reader->malformedLines = (size_t)section.malformedLines;
+  stream->carsRead = (size_t)section.carsRead;
+  stream->outOfOrderCars = (size_t)section.outOfOrderCars;
+  stream->lastTimeRead = section.lastTimeRead;
+
+  //the cars go back in the order they were saved, pushCar would put cars of the same time the other way round
+  for(int i = 0; i < INTERSECTION_MAX_APPROACHES; i++)
+  {
+    CarQueue *queue = &stream->queues[i];
+    for(uint64_t j = 0; j < section.queued[i]; j++)
+    {
+      if(queue->count == queue->capacity && growQueue(queue) != EXIT_SUCCESS)
+      {
+        fprintf(stderr,"not enough memory to hold the cars waiting at the intersection\n");
+        return EXIT_FAILURE;
+      }
+      if(fread(carAt(queue,queue->count),sizeof(Data),1,fp) != 1)
+      {
+        fprintf(stderr,"the state of the refresh of %s is cut short\n",reader->fileName);
+        return EXIT_FAILURE;
+      }
+      queue->count++;
+      stream->carsBuffered++;
+    }
+  }
+  stream->peakCarsBuffered = stream->carsBuffered;
+  return EXIT_SUCCESS;
+}
+
+/**Function to simulate a car file that is already sorted by time of arrival without loading it, the cars are
+*printed as soon as their times are known. The results are the same as for the whole file in a sorted list.
+*Cars that arrive before the car read ahead of them are reported with their line number and skipped.
+*@pre reader must be open on a file sorted by time of arrival
+*@param reader the reader over the car file
+*@param config the junction, NULL for the four way intersection
+*@param compare function comparing the timeOfArrival of two cars
+*@param output where the results are written
+*@param mode one of OUTPUT_CARS, OUTPUT_SUMMARY, OUTPUT_MACHINE
+*@param stream where the counters of the run are left, may be NULL
+*@return the time the last car leaves the intersection
+**/
+SimTime simulateStream(CarReader *reader, IntersectionConfig *config, int (*compare)(void *first,void *second), OutputBuffer *output, int mode, CarStream *stream)
+{
+  IntersectionConfig defaultConfig;
+  CarStream localStream;
+  SimTime timeCounter;
+
+  if(stream == NULL)
+  {
+    stream = &localStream;
+  }
+  if(config == NULL)
+  {
+    configureIntersection(&defaultConfig,NULL,NULL,1);
+    config = &defaultConfig;
+  }
+  openStream(stream,reader,config);
+  timeCounter = runStream(stream,compare,output,mode);
+  COUNT_PEAK(peakCarsHeld,(unsigned long long)stream->peakCarsBuffered);
+  closeStream(stream);
+  return timeCounter;
+}
+
+/**Function to simulate the cars appended to a car file since its last refresh, carrying on from the state saved in
+*stateFile by that refresh and saving the state again at the end, so a refresh only reads the new lines. The cars
+*printed by the refreshes one after another are the cars of simulateStream over the whole file, the ones that a
+*car appended later could still change wait for a later refresh, and the summary is that of the cars so far.
+*A refresh with final set takes the file as complete, sends every car through and leaves stateFile as it was.
+*@pre reader must be open on a file sorted by time of arrival, with the cars of the last refresh at its start
+*@param reader the reader over the car file
+*@param config the junction
+*@param compare function comparing the timeOfArrival of two cars
+*@param output where the results are written
+*@param mode one of OUTPUT_CARS, OUTPUT_SUMMARY, OUTPUT_MACHINE
+*@param stateFile where the state is kept between refreshes, the file is simulated from its start when it does not exist
+*@param final 1 when no more cars will be appended, 0 otherwise
+*@return EXIT_SUCCESS on success, EXIT_FAILURE if the state could not be read or saved, the reason is printed on stderr
+**/
+int refreshStream(CarReader *reader, IntersectionConfig *config, int (*compare)(void *first,void *second), OutputBuffer *output, int mode, const char *stateFile, int final)
+{
+  CarStream stream;
+  CheckpointSection section;
+  EngineState *state;
+  int result = EXIT_SUCCESS;
+
+  //a line still being written is read by the next refresh
+  if(!final)
+  {
+    dropPartialLine(reader);
+  }
+  openStream(&stream,reader,config);
+  stream.growing = !final;
+  section.write = writeStreamSection;
+  section.read = readStreamSection;
+  section.context = &stream;
+
+  //the first refresh has no state yet and starts from the first line
+  FILE *fp = fopen(stateFile,"rb");
+  if(fp == NULL)
+  {
+    state = initializeEngineState(config);
+    if(state == NULL)
+    {
+      fprintf(stderr,"not enough memory to start the simulation\n");
+    }
+  }
+  else
+  {
+    fclose(fp);
+    state = readCheckpoint(stateFile,config,mode,&section);
+  }
+  if(state == NULL)
+  {
+    closeStream(&stream);
+    return EXIT_FAILURE;
+  }
+
+  config->incremental = state;
+  runStream(&stream,compare,output,mode);
+  config->incremental = NULL;
+  COUNT_PEAK(peakCarsHeld,(unsigned long long)stream.peakCarsBuffered);
+  if(!final && writeCheckpoint(stateFile,config,mode,state,&section) != EXIT_SUCCESS)
+  {
+    fprintf(stderr,"could not save the state to %s\n",stateFile);
+    result = EXIT_FAILURE;
+  }
+  deleteEngineState(state);
+  closeStream(&stream);
+  return result;
+}
@@ -0,0 +1,336 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include "../include/ThreadPool.h"
+#include "../include/Counters.h"
+
+#ifndef _WIN32
+#include <unistd.h>
+#endif
+
+/**
+ *What a thread of the pool is started with.
+ **/
+typedef struct poolWorker{
+    ThreadPool *pool;
+    int index;
+} PoolWorker;
+
+/**Function to give the number of processors, the default number of threads.
+*@return number of processors online, at least 1
+**/
+int processorCount(void)
+{
+  long count = 1;
+#ifdef _WIN32
+  const char *variable = getenv("NUMBER_OF_PROCESSORS");
+  if(variable != NULL)
+  {
+    count = strtol(variable,NULL,10);
+  }
+#else
+  count = sysconf(_SC_NPROCESSORS_ONLN);
+#endif
+  return (count < 1) ? 1 : (int)count;
+}
+
+/**Function to add a task to the back of a deque.
+*@param deque the deque, its lock must be held
+*@param task the task
+*@return EXIT_SUCCESS on success, EXIT_FAILURE if memory could not be allocated
+**/
+static int pushTask(TaskDeque *deque, PoolTask task)
+{
+  //doubling the ring when it is full, unwrapping it into the new memory
+  if(deque->count == deque->capacity)
+  {
+    size_t newCapacity = (deque->capacity == 0) ? 64 : deque->capacity*2;
+    PoolTask *newTasks = malloc(sizeof(PoolTask)*newCapacity);
+    if(newTasks == NULL)
+    {
+      return EXIT_FAILURE;
+    }
+    for(size_t i = 0; i < deque->count; i++)
+    {
+      newTasks[i] = deque->tasks[(deque->first + i) % deque->capacity];
+    }
+    free(deque->tasks);
+    deque->tasks = newTasks;
+    deque->first = 0;
+    deque->capacity = newCapacity;
+  }
+  deque->tasks[(deque->first + deque->count) % deque->capacity] = task;
+  deque->count++;
+  return EXIT_SUCCESS;
+}
+
+/**Function for the owner of a deque to take its newest task.
+*@param deque the deque
+*@param task where the task is copied to
+*@return 1 when a task was taken, 0 when the deque is empty
+**/
+static int popNewestTask(TaskDeque *deque, PoolTask *task)
+{
+  int found = 0;
+  pthread_mutex_lock(&deque->lock);
+  if(deque->count > 0)
+  {
+    deque->count--;
+    *task = deque->tasks[(deque->first + deque->count) % deque->capacity];
+    found = 1;
+  }
+  pthread_mutex_unlock(&deque->lock);
+  return found;
+}
+
+/**Function for another thread to steal the oldest task of a deque.
+*@param deque the deque
+*@param task where the task is copied to
+*@return 1 when a task was taken, 0 when the deque is empty
+**/
+static int stealOldestTask(TaskDeque *deque, PoolTask *task)
+{
+  int found = 0;
+  pthread_mutex_lock(&deque->lock);
+  if(deque->count > 0)
+  {
+    *task = deque->tasks[deque->first];
+    deque->first = (deque->first + 1) % deque->capacity;
+    deque->count--;
+    found = 1;
+  }
+  pthread_mutex_unlock(&deque->lock);
+  return found;
+}
+
+/**Function to find the next task for a thread, its own deque first then the others starting with its neighbour.
+*@param pool the pool
+*@param index the thread looking for work
+*@param task where the task is copied to
+*@return 1 when a task was found, 0 when every deque is empty
+**/
+static int findTask(ThreadPool *pool, int index, PoolTask *task)
+{
+  if(popNewestTask(&pool->deques[index],task))
+  {
+    return 1;
+  }
+  for(int i = 1; i < pool->dequeCount; i++)
+  {
+    if(stealOldestTask(&pool->deques[(index + i) % pool->dequeCount],task))
+    {
+      pthread_mutex_lock(&pool->lock);
+      pool->steals++;
+      pthread_mutex_unlock(&pool->lock);
+      return 1;
+    }
+  }
+  return 0;
+}
+
+/**Function run by each thread of the pool, runs tasks until the pool is stopped and nothing is left.
+*@param argument the PoolWorker of the thread
+**/
+static void *runWorker(void *argument)
+{
+  PoolWorker *worker = argument;
+  ThreadPool *pool = worker->pool;
+  PoolTask task;
+
+  while(1)
+  {
+    if(findTask(pool,worker->index,&task))
+    {
+      pthread_mutex_lock(&pool->lock);
+      pool->queued--;
+      pthread_mutex_unlock(&pool->lock);
+
+      task.run(task.argument);
+
+      pthread_mutex_lock(&pool->lock);
+      pool->pending--;
+      if(pool->pending == 0)
+      {
+        pthread_cond_broadcast(&pool->allDone);
+      }
+      pthread_mutex_unlock(&pool->lock);
+      continue;
+    }
+
+    //sleeping until a task is handed in, a task queued in another deque wakes this thread to steal it
+    pthread_mutex_lock(&pool->lock);
+    while(pool->queued == 0 && !pool->stopping)
+    {
+      pthread_cond_wait(&pool->workAvailable,&pool->lock);
+    }
+    if(pool->queued == 0 && pool->stopping)
+    {
+      pthread_mutex_unlock(&pool->lock);
+      break;
+    }
+    pthread_mutex_unlock(&pool->lock);
+  }
+
+  mergeThreadCounters();
+  free(worker);
+  return NULL;
+}
+
+/**Function to start a pool of threads.
+*@return pointer to the pool, NULL if the threads could not be started
+*@param threadCount number of threads, 0 for processorCount()
+**/
+ThreadPool *initializeThreadPool(int threadCount)
+{
+  if(threadCount <= 0)
+  {
+    threadCount = processorCount();
+  }
+
+  ThreadPool *newPool = malloc(sizeof(ThreadPool)*1);
+  if(newPool == NULL)
+  {
+    return NULL;
+  }
+  newPool->threads = malloc(sizeof(pthread_t)*threadCount);
+  newPool->deques = malloc(sizeof(TaskDeque)*threadCount);
+  if(newPool->threads == NULL || newPool->deques == NULL)
+  {
+    free(newPool->threads);
+    free(newPool->deques);
+    free(newPool);
+    return NULL;
+  }
+
+  newPool->threadCount = 0;
+  newPool->dequeCount = threadCount;
+  newPool->queued = 0;
+  newPool->pending = 0;
+  newPool->nextDeque = 0;
+  newPool->steals = 0;
+  newPool->stopping = 0;
+  pthread_mutex_init(&newPool->lock,NULL);
+  pthread_cond_init(&newPool->workAvailable,NULL);
+  pthread_cond_init(&newPool->allDone,NULL);
+  for(int i = 0; i < threadCount; i++)
+  {
+    newPool->deques[i].tasks = NULL;
+    newPool->deques[i].first = 0;
+    newPool->deques[i].count = 0;
+    newPool->deques[i].capacity = 0;
+    pthread_mutex_init(&newPool->deques[i].lock,NULL);
+  }
+
+  //the deques all exist before any thread starts looking through them, a deque whose thread did not start is
+  //emptied by the others stealing from it
+  for(int i = 0; i < threadCount; i++)
+  {
+    PoolWorker *worker = malloc(sizeof(PoolWorker)*1);
+    if(worker == NULL)
+    {
+      break;
+    }
+    worker->pool = newPool;
+    worker->index = i;
+    if(pthread_create(&newPool->threads[i],NULL,runWorker,worker) != 0)
+    {
+      free(worker);
+      break;
+    }
+    newPool->threadCount++;
+  }
+
+  if(newPool->threadCount == 0)
+  {
+    deleteThreadPool(newPool);
+    return NULL;
+  }
+  return newPool;
+}
+
+/**Function to hand a task to the pool, tasks are spread over the deques of the threads in turn.
+*@pre pool must exist
+*@return EXIT_SUCCESS on success, EXIT_FAILURE if memory could not be allocated
+*@param pool the pool
+*@param run function to run
+*@param argument passed to run
+**/
+int submitTask(ThreadPool *pool, void (*run)(void *argument), void *argument)
+{
+  PoolTask task;
+  task.run = run;
+  task.argument = argument;
+
+  pthread_mutex_lock(&pool->lock);
+  TaskDeque *deque = &pool->deques[pool->nextDeque];
+  pool->nextDeque = (pool->nextDeque + 1) % pool->dequeCount;
+  pool->pending++;
+  pool->queued++;
+  pthread_mutex_unlock(&pool->lock);
+
+  pthread_mutex_lock(&deque->lock);
+  int result = pushTask(deque,task);
+  pthread_mutex_unlock(&deque->lock);
+
+  pthread_mutex_lock(&pool->lock);
+  if(result != EXIT_SUCCESS)
+  {
+    pool->pending--;
+    pool->queued--;
+  }
+  else
+  {
+    pthread_cond_broadcast(&pool->workAvailable);
+  }
+  pthread_mutex_unlock(&pool->lock);
+  return result;
+}
+
+/**Function to wait until every task handed to the pool has finished.
+*@param pool the pool
+**/
+void waitForTasks(ThreadPool *pool)
+{
+  if(pool == NULL)
+  {
+    return;
+  }
+  pthread_mutex_lock(&pool->lock);
+  while(pool->pending > 0)
+  {
+    pthread_cond_wait(&pool->allDone,&pool->lock);
+  }
+  pthread_mutex_unlock(&pool->lock);
+}
+
+/**Function to finish the tasks left, stop the threads and free the pool.
+*@param pool the pool to be deleted
+**/
+void deleteThreadPool(ThreadPool *pool)
+{
+  if(pool == NULL)
+  {
+    return;
+  }
+
+  waitForTasks(pool);
+  pthread_mutex_lock(&pool->lock);
+  pool->stopping = 1;
+  pthread_cond_broadcast(&pool->workAvailable);
+  pthread_mutex_unlock(&pool->lock);
+  for(int i = 0; i < pool->threadCount; i++)
+  {
+    pthread_join(pool->threads[i],NULL);
+  }
+
+  for(int i = 0; i < pool->dequeCount; i++)
+  {
+    free(pool->deques[i].tasks);
+    pthread_mutex_destroy(&pool->deques[i].lock);
+  }
+  pthread_cond_destroy(&pool->allDone);
+  pthread_cond_destroy(&pool->workAvailable);
+  pthread_mutex_destroy(&pool->lock);
+  free(pool->threads);
+  free(pool->deques);
+  free(pool);
+}
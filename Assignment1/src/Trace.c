@@ -0,0 +1,447 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../include/Trace.h"
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+/**
+ *Cursor state used to hand out the cars of a trace one direction at a time. Each direction keeps its own position
+ *and skips over the cars of the other directions, so every car is looked at once per direction.
+ **/
+typedef struct traceCursor{
+    Trace *trace;
+    IntersectionConfig *config;
+    size_t *order;
+    size_t position[INTERSECTION_MAX_APPROACHES];
+} TraceCursor;
+
+/**Function to round a file offset up to the next multiple of 8.
+*@param offset the offset to round
+**/
+static uint64_t alignOffset(uint64_t offset)
+{
+  return (offset + 7) & ~(uint64_t)7;
+}
+
+/**Function to write a run of bytes, padding the file up to offset first.
+*@return EXIT_SUCCESS on success, EXIT_FAILURE if the file could not be written
+*@param fp file being written
+*@param written bytes written to the file so far, updated
+*@param offset where the bytes have to start
+*@param bytes what to write
+*@param length number of bytes
+**/
+static int writeAt(FILE *fp, uint64_t *written, uint64_t offset, const void *bytes, size_t length)
+{
+  while(*written < offset)
+  {
+    if(fputc(0,fp) == EOF)
+    {
+      return EXIT_FAILURE;
+    }
+    (*written)++;
+  }
+  if(length > 0 && fwrite(bytes,1,length,fp) != length)
+  {
+    return EXIT_FAILURE;
+  }
+  *written = *written + length;
+  return EXIT_SUCCESS;
+}
+
+/**Function to write every car of a sorted list to a trace file, the file is flagged as sorted.
+*@pre list must be sorted by time of arrival and hold Data
+*@return EXIT_SUCCESS on success, EXIT_FAILURE if the file could not be written
+*@param fileName path of the trace file to create
+*@param list the sorted list of cars
+**/
+int writeTrace(const char *fileName, List *list)
+{
+  if(fileName == NULL || list == NULL)
+  {
+    return EXIT_FAILURE;
+  }
+
+  //counting the cars so the column offsets are known up front
+  size_t count = 0;
+  Node *tempNode;
+  for(tempNode = list->head; tempNode != NULL; tempNode = tempNode->next)
+  {
+    count++;
+  }
+
+  char *travelDirection = malloc(count + 1);
+  char *turnDirection = malloc(count + 1);
+  SimTime *timeOfArrival = malloc(sizeof(SimTime)*(count + 1));
+  if(travelDirection == NULL || turnDirection == NULL || timeOfArrival == NULL)
+  {
+    free(travelDirection);
+    free(turnDirection);
+    free(timeOfArrival);
+    return EXIT_FAILURE;
+  }
+
+  //splitting the cars into their columns
+  size_t i = 0;
+  for(tempNode = list->head; tempNode != NULL; tempNode = tempNode->next)
+  {
+    Data *tempData = (Data *)tempNode->data;
+    travelDirection[i] = tempData->travelDirection;
+    turnDirection[i] = tempData->turnDirection;
+    timeOfArrival[i] = tempData->timeOfArrival;
+    i++;
+  }
+
+  TraceHeader header;
+  memset(&header,0,sizeof(TraceHeader));
+  memcpy(header.magic,TRACE_MAGIC,8);
+  header.version = TRACE_VERSION;
+  header.byteOrder = TRACE_BYTE_ORDER;
+  header.count = count;
+  header.flags = TRACE_FLAG_SORTED;
+  header.timeUnits = TIME_UNITS_PER_SECOND;
+  header.travelOffset = sizeof(TraceHeader);
+  header.turnOffset = header.travelOffset + count;
+  header.timeOffset = alignOffset(header.turnOffset + count);
+
+  int result = EXIT_FAILURE;
+  uint64_t written = 0;
+  FILE *fp = fopen(fileName,"wb");
+  if(fp != NULL)
+  {
+    if(writeAt(fp,&written,0,&header,sizeof(TraceHeader)) == EXIT_SUCCESS
+       && writeAt(fp,&written,header.travelOffset,travelDirection,count) == EXIT_SUCCESS
+       && writeAt(fp,&written,header.turnOffset,turnDirection,count) == EXIT_SUCCESS
+       && writeAt(fp,&written,header.timeOffset,timeOfArrival,sizeof(SimTime)*count) == EXIT_SUCCESS)
+    {
+      result = EXIT_SUCCESS;
+    }
+    if(fclose(fp) != 0)
+    {
+      result = EXIT_FAILURE;
+    }
+  }
+
+  free(travelDirection);
+  free(turnDirection);
+  free(timeOfArrival);
+  return result;
+}
+
+/**Function to check that a column of a trace lies inside the file. Nothing is added or multiplied before it is
+*known not to overflow, so a damaged header can not wrap round and pass.
+*@param offset where the column starts
+*@param count number of elements of the column
+*@param elementSize bytes of an element
+*@param length bytes of the file
+*@return 1 when the column fits, 0 otherwise
+**/
+static int columnFits(uint64_t offset, uint64_t count, uint64_t elementSize, uint64_t length)
+{
+  return offset <= length && count <= (length - offset)/elementSize;
+}
+
+/**Function to map a trace file into memory and check its header.
+*@return pointer to the trace, NULL if the file could not be read or is not a valid trace (the reason is on stderr)
+*@param fileName path of the trace file
+**/
+Trace *openTrace(const char *fileName)
+{
+  if(fileName == NULL)
+  {
+    return NULL;
+  }
+
+  Trace *newTrace = malloc(sizeof(Trace)*1);
+  if(newTrace == NULL)
+  {
+    return NULL;
+  }
+  newTrace->mapping = NULL;
+  newTrace->length = 0;
+  newTrace->mapped = 0;
+
+#ifndef _WIN32
+  int fileDescriptor = open(fileName,O_RDONLY);
+  struct stat fileInformation;
+  if(fileDescriptor >= 0)
+  {
+    if(fstat(fileDescriptor,&fileInformation) == 0 && fileInformation.st_size > 0)
+    {
+      void *mapping = mmap(NULL,(size_t)fileInformation.st_size,PROT_READ,MAP_PRIVATE,fileDescriptor,0);
+      if(mapping != MAP_FAILED)
+      {
+        madvise(mapping,(size_t)fileInformation.st_size,MADV_SEQUENTIAL);
+        newTrace->mapping = mapping;
+        newTrace->length = (size_t)fileInformation.st_size;
+        newTrace->mapped = 1;
+      }
+    }
+    close(fileDescriptor);
+  }
+#endif
+
+  //reading the file into memory when it could not be mapped
+  if(!newTrace->mapped)
+  {
+    FILE *fp = fopen(fileName,"rb");
+    long fileLength;
+    if(fp == NULL)
+    {
+      free(newTrace);
+      return NULL;
+    }
+    //an input that can not seek, like a pipe, has no length to read
+    if(fseek(fp,0,SEEK_END) != 0 || (fileLength = ftell(fp)) < 0 || fseek(fp,0,SEEK_SET) != 0)
+    {
+      fclose(fp);
+      free(newTrace);
+      return NULL;
+    }
+    if(fileLength > 0)
+    {
+      newTrace->mapping = malloc((size_t)fileLength);
+      if(newTrace->mapping != NULL)
+      {
+        newTrace->length = fread(newTrace->mapping,1,(size_t)fileLength,fp);
+      }
+    }
+    fclose(fp);
+  }
+
+  //checking the header before trusting any offsets
+  const char *problem = NULL;
+  if(newTrace->length < sizeof(TraceHeader))
+  {
+    problem = "file is too short to be a trace";
+  }
+  else
+  {
+    memcpy(&newTrace->header,newTrace->mapping,sizeof(TraceHeader));
+    TraceHeader *header = &newTrace->header;
+    if(memcmp(header->magic,TRACE_MAGIC,8) != 0)
+    {
+      problem = "not a car trace file";
+    }
+    else if(header->byteOrder != TRACE_BYTE_ORDER)
+    {
+      problem = "trace was written on a machine with a different byte order";
+    }
+    else if(header->version != TRACE_VERSION)
+    {
+      problem = "unsupported trace version";
+    }
+    else if(header->timeUnits != TIME_UNITS_PER_SECOND)
+    {
+      problem = "trace was written with a different time base, convert the car file again";
+    }
+    else if(header->timeOffset % 8 != 0
+            || !columnFits(header->travelOffset,header->count,sizeof(char),newTrace->length)
+            || !columnFits(header->turnOffset,header->count,sizeof(char),newTrace->length)
+            || !columnFits(header->timeOffset,header->count,sizeof(SimTime),newTrace->length))
+    {
+      problem = "trace columns do not fit in the file";
+    }
+  }
+  if(problem != NULL)
+  {
+    fprintf(stderr,"%s: %s\n",fileName,problem);
+    closeTrace(newTrace);
+    return NULL;
+  }
+
+  //pointing the columns into the mapping
+  newTrace->count = (size_t)newTrace->header.count;
+  newTrace->travelDirection = (const char *)newTrace->mapping + newTrace->header.travelOffset;
+  newTrace->turnDirection = (const char *)newTrace->mapping + newTrace->header.turnOffset;
+  newTrace->timeOfArrival = (const SimTime *)((const char *)newTrace->mapping + newTrace->header.timeOffset);
+  return newTrace;
+}
+
+/**Function to put the cars of an unsorted trace in the order the sorted list would keep them. Like insertSorted,
+*a car goes in front of the cars with the same time that come before it in the file. This is a merge sort of the
+*car positions, so the trace itself is never copied.
+*@param trace the trace to be ordered
+*@return positions of the cars in sorted order, NULL if memory could not be allocated
+**/
+static size_t *sortTrace(Trace *trace)
+{
+  size_t count = trace->count;
+  size_t *order = malloc(sizeof(size_t)*(count + 1));
+  size_t *buffer = malloc(sizeof(size_t)*(count + 1));
+  size_t *from = order;
+  size_t *to = buffer;
+  size_t *swap;
+  size_t width;
+  size_t left;
+  const SimTime *time = trace->timeOfArrival;
+
+  if(order == NULL || buffer == NULL)
+  {
+    free(order);
+    free(buffer);
+    return NULL;
+  }
+
+  //starting from the reverse of the file order makes equal times come out latest first
+  for(size_t i = 0; i < count; i++)
+  {
+    order[i] = count - 1 - i;
+  }
+
+  for(width = 1; width < count; width = width*2)
+  {
+    for(left = 0; left < count; left = left + 2*width)
+    {
+      size_t middle = (left + width < count) ? left + width : count;
+      size_t right = (left + 2*width < count) ? left + 2*width : count;
+      size_t i = left;
+      size_t j = middle;
+      size_t k = left;
+
+      while(i < middle && j < right)
+      {
+        if(time[from[j]] < time[from[i]])
+        {
+          to[k++] = from[j++];
+        }
+        else
+        {
+          to[k++] = from[i++];
+        }
+      }
+      while(i < middle)
+      {
+        to[k++] = from[i++];
+      }
+      while(j < right)
+      {
+        to[k++] = from[j++];
+      }
+    }
+    swap = from;
+    from = to;
+    to = swap;
+  }
+
+  free(to);
+  return from;
+}
+
+/**Car source function for simulateTrace, moves the cursor of a direction to its next car in the columns.
+*@param state the TraceCursor
+*@param direction direction of the car wanted
+*@param car where the car is copied to
+*@return 1 when a car was copied, 0 when the direction has no more cars
+**/
+static int nextCarFromTrace(void *state, char direction, Data *car)
+{
+  TraceCursor *cursor = state;
+  Trace *trace = cursor->trace;
+  int index = cursor->config->approachOf[(unsigned char)direction];
+  if(index < 0)
+  {
+    return 0;
+  }
+
+  size_t position = cursor->position[index];
+  while(position < trace->count)
+  {
+    size_t carIndex = (cursor->order == NULL) ? position : cursor->order[position];
+    position++;
+    if(trace->travelDirection[carIndex] == direction)
+    {
+      car->travelDirection = direction;
+      car->turnDirection = trace->turnDirection[carIndex];
+      car->timeOfArrival = trace->timeOfArrival[carIndex];
+      cursor->position[index] = position;
+      return 1;
+    }
+  }
+  cursor->position[index] = position;
+  return 0;
+}
+
+/**Function to run the intersection straight from the columns of a trace, nothing is parsed or allocated per car.
+*@pre trace must exist
+*@param trace the mapped trace
+*@param config the junction, NULL for the four way intersection
+*@param compare function comparing the timeOfArrival of two cars
+*@param output where the results are written
+*@param mode one of OUTPUT_CARS, OUTPUT_SUMMARY, OUTPUT_MACHINE
+*@param stats where the counts and waits of the run are left, may be NULL
+*@return the time the last car leaves the intersection
+**/
+SimTime simulateTrace(Trace *trace, IntersectionConfig *config, int (*compare)(void *first,void *second), OutputBuffer *output, int mode, IntersectionStats *stats)
+{
+  IntersectionConfig defaultConfig;
+  TraceCursor cursor;
+  CarSource source;
+  SimTime timeCounter;
+
+  if(trace == NULL)
+  {
+    return 0;
+  }
+
+  if(config == NULL)
+  {
+    configureIntersection(&defaultConfig,NULL,NULL,1);
+    config = &defaultConfig;
+  }
+
+  cursor.trace = trace;
+  cursor.config = config;
+  cursor.order = NULL;
+  for(int i = 0; i < INTERSECTION_MAX_APPROACHES; i++)
+  {
+    cursor.position[i] = 0;
+  }
+
+  //traces written by other tools may not be sorted yet
+  if(!(trace->header.flags & TRACE_FLAG_SORTED))
+  {
+    cursor.order = sortTrace(trace);
+    if(cursor.order == NULL)
+    {
+      fprintf(stderr,"not enough memory to sort the trace\n");
+      return 0;
+    }
+  }
+
+  source.nextCar = nextCarFromTrace;
+  source.horizon = NULL;
+  source.state = &cursor;
+  timeCounter = simulateIntersection(&source,config,compare,output,mode,stats);
+
+  free(cursor.order);
+  return timeCounter;
+}
+
+/**Function to unmap the trace.
+*@param trace the trace to be closed
+**/
+void closeTrace(Trace *trace)
+{
+  if(trace == NULL)
+  {
+    return;
+  }
+
+#ifndef _WIN32
+  if(trace->mapped)
+  {
+    munmap(trace->mapping,trace->length);
+    free(trace);
+    return;
+  }
+#endif
+  free(trace->mapping);
+  free(trace);
+}
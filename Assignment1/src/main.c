@@ -1,44 +1,580 @@
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include "../include/main.h"
 #include "../include/Queue.h"
+#include "../include/Arena.h"
+#include "../include/Parser.h"
+#include "../include/Trace.h"
+#include "../include/Stream.h"
+#include "../include/Intersection.h"
+#include "../include/Checkpoint.h"
+#include "../include/Network.h"
+#include "../include/Batch.h"
+#include "../include/Generator.h"
+#include "../include/MonteCarlo.h"
+#include "../include/Counters.h"
+
+/**Function to print the --stats summary as the program exits, whichever way it returns.
+**/
+static void printStatsAtExit(void)
+{
+  printCounters(stderr);
+}
+
+/**Function to run the command of a single input, the ones that go through the intersection in one run and so can
+*save checkpoints and be resumed.
+*@param command NULL for a car data file, --binary or --stream
+*@param fileName the input
+*@param config the junction
+*@param mode one of OUTPUT_CARS, OUTPUT_SUMMARY, OUTPUT_MACHINE
+*@return exit status for main
+**/
+static int runSingleInput(const char *command, const char *fileName, IntersectionConfig *config, int mode)
+{
+  if(command == NULL)
+  {
+    return runCarFile(fileName,config,mode);
+  }
+  if(strcmp(command,"--binary") == 0)
+  {
+    return runTraceFile(fileName,config,mode);
+  }
+  return runStreamFile(fileName,config,mode);
+}
 
 int main(int argc, char *argv[])
 {
-  char travelDirection;  //travel direction, expecting one of 'N','S','E','W'
-  char turnDirection;    //turn djrection, expecting one of 'F','R','L'
-  float timeOfArrival;   //time of arrival at the intersection in seconds
-  FILE *fp;              //pointer to input data file containing car data
+  int mode = OUTPUT_CARS;     //how much of the simulation is printed
+  const char *command = NULL; //one of --binary, --convert, --stream, NULL to simulate a car data file
+  const char *files[2];       //file arguments of the command
+  int fileCount = 0;
+  const char *approaches = NULL;  //letters of the approaches going clockwise, NULL for N, E, S, W
+  const char *priority = NULL;    //approaches from the highest right-of-way to the lowest, NULL for clockwise order
+  int yieldToRight = 1;           //0 when ties go by priority only
+  int shareBox = 0;               //1 when cars whose movements do not conflict go through together
+  int percentiles = 0;            //1 to print the percentiles of the waits with the summary
+  IntersectionConfig config;      //the junction being simulated
+  int threadCount = 0;            //threads of a batch, 0 for one per processor
+  const char *rates = NULL;       //cars an hour of each generated approach, NULL for the default
+  const char *profile = NULL;     //24 hourly factors of the generated rates, NULL for the same all day
+  const char *turns = NULL;       //weights of forward, right and left turns, NULL for the default
+  const char *duration = NULL;    //seconds of generated cars, NULL for the default
+  const char *seed = NULL;        //seed of the generator, NULL for the default
+  size_t replicates = 0;          //generated runs of --replicates
+  GeneratorConfig settings;       //what generated cars look like
+  const char *checkpointFile = NULL;  //where the state of the run is saved, NULL for no checkpoints
+  const char *checkpointEvery = NULL; //cars between checkpoints, NULL for the default
+  const char *resumeFile = NULL;      //checkpoint the run carries on from, NULL to start from the first car
+  const char *stateFile = NULL;       //state kept between refreshes of a growing file, NULL to read all of it
+  int final = 0;                      //1 when a growing file is complete
+  const char *window = NULL;          //seconds of the windows printed as they close, NULL for none
+
+  for(int i = 1; i < argc; i++)
+  {
+    if(strcmp(argv[i],"--summary") == 0)
+    {
+      mode = OUTPUT_SUMMARY;
+    }
+    else if(strcmp(argv[i],"--machine") == 0)
+    {
+      mode = OUTPUT_MACHINE;
+    }
+    else if(strcmp(argv[i],"--approaches") == 0 && i + 1 < argc)
+    {
+      approaches = argv[++i];
+    }
+    else if(strcmp(argv[i],"--priority") == 0 && i + 1 < argc)
+    {
+      priority = argv[++i];
+    }
+    else if(strcmp(argv[i],"--threads") == 0 && i + 1 < argc)
+    {
+      threadCount = atoi(argv[++i]);
+    }
+    else if(strcmp(argv[i],"--rates") == 0 && i + 1 < argc)
+    {
+      rates = argv[++i];
+    }
+    else if(strcmp(argv[i],"--profile") == 0 && i + 1 < argc)
+    {
+      profile = argv[++i];
+    }
+    else if(strcmp(argv[i],"--turns") == 0 && i + 1 < argc)
+    {
+      turns = argv[++i];
+    }
+    else if(strcmp(argv[i],"--duration") == 0 && i + 1 < argc)
+    {
+      duration = argv[++i];
+    }
+    else if(strcmp(argv[i],"--seed") == 0 && i + 1 < argc)
+    {
+      seed = argv[++i];
+    }
+    else if(strcmp(argv[i],"--replicates") == 0 && i + 1 < argc)
+    {
+      command = argv[i];
+      replicates = strtoul(argv[++i],NULL,10);
+    }
+    else if(strcmp(argv[i],"--checkpoint") == 0 && i + 1 < argc)
+    {
+      checkpointFile = argv[++i];
+    }
+    else if(strcmp(argv[i],"--checkpoint-every") == 0 && i + 1 < argc)
+    {
+      checkpointEvery = argv[++i];
+    }
+    else if(strcmp(argv[i],"--resume") == 0 && i + 1 < argc)
+    {
+      resumeFile = argv[++i];
+    }
+    else if(strcmp(argv[i],"--incremental") == 0 && i + 1 < argc)
+    {
+      stateFile = argv[++i];
+    }
+    else if(strcmp(argv[i],"--window") == 0 && i + 1 < argc)
+    {
+      window = argv[++i];
+    }
+    else if(strcmp(argv[i],"--final") == 0)
+    {
+      final = 1;
+    }
+    else if(strcmp(argv[i],"--rank-only") == 0)
+    {
+      yieldToRight = 0;
+    }
+    else if(strcmp(argv[i],"--concurrent") == 0)
+    {
+      shareBox = 1;
+    }
+    else if(strcmp(argv[i],"--percentiles") == 0)
+    {
+      percentiles = 1;
+    }
+    else if(strcmp(argv[i],"--stats") == 0)
+    {
+      //turned on before any thread starts, the summary goes to stderr so the results are unchanged
+      enableCounters();
+      atexit(printStatsAtExit);
+    }
+    else if(strcmp(argv[i],"--binary") == 0 || strcmp(argv[i],"--convert") == 0 || strcmp(argv[i],"--stream") == 0 || strcmp(argv[i],"--network") == 0 || strcmp(argv[i],"--batch") == 0 || strcmp(argv[i],"--generate") == 0)
+    {
+      command = argv[i];
+    }
+    else if(argv[i][0] != '-' && fileCount < 2)
+    {
+      files[fileCount++] = argv[i];
+    }
+    else
+    {
+      fileCount = -1;
+      break;
+    }
+  }
+
+  if(fileCount >= 0 && configureIntersection(&config,approaches,priority,yieldToRight) != EXIT_SUCCESS)
+  {
+    fprintf(stderr,"--approaches needs 1 to %d different letters and --priority the same letters in order of right-of-way\n",INTERSECTION_MAX_APPROACHES);
+    return 1;
+  }
+  config.shareBox = shareBox;
+  config.percentiles = percentiles;
+  if(window != NULL)
+  {
+    const char *end = window + strlen(window);
+    if(parseTime(window,end,&config.window) != end || config.window <= 0)
+    {
+      fprintf(stderr,"--window needs the seconds of each window, more than 0\n");
+      return 1;
+    }
+  }
+
+  //the generator is set up the same way for --generate and --replicates, from the defaults and what was given
+  defaultGeneratorConfig(&settings);
+  if(rates != NULL && parseNumberList(rates,settings.ratePerHour,config.approaches) != EXIT_SUCCESS)
+  {
+    fprintf(stderr,"--rates needs %d numbers separated by commas, the cars an hour of each approach\n",config.approaches);
+    return 1;
+  }
+  if(profile != NULL)
+  {
+    double busiest = 0.0;
+    int valid = (parseNumberList(profile,settings.profile,GENERATOR_HOURS) == EXIT_SUCCESS);
+    for(int i = 0; valid && i < GENERATOR_HOURS; i++)
+    {
+      busiest = (settings.profile[i] > busiest) ? settings.profile[i] : busiest;
+    }
+    if(!valid || busiest <= 0.0)
+    {
+      fprintf(stderr,"--profile needs %d numbers separated by commas, the factor of each hour of the day, not all 0\n",GENERATOR_HOURS);
+      return 1;
+    }
+  }
+  if(turns != NULL && (parseNumberList(turns,settings.turnWeights,3) != EXIT_SUCCESS || settings.turnWeights[0] + settings.turnWeights[1] + settings.turnWeights[2] <= 0.0))
+  {
+    fprintf(stderr,"--turns needs 3 weights separated by commas, forward, right and left, not all 0\n");
+    return 1;
+  }
+  if(duration != NULL && parseNumberList(duration,&settings.duration,1) != EXIT_SUCCESS)
+  {
+    fprintf(stderr,"--duration needs the seconds of cars to generate\n");
+    return 1;
+  }
+  if(seed != NULL)
+  {
+    settings.seed = strtoull(seed,NULL,10);
+  }
+
+  //only a single input goes through one run of the intersection, the other commands have nothing to checkpoint
+  int single = (fileCount == 1 && (command == NULL || strcmp(command,"--binary") == 0 || strcmp(command,"--stream") == 0));
+  if(!single && (checkpointFile != NULL || checkpointEvery != NULL || resumeFile != NULL))
+  {
+    fprintf(stderr,"--checkpoint, --checkpoint-every and --resume only go with a car data file, --binary or --stream\n");
+    return 1;
+  }
+  if(checkpointEvery != NULL)
+  {
+    config.checkpointEvery = strtoull(checkpointEvery,NULL,10);
+    if(config.checkpointEvery == 0)
+    {
+      fprintf(stderr,"--checkpoint-every needs the number of cars between checkpoints, more than 0\n");
+      return 1;
+    }
+  }
+  config.checkpointFile = checkpointFile;
+
+  //the open windows are not part of a saved state, so a run that carries on from one could not finish them
+  if(config.window > 0 && (checkpointFile != NULL || resumeFile != NULL || stateFile != NULL))
+  {
+    fprintf(stderr,"--window does not go with --checkpoint, --resume or --incremental\n");
+    return 1;
+  }
+
+  //a refresh carries on from a state of its own, a checkpoint has nothing to add to it
+  if(stateFile != NULL || final)
+  {
+    if(stateFile == NULL || command == NULL || strcmp(command,"--stream") != 0 || fileCount != 1 || checkpointFile != NULL || resumeFile != NULL)
+    {
+      fprintf(stderr,"--incremental <state file> and --final only go with --stream, without --checkpoint or --resume\n");
+      return 1;
+    }
+    return runIncrementalFile(files[0],&config,mode,stateFile,final);
+  }
+
+  if(single)
+  {
+    if(resumeFile != NULL)
+    {
+      config.resume = readCheckpoint(resumeFile,&config,mode,NULL);
+      if(config.resume == NULL)
+      {
+        return 1;
+      }
+      //the output carries on from the checkpoint, what the interrupted run wrote after it has to be cut off
+      fprintf(stderr,"resuming after the first %llu bytes of the output\n",(unsigned long long)config.resume->outputBytes);
+    }
+    int result = runSingleInput(command,files[0],&config,mode);
+    if(config.resume != NULL)
+    {
+      if(config.resume->failed)
+      {
+        result = 1;
+      }
+      deleteEngineState(config.resume);
+    }
+    return result;
+  }
+  if(command != NULL && strcmp(command,"--convert") == 0 && fileCount == 2)
+  {
+    return convertCarFile(files[0],files[1],&config);
+  }
+  if(command != NULL && strcmp(command,"--batch") == 0 && fileCount == 1)
+  {
+    return runBatchPath(files[0],&config,threadCount,mode);
+  }
+  if(command != NULL && strcmp(command,"--network") == 0 && fileCount == 2)
+  {
+    return runNetworkFile(files[0],files[1],&config,mode);
+  }
+  if(command != NULL && strcmp(command,"--generate") == 0 && fileCount == 1)
+  {
+    return generateCarFile(files[0],&settings,&config);
+  }
+  if(command != NULL && strcmp(command,"--replicates") == 0 && fileCount == 0 && replicates > 0)
+  {
+    return runMonteCarlo(&settings,&config,replicates,threadCount,mode);
+  }
+
+  fprintf(stderr,"usage: %s [--summary | --machine] <car data file>\n",argv[0]);
+  fprintf(stderr,"       %s [--summary | --machine] --binary <trace file>\n",argv[0]);
+  fprintf(stderr,"       %s [--summary | --machine] --stream <car data file sorted by time>\n",argv[0]);
+  fprintf(stderr,"       %s --convert <car data file> <trace file>\n",argv[0]);
+  fprintf(stderr,"       %s [--summary | --machine] --network <network file> <entries file>\n",argv[0]);
+  fprintf(stderr,"       %s [--summary | --machine] [--threads <count>] --batch <directory | manifest>\n",argv[0]);
+  fprintf(stderr,"       %s [generator options] --generate <car data file>\n",argv[0]);
+  fprintf(stderr,"       %s [--machine] [--threads <count>] [generator options] --replicates <count>\n",argv[0]);
+  fprintf(stderr,"  --summary  print only the average and max wait times\n");
+  fprintf(stderr,"  --machine  print only a one line JSON summary\n");
+  fprintf(stderr,"  --approaches <letters>  approaches of the junction going clockwise, NESW by default\n");
+  fprintf(stderr,"  --priority <letters>    the approaches from the highest right-of-way to the lowest\n");
+  fprintf(stderr,"  --rank-only             cars arriving together go by priority only, not by the car on the right\n");
+  fprintf(stderr,"  --concurrent            cars whose movements do not cross or merge are in the intersection together\n");
+  fprintf(stderr,"  --percentiles           print the p50, p90, p99 and p99.9 waits of each approach, turn and all cars\n");
+  fprintf(stderr,"  --window <seconds>      print the cars arriving and leaving each approach in every window of that length as it closes\n");
+  fprintf(stderr,"  --stats                 print counts of the hot paths and the time of each phase on stderr at exit\n");
+  fprintf(stderr,"  --checkpoint <file>     save the state of a car data file, --binary or --stream run to a file now and then\n");
+  fprintf(stderr,"  --checkpoint-every <cars>  cars between checkpoints, %d by default\n",CHECKPOINT_DEFAULT_EVERY);
+  fprintf(stderr,"  --resume <file>         carry on a run from its checkpoint, printing only the output after it\n");
+  fprintf(stderr,"  --incremental <file>    with --stream, simulate only the cars added to the file since the state saved in <file>\n");
+  fprintf(stderr,"  --final                 with --incremental, the file is complete: send the last cars through\n");
+  fprintf(stderr,"generator options:\n");
+  fprintf(stderr,"  --rates <r1,r2,...>     cars an hour of each approach, 600 by default\n");
+  fprintf(stderr,"  --profile <f0,...,f23>  factor of the rates for each hour of the day, 1 by default\n");
+  fprintf(stderr,"  --turns <F,R,L>         weights of the turns, 0.6,0.25,0.15 by default\n");
+  fprintf(stderr,"  --duration <seconds>    length of each run, 3600 by default\n");
+  fprintf(stderr,"  --seed <number>         seed of the random numbers, 1 by default\n");
+  return 1;
+}
+
+/**Function to print a car the way the data file information and sorted list show it, the same as printChar.
+ *@param output where the line goes
+ *@param car the car to print
+ **/
+static void writeCar(OutputBuffer *output, Data *car)
+{
+  writeChar(output,car->travelDirection);
+  writeChar(output,' ');
+  writeChar(output,car->turnDirection);
+  writeChar(output,' ');
+  writeTime(output,car->timeOfArrival,0,6);
+  writeText(output," \n");
+}
 
-  List *list = initializeList(printChar,&free,compareDataFunction,compareTimeFunction);  //a List used to store the input car data
+List *readCarFile(const char *fileName, IntersectionConfig *config, Arena *arena, OutputBuffer *echo)
+{
+  Data car;              //car read from the input file
+  CarReader *reader;     //reader over the input data file containing car data
+  Data **cars = NULL;    //every car read from the file, in file order
+  size_t carCount = 0;   //number of cars read
+  size_t carCapacity = 0;//number of cars that fit in cars
+  int failed = 0;        //1 when memory ran out
 
   //open the input data file
-  fp = fopen(argv[1], "r");
+  reader = openCarReader(fileName);
+  if(reader == NULL)
+  {
+    fprintf(stderr,"could not open %s\n",fileName);
+    return NULL;
+  }
+  setCarDirections(reader,config->directions);
+
+  List *list = initializeListWithAllocator(printChar,NULL,compareDataFunction,compareTimeFunction,arenaAllocator(arena));  //a List used to store the input car data
+  if(list == NULL)
+  {
+    fprintf(stderr,"not enough memory to read %s\n",fileName);
+    closeCarReader(reader);
+    return NULL;
+  }
+
+  PhaseTimer timer;
+  START_PHASE(timer);
+  writeText(echo,"Data File Information \n");
+  //read in the input data file, the cars are sorted into the list all at once after the whole file is read
+  while(readCar(reader, &car))
+  {
+    COUNT(allocations,1);
+    COUNT(bytes,sizeof(Data));
+    Data *newData =arenaAllocate(arena,sizeof(Data)*1);
+    if(newData == NULL)
+    {
+      failed = 1;
+      break;
+    }
+    *newData = car;
+    if(carCount == carCapacity)
+    {
+      size_t newCapacity = (carCapacity == 0) ? 1024 : carCapacity*2;
+      Data **newCars = realloc(cars,sizeof(Data *)*newCapacity);
+      if(newCars == NULL)
+      {
+        failed = 1;
+        break;
+      }
+      cars = newCars;
+      carCapacity = newCapacity;
+    }
+    cars[carCount++] = newData;
+    if(echo != NULL)
+    {
+      writeCar(echo,&car);
+    }
+  }
+  closeCarReader(reader); //close the data file
+  END_PHASE(PHASE_READ,timer);
+  if(failed)
+  {
+    fprintf(stderr,"not enough memory to read %s\n",fileName);
+    free(cars);
+    deleteList(list);
+    return NULL;
+  }
 
-  printf("Data File Information \n");
-  //read in the input data file and store the car data into a list (sorted by arrival time)
-  while(fscanf(fp, "%c %c %f \n", &travelDirection, &turnDirection, &timeOfArrival)!=EOF)
+  //store the car data into a list (sorted by arrival time), the times are whole numbers so they are radix sorted
+  START_PHASE(timer);
+  failed = (carCount != 0 && insertSortedByTime(list, cars, carCount) != EXIT_SUCCESS);
+  END_PHASE(PHASE_SORT,timer);
+  free(cars);
+  if(failed)
   {
-    Data *newData =malloc(sizeof(Data)*1);
-    newData->travelDirection = travelDirection;
-    newData->turnDirection = turnDirection;
-    newData->timeOfArrival = timeOfArrival;
-    insertSorted(list, newData);
-    printf("%c %c %f \n",travelDirection,turnDirection,timeOfArrival);
+    fprintf(stderr,"not enough memory to sort %s\n",fileName);
+    deleteList(list);
+    return NULL;
   }
-  fclose(fp); //close the data file
+  return list;
+}
 
-  printf("\nSorted List \n");
-  printForward(list);
-  printf("\n");
+int simulateCarFile(const char *fileName, IntersectionConfig *config, OutputBuffer *output, int mode, IntersectionStats *stats)
+{
+  Arena *arena = initializeArena(0);  //holds every car and list node, so they are all freed together at the end
+  List *list = readCarFile(fileName,config,arena,(mode == OUTPUT_CARS) ? output : NULL);
+  PhaseTimer timer;
+  if(list == NULL)
+  {
+    deleteArena(arena);
+    return 1;
+  }
 
-  calculateTime(list);
+  if(mode == OUTPUT_CARS)
+  {
+    writeText(output,"\nSorted List \n");
+    for(Node *tempNode = list->head; tempNode != NULL; tempNode = tempNode->next)
+    {
+      writeCar(output,(Data *)tempNode->data);
+    }
+    writeText(output,"\n");
+  }
+
+  START_PHASE(timer);
+  simulateList(list,config,output,mode,stats);
+  END_PHASE(PHASE_SIMULATE,timer);
+  deleteList(list);
+  deleteArena(arena);
   return 0;
 }
+
+int runCarFile(const char *fileName, IntersectionConfig *config, int mode)
+{
+  OutputBuffer *output = initializeOutput(stdout,0);  //everything printed goes through one large buffer
+  if(config->resume != NULL)
+  {
+    discardOutput(output,1);
+  }
+  int result = simulateCarFile(fileName,config,output,mode,NULL);
+  deleteOutput(output);
+  return result;
+}
+
+int simulateTraceFile(const char *fileName, IntersectionConfig *config, OutputBuffer *output, int mode, IntersectionStats *stats)
+{
+  Trace *trace = openTrace(fileName);
+  if(trace == NULL)
+  {
+    fprintf(stderr,"could not read trace %s\n",fileName);
+    return 1;
+  }
+
+  PhaseTimer timer;
+  START_PHASE(timer);
+  simulateTrace(trace,config,compareTimeFunction,output,mode,stats);
+  END_PHASE(PHASE_SIMULATE,timer);
+  closeTrace(trace);
+  return 0;
+}
+
+int runTraceFile(const char *fileName, IntersectionConfig *config, int mode)
+{
+  OutputBuffer *output = initializeOutput(stdout,0);
+  if(config->resume != NULL)
+  {
+    discardOutput(output,1);
+  }
+  int result = simulateTraceFile(fileName,config,output,mode,NULL);
+  deleteOutput(output);
+  return result;
+}
+
+int runStreamFile(const char *fileName, IntersectionConfig *config, int mode)
+{
+  CarReader *reader = openCarReader(fileName);
+  if(reader == NULL)
+  {
+    fprintf(stderr,"could not open %s\n",fileName);
+    return 1;
+  }
+  setCarDirections(reader,config->directions);
+
+  //reading and simulating are interleaved while streaming, so both count as simulating
+  PhaseTimer timer;
+  OutputBuffer *output = initializeOutput(stdout,0);
+  if(config->resume != NULL)
+  {
+    discardOutput(output,1);
+  }
+  START_PHASE(timer);
+  simulateStream(reader,config,compareTimeFunction,output,mode,NULL);
+  END_PHASE(PHASE_SIMULATE,timer);
+  deleteOutput(output);
+  closeCarReader(reader);
+  return 0;
+}
+
+int runIncrementalFile(const char *fileName, IntersectionConfig *config, int mode, const char *stateFile, int final)
+{
+  CarReader *reader = openCarReader(fileName);
+  if(reader == NULL)
+  {
+    fprintf(stderr,"could not open %s\n",fileName);
+    return 1;
+  }
+  setCarDirections(reader,config->directions);
+
+  PhaseTimer timer;
+  OutputBuffer *output = initializeOutput(stdout,0);
+  START_PHASE(timer);
+  int result = refreshStream(reader,config,compareTimeFunction,output,mode,stateFile,final);
+  END_PHASE(PHASE_SIMULATE,timer);
+  deleteOutput(output);
+  closeCarReader(reader);
+  return (result == EXIT_SUCCESS) ? 0 : 1;
+}
+
+int convertCarFile(const char *carFileName, const char *traceFileName, IntersectionConfig *config)
+{
+  Arena *arena = initializeArena(0);
+  List *list = readCarFile(carFileName,config,arena,NULL);
+  int result = 0;
+  if(list == NULL)
+  {
+    deleteArena(arena);
+    return 1;
+  }
+
+  if(writeTrace(traceFileName,list) != EXIT_SUCCESS)
+  {
+    fprintf(stderr,"could not write trace %s\n",traceFileName);
+    result = 1;
+  }
+  deleteList(list);
+  deleteArena(arena);
+  return result;
+}
+
 void printChar(void *toBePrinted)
 {
   Data* newdata1 = toBePrinted;
-  printf("%c %c %f \n", newdata1->travelDirection, newdata1->turnDirection, newdata1->timeOfArrival);
+  printf("%c %c %f \n", newdata1->travelDirection, newdata1->turnDirection, secondsOf(newdata1->timeOfArrival));
 }
 
 
@@ -48,8 +584,8 @@ int compareTimeFunction(void *firstData, void *secondData)
   Data* newdata1 = firstData;
   Data* newdata2 = secondData;
 
-  float first =  newdata1->timeOfArrival;
-  float second =  newdata2->timeOfArrival;
+  SimTime first =  newdata1->timeOfArrival;
+  SimTime second =  newdata2->timeOfArrival;
 
   //printf("\n Comparing %f and %f",first,second);
   if(first==second)
@@ -85,3 +621,79 @@ int compareDataFunction(void *firstData,void *secondData)
   }
 }
 
+int runNetworkFile(const char *networkFileName, const char *entriesFileName, IntersectionConfig *config, int mode)
+{
+  Network *network = readNetwork(networkFileName,config);
+  if(network == NULL)
+  {
+    fprintf(stderr,"could not read network %s\n",networkFileName);
+    return 1;
+  }
+  NetworkEntries *entries = readNetworkEntries(entriesFileName,network);
+  if(entries == NULL)
+  {
+    fprintf(stderr,"could not read entries %s\n",entriesFileName);
+    deleteNetwork(network);
+    return 1;
+  }
+
+  PhaseTimer timer;
+  OutputBuffer *output = initializeOutput(stdout,0);
+  START_PHASE(timer);
+  simulateNetwork(network,entries,compareTimeFunction,output,mode,NULL);
+  END_PHASE(PHASE_SIMULATE,timer);
+  deleteOutput(output);
+  deleteNetworkEntries(entries);
+  deleteNetwork(network);
+  return 0;
+}
+
+int runBatchPath(const char *path, IntersectionConfig *config, int threadCount, int mode)
+{
+  Batch *batch = readBatch(path,config,mode);
+  if(batch == NULL)
+  {
+    fprintf(stderr,"could not read the batch %s\n",path);
+    return 1;
+  }
+
+  OutputBuffer *output = initializeOutput(stdout,0);
+  size_t failed = runBatch(batch,threadCount,output);
+  deleteOutput(output);
+  deleteBatch(batch);
+  return (failed == 0) ? 0 : 1;
+}
+
+int generateCarFile(const char *fileName, const GeneratorConfig *settings, IntersectionConfig *config)
+{
+  if(writeGeneratedCars(fileName,settings,config,0) != EXIT_SUCCESS)
+  {
+    fprintf(stderr,"could not write %s\n",fileName);
+    return 1;
+  }
+  return 0;
+}
+
+int runMonteCarlo(const GeneratorConfig *settings, IntersectionConfig *config, size_t replicates, int threadCount, int mode)
+{
+  WaitHistograms *pooled = config->percentiles ? initializeWaitHistograms() : NULL;
+  if(config->percentiles && pooled == NULL)
+  {
+    fprintf(stderr,"could not run the replicates\n");
+    return 1;
+  }
+  IntersectionStats *runs = runReplicates(settings,config,replicates,threadCount,pooled);
+  if(runs == NULL)
+  {
+    fprintf(stderr,"could not run the replicates\n");
+    deleteWaitHistograms(pooled);
+    return 1;
+  }
+
+  OutputBuffer *output = initializeOutput(stdout,0);
+  printReplicates(output,mode,config,runs,replicates,pooled);
+  deleteOutput(output);
+  free(runs);
+  deleteWaitHistograms(pooled);
+  return 0;
+}